@@ -0,0 +1,267 @@
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#define ALLOCATION_COUNTER_IAT 1
+#elif defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#include <dlfcn.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define ALLOCATION_COUNTER_GOT 1
+#endif
+
+namespace {
+    std::atomic<quint64> allocations{ 0 };
+    bool running = false;
+
+    using MallocFunction = void* (*)(size_t);
+    using CallocFunction = void* (*)(size_t, size_t);
+    using ReallocFunction = void* (*)(void*, size_t);
+    MallocFunction realMalloc = nullptr;
+    CallocFunction realCalloc = nullptr;
+    ReallocFunction realRealloc = nullptr;
+
+    void* countingMalloc(size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return realMalloc(size);
+    }
+
+    void* countingCalloc(size_t count, size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return realCalloc(count, size);
+    }
+
+    void* countingRealloc(void* p, size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return realRealloc(p, size);
+    }
+
+    struct Hook {
+        const char* name;
+        void* replacement;
+        void** original;
+    };
+
+    Hook hooks[] = {
+        { "malloc", reinterpret_cast<void*>(&countingMalloc), reinterpret_cast<void**>(&realMalloc) },
+        { "calloc", reinterpret_cast<void*>(&countingCalloc), reinterpret_cast<void**>(&realCalloc) },
+        { "realloc", reinterpret_cast<void*>(&countingRealloc), reinterpret_cast<void**>(&realRealloc) },
+    };
+
+    struct PatchedSlot {
+        void** slot;
+        void* original;
+        bool readOnly;     // ELF: inside PT_GNU_RELRO, protected again after writing
+    };
+    std::vector<PatchedSlot> patched;
+
+    void writeSlot(void** slot, void* value, bool readOnly) {
+#if defined(ALLOCATION_COUNTER_IAT)
+        Q_UNUSED(readOnly);
+        DWORD protection = 0;
+        if (!VirtualProtect(slot, sizeof(void*), PAGE_READWRITE, &protection))
+            return;
+        *slot = value;
+        VirtualProtect(slot, sizeof(void*), protection, &protection);
+#elif defined(ALLOCATION_COUNTER_GOT)
+        const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(slot) & ~(pageSize - 1));
+        if (mprotect(page, pageSize, PROT_READ | PROT_WRITE) != 0)
+            return;
+        *slot = value;
+        if (readOnly)
+            mprotect(page, pageSize, PROT_READ);
+#else
+        Q_UNUSED(slot);
+        Q_UNUSED(value);
+        Q_UNUSED(readOnly);
+#endif
+    }
+
+    void hookSlot(void** slot, const char* name, bool readOnly) {
+        for (Hook& hook : hooks) {
+            if (std::strcmp(name, hook.name) != 0)
+                continue;
+            if (*slot == hook.replacement)
+                return;
+#if defined(ALLOCATION_COUNTER_IAT)
+            // A module bound to a different CRT (debug vs release) has its own heap: leave it alone
+            if (!*hook.original)
+                *hook.original = *slot;
+            else if (*slot != *hook.original)
+                return;
+#endif
+            patched.push_back({ slot, *slot, readOnly });
+            writeSlot(slot, hook.replacement, readOnly);
+            return;
+        }
+    }
+
+#if defined(ALLOCATION_COUNTER_IAT)
+    bool isCrtHeapImport(const char* dll) {
+        return _strnicmp(dll, "api-ms-win-crt-heap-", 20) == 0
+            || _stricmp(dll, "ucrtbase.dll") == 0
+            || _stricmp(dll, "ucrtbased.dll") == 0;
+    }
+
+    void hookModule(HMODULE module) {
+        BYTE* base = reinterpret_cast<BYTE*>(module);
+        auto dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+        if (dos->e_magic != IMAGE_DOS_SIGNATURE)
+            return;
+        auto nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dos->e_lfanew);
+        const IMAGE_DATA_DIRECTORY& directory = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+        if (directory.VirtualAddress == 0)
+            return;
+
+        for (auto import = reinterpret_cast<const IMAGE_IMPORT_DESCRIPTOR*>(base + directory.VirtualAddress);
+            import->Name != 0; ++import) {
+            if (import->OriginalFirstThunk == 0 || !isCrtHeapImport(reinterpret_cast<const char*>(base + import->Name)))
+                continue;
+            auto names = reinterpret_cast<const IMAGE_THUNK_DATA*>(base + import->OriginalFirstThunk);
+            auto thunks = reinterpret_cast<IMAGE_THUNK_DATA*>(base + import->FirstThunk);
+            for (; names->u1.AddressOfData != 0; ++names, ++thunks) {
+                if (IMAGE_SNAP_BY_ORDINAL(names->u1.Ordinal))
+                    continue;
+                auto byName = reinterpret_cast<const IMAGE_IMPORT_BY_NAME*>(base + names->u1.AddressOfData);
+                hookSlot(reinterpret_cast<void**>(&thunks->u1.Function), reinterpret_cast<const char*>(byName->Name), false);
+            }
+        }
+    }
+
+    bool hookProcess() {
+        HMODULE modules[1024];
+        DWORD needed = 0;
+        if (!EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &needed))
+            return false;
+        const DWORD count = std::min<DWORD>(needed / sizeof(HMODULE), static_cast<DWORD>(std::size(modules)));
+        for (DWORD i = 0; i < count; ++i) {
+            hookModule(modules[i]);
+        }
+        return true;
+    }
+#elif defined(ALLOCATION_COUNTER_GOT)
+    int hookObject(dl_phdr_info* info, size_t, void*) {
+        // The dynamic loader and the vDSO have nothing worth counting
+        if (std::strstr(info->dlpi_name, "/ld-") || std::strstr(info->dlpi_name, "linux-vdso"))
+            return 0;
+
+        const ElfW(Dyn)* dynamic = nullptr;
+        ElfW(Addr) relroStart = 0;
+        ElfW(Addr) relroEnd = 0;
+        for (int i = 0; i < info->dlpi_phnum; ++i) {
+            const ElfW(Phdr)& header = info->dlpi_phdr[i];
+            if (header.p_type == PT_DYNAMIC)
+                dynamic = reinterpret_cast<const ElfW(Dyn)*>(info->dlpi_addr + header.p_vaddr);
+            else if (header.p_type == PT_GNU_RELRO) {
+                relroStart = info->dlpi_addr + header.p_vaddr;
+                relroEnd = relroStart + header.p_memsz;
+            }
+        }
+        if (!dynamic)
+            return 0;
+
+        // glibc relocates these entries in place; other loaders leave them as offsets
+        auto address = [info](ElfW(Addr) pointer) {
+            return pointer < info->dlpi_addr ? pointer + info->dlpi_addr : pointer;
+        };
+        const ElfW(Sym)* symbols = nullptr;
+        const char* strings = nullptr;
+        const ElfW(Rela)* tables[2] = { nullptr, nullptr };
+        size_t tableBytes[2] = { 0, 0 };
+        for (const ElfW(Dyn)* entry = dynamic; entry->d_tag != DT_NULL; ++entry) {
+            switch (entry->d_tag) {
+            case DT_SYMTAB: symbols = reinterpret_cast<const ElfW(Sym)*>(address(entry->d_un.d_ptr)); break;
+            case DT_STRTAB: strings = reinterpret_cast<const char*>(address(entry->d_un.d_ptr)); break;
+            case DT_JMPREL: tables[0] = reinterpret_cast<const ElfW(Rela)*>(address(entry->d_un.d_ptr)); break;
+            case DT_PLTRELSZ: tableBytes[0] = entry->d_un.d_val; break;
+            case DT_RELA: tables[1] = reinterpret_cast<const ElfW(Rela)*>(address(entry->d_un.d_ptr)); break;
+            case DT_RELASZ: tableBytes[1] = entry->d_un.d_val; break;
+            default: break;
+            }
+        }
+        if (!symbols || !strings)
+            return 0;
+
+        // PLT slots and, for -fno-plt code, GOT slots bound by GLOB_DAT
+        for (int t = 0; t < 2; ++t) {
+            if (!tables[t])
+                continue;
+            const size_t count = tableBytes[t] / sizeof(ElfW(Rela));
+            for (size_t i = 0; i < count; ++i) {
+                const ElfW(Rela)& relocation = tables[t][i];
+                const auto type = ELF64_R_TYPE(relocation.r_info);
+#if defined(__x86_64__)
+                if (type != R_X86_64_JUMP_SLOT && type != R_X86_64_GLOB_DAT)
+                    continue;
+#else
+                if (type != R_AARCH64_JUMP_SLOT && type != R_AARCH64_GLOB_DAT)
+                    continue;
+#endif
+                const ElfW(Addr) slot = info->dlpi_addr + relocation.r_offset;
+                const char* name = strings + symbols[ELF64_R_SYM(relocation.r_info)].st_name;
+                hookSlot(reinterpret_cast<void**>(slot), name, slot >= relroStart && slot < relroEnd);
+            }
+        }
+        return 0;
+    }
+
+    bool hookProcess() {
+        // Lazily bound slots still point at PLT stubs, so the real functions come from the loader
+        realMalloc = reinterpret_cast<MallocFunction>(dlsym(RTLD_NEXT, "malloc"));
+        realCalloc = reinterpret_cast<CallocFunction>(dlsym(RTLD_NEXT, "calloc"));
+        realRealloc = reinterpret_cast<ReallocFunction>(dlsym(RTLD_NEXT, "realloc"));
+        if (!realMalloc || !realCalloc || !realRealloc)
+            return false;
+        dl_iterate_phdr(hookObject, nullptr);
+        return true;
+    }
+#endif
+}
+
+bool AllocationCounter::isSupported() {
+#if defined(ALLOCATION_COUNTER_IAT) || defined(ALLOCATION_COUNTER_GOT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AllocationCounter::start() {
+#if defined(ALLOCATION_COUNTER_IAT) || defined(ALLOCATION_COUNTER_GOT)
+    if (running)
+        return true;
+    patched.reserve(512);
+    if (!hookProcess()) {
+        stop();
+        return false;
+    }
+    running = true;
+    allocations.store(0, std::memory_order_relaxed);
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 AllocationCounter::stop() {
+    const quint64 counted = allocations.load(std::memory_order_relaxed);
+    for (auto it = patched.rbegin(); it != patched.rend(); ++it) {
+        writeSlot(it->slot, it->original, it->readOnly);
+    }
+    patched.clear();
+    running = false;
+    return counted;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QtGlobal>
+
+// Counts heap allocations made anywhere in the process - including inside
+// Qt's own libraries - between start() and stop(), for the benchmark's
+// allocations-per-tick figure.
+//
+// Nothing is hooked outside that window, so the other modes pay nothing.
+// start() rewrites the malloc/calloc/realloc import slots of every loaded
+// module (the IAT on Windows, the GOT on ELF platforms) to point at counting
+// wrappers that forward to the real allocator; stop() writes the original
+// pointers back. Replacing operator new would miss Qt6Core.dll's allocations
+// on Windows, where each DLL links its own operator new against the CRT.
+//
+// Modules loaded while the counter runs are not hooked. Where no hook is
+// available (macOS) start() returns false and the count stays 0.
+namespace AllocationCounter {
+    bool isSupported();
+
+    // Hooks the allocator; false if this platform has no hook
+    bool start();
+    // Unhooks and returns the allocations counted since start()
+    quint64 stop();
+}
@@ -0,0 +1,624 @@
+#include "Backtester.h"
+#include "Indicators.h"
+#include "TickDatabase.h"
+#include "TickJournal.h"
+#include "TickStore.h"
+#include "WorkStealingPool.h"
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+// ---- ReplayData ----
+
+int ReplayData::symbolId(const QString& symbol) {
+    int id = symbols.indexOf(symbol);
+    if (id >= 0) return id;
+    symbols.append(symbol);
+    return static_cast<int>(symbols.size()) - 1;
+}
+
+void ReplayData::finalize() {
+    auto earlier = [](const Event& a, const Event& b) { return a.tick.timestamp < b.tick.timestamp; };
+    if (!std::is_sorted(events.begin(), events.end(), earlier))
+        std::stable_sort(events.begin(), events.end(), earlier);
+}
+
+void ReplayData::clear() {
+    events.clear();
+    symbols.clear();
+}
+
+bool ReplayData::loadJournal(const QString& path, ReplayData& out, const QStringList& symbolFilter,
+    qint64 fromMs, qint64 toMs, QString* error) {
+    QSet<QString> wanted(symbolFilter.begin(), symbolFilter.end());
+    QHash<QString, int> ids;
+
+    bool ok = TickJournal::replay(path, [&](const QString& symbol, const TickRecord& tick) {
+        if (toMs > 0 && tick.timestamp >= toMs) return;
+        if (!wanted.isEmpty() && !wanted.contains(symbol)) return;
+
+        auto it = ids.constFind(symbol);
+        int id = it != ids.constEnd() ? it.value() : ids.insert(symbol, out.symbolId(symbol)).value();
+        out.append(id, tick);
+    }, fromMs);
+
+    if (!ok) {
+        if (error) *error = QString("Cannot read tick journal: %1").arg(path);
+        return false;
+    }
+    out.finalize();
+    return true;
+}
+
+bool ReplayData::loadDatabase(const QString& directory, ReplayData& out, const QStringList& symbolFilter,
+    qint64 fromMs, qint64 toMs, QString* error, WorkStealingPool* pool) {
+    TickDatabase database(directory, true);
+    if (!database.open(error))
+        return false;
+
+    std::vector<TickRecord> ticks;
+    for (const QString& symbol : database.symbols()) {
+        if (!symbolFilter.isEmpty() && !symbolFilter.contains(symbol)) continue;
+
+        ticks.clear();
+        if (!database.query(symbol, fromMs, toMs, ticks, pool)) {
+            if (error) *error = QString("Cannot read %1 from tick database %2").arg(symbol, directory);
+            return false;
+        }
+        int id = out.symbolId(symbol);
+        out.reserve(out.size() + ticks.size());
+        for (const TickRecord& tick : ticks) {
+            out.append(id, tick);
+        }
+    }
+    out.finalize();
+    return true;
+}
+
+ReplayData ReplayData::fromTickStore(const TickStore& store) {
+    ReplayData data;
+    size_t total = 0;
+    for (int id = 0; id < store.symbolCount(); ++id) {
+        data.symbolId(store.symbolName(id));
+        total += store.buffer(id).size();
+    }
+
+    data.reserve(total);
+    for (int id = 0; id < store.symbolCount(); ++id) {
+        const TickBuffer& buffer = store.buffer(id);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            data.append(id, buffer.at(i));
+        }
+    }
+    data.finalize();
+    return data;
+}
+
+// ---- Parameters ----
+
+void ParameterSet::set(const QString& name, double value) {
+    for (auto& entry : values) {
+        if (entry.first == name) {
+            entry.second = value;
+            return;
+        }
+    }
+    values.emplace_back(name, value);
+}
+
+double ParameterSet::value(const QString& name, double fallback) const {
+    for (const auto& entry : values) {
+        if (entry.first == name) return entry.second;
+    }
+    return fallback;
+}
+
+bool ParameterSet::contains(const QString& name) const {
+    for (const auto& entry : values) {
+        if (entry.first == name) return true;
+    }
+    return false;
+}
+
+QString ParameterSet::toString() const {
+    QStringList parts;
+    for (const auto& entry : values) {
+        parts.append(QString("%1=%2").arg(entry.first).arg(entry.second));
+    }
+    return parts.join(' ');
+}
+
+void ParameterGrid::add(const QString& name, const std::vector<double>& values) {
+    if (values.empty()) return;
+    for (auto& axis : axes) {
+        if (axis.first == name) {
+            axis.second = values;
+            return;
+        }
+    }
+    axes.emplace_back(name, values);
+}
+
+bool ParameterGrid::addSpec(const QString& spec, QString* error) {
+    int equals = spec.indexOf('=');
+    QString name = spec.left(equals).trimmed();
+    QString list = spec.mid(equals + 1).trimmed();
+    if (equals <= 0 || list.isEmpty()) {
+        if (error) *error = QString("Bad parameter '%1', expected name=v1,v2 or name=start:stop:step").arg(spec);
+        return false;
+    }
+
+    std::vector<double> values;
+    QStringList range = list.split(':');
+    if (range.size() == 3) {
+        bool okStart = false, okStop = false, okStep = false;
+        double start = range[0].toDouble(&okStart);
+        double stop = range[1].toDouble(&okStop);
+        double step = range[2].toDouble(&okStep);
+        if (!okStart || !okStop || !okStep || step <= 0.0 || (stop - start) / step > 100000) {
+            if (error) *error = QString("Bad range in parameter '%1'").arg(spec);
+            return false;
+        }
+        // Half a step of tolerance so 0.1 steps still reach 'stop'
+        for (double v = start; v <= stop + step * 0.5; v += step) {
+            values.push_back(v);
+        }
+    }
+    else {
+        for (const QString& item : list.split(',', Qt::SkipEmptyParts)) {
+            bool ok = false;
+            double v = item.trimmed().toDouble(&ok);
+            if (!ok) {
+                if (error) *error = QString("Bad value '%1' in parameter '%2'").arg(item, name);
+                return false;
+            }
+            values.push_back(v);
+        }
+    }
+
+    if (values.empty()) {
+        if (error) *error = QString("Parameter '%1' has no values").arg(name);
+        return false;
+    }
+    add(name, values);
+    return true;
+}
+
+size_t ParameterGrid::size() const {
+    size_t n = 1;
+    for (const auto& axis : axes) {
+        n *= axis.second.size();
+    }
+    return n;
+}
+
+ParameterSet ParameterGrid::at(size_t index) const {
+    // Mixed radix, last axis varying fastest
+    ParameterSet set;
+    std::vector<size_t> digits(axes.size());
+    for (size_t a = axes.size(); a-- > 0;) {
+        digits[a] = index % axes[a].second.size();
+        index /= axes[a].second.size();
+    }
+    for (size_t a = 0; a < axes.size(); ++a) {
+        set.set(axes[a].first, axes[a].second[digits[a]]);
+    }
+    return set;
+}
+
+FillModel FillModel::withOverrides(const ParameterSet& parameters) const {
+    FillModel model = *this;
+    model.latencyMs = static_cast<qint64>(parameters.value("latency_ms", static_cast<double>(latencyMs)));
+    model.feeBps = parameters.value("fee_bps", feeBps);
+    model.slippageBps = parameters.value("slippage_bps", slippageBps);
+    return model;
+}
+
+// ---- BacktestContext ----
+
+BacktestContext::BacktestContext(const ReplayData& data, const FillModel& model)
+    : data(data),
+    model(model),
+    symbols(data.symbolCount()),
+    cash(0.0),
+    markedValue(0.0),
+    peakEquity(0.0),
+    currentTime(0),
+    eventIndex(0),
+    nextOrderId(1),
+    delaySum(0.0),
+    winningTrips(0),
+    nextSample(0),
+    sampledEquity(0.0),
+    samples(0),
+    sampleMean(0.0),
+    sampleM2(0.0),
+    strategy(nullptr) {
+}
+
+int BacktestContext::submit(int symbolId, double quantity, double limitPrice) {
+    if (symbolId < 0 || symbolId >= symbolCount() || quantity == 0.0 || !std::isfinite(quantity))
+        return 0;
+
+    const TickRecord& last = symbols[symbolId].last;
+    Order order;
+    order.id = nextOrderId++;
+    order.symbolId = symbolId;
+    order.quantity = quantity;
+    order.limitPrice = limitPrice;
+    order.submitTime = currentTime;
+    order.activeTime = currentTime + model.latencyMs;
+    order.submitEvent = eventIndex;
+    order.decisionPrice = last.bid > 0.0 && last.ask > 0.0 ? (last.bid + last.ask) * 0.5 : last.price;
+    order.resting = false;
+
+    symbols[symbolId].openOrders.push_back(order);
+    ++result.orders;
+    return order.id;
+}
+
+int BacktestContext::submitLimit(int symbolId, double quantity, double limitPrice) {
+    if (!(limitPrice > 0.0)) return 0;
+    return submit(symbolId, quantity, limitPrice);
+}
+
+bool BacktestContext::cancel(int orderId) {
+    for (SymbolState& state : symbols) {
+        for (size_t i = 0; i < state.openOrders.size(); ++i) {
+            if (state.openOrders[i].id == orderId) {
+                state.openOrders.erase(state.openOrders.begin() + i);
+                ++result.cancelled;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void BacktestContext::cancelAll(int symbolId) {
+    if (symbolId < 0 || symbolId >= symbolCount()) return;
+    result.cancelled += symbols[symbolId].openOrders.size();
+    symbols[symbolId].openOrders.clear();
+}
+
+double BacktestContext::position(int symbolId) const {
+    if (symbolId < 0 || symbolId >= symbolCount()) return 0.0;
+    return symbols[symbolId].position;
+}
+
+size_t BacktestContext::openOrderCount(int symbolId) const {
+    if (symbolId < 0 || symbolId >= symbolCount()) return 0;
+    return symbols[symbolId].openOrders.size();
+}
+
+void BacktestContext::onEvent(const ReplayData::Event& event) {
+    SymbolState& state = symbols[event.symbolId];
+    const TickRecord& tick = event.tick;
+    currentTime = tick.timestamp;
+
+    // A position only exists after a fill, which needs a previous tick of this symbol
+    markedValue += state.position * (tick.price - state.last.price);
+    state.last = tick;
+
+    if (!state.openOrders.empty())
+        matchOrders(event.symbolId, state, tick);
+
+    double equityNow = equity();
+    peakEquity = std::max(peakEquity, equityNow);
+    result.maxDrawdown = std::max(result.maxDrawdown, peakEquity - equityNow);
+    sampleEquity(tick.timestamp);
+
+    strategy->onTick(*this, event.symbolId, tick);
+}
+
+void BacktestContext::matchOrders(int symbolId, SymbolState& state, const TickRecord& tick) {
+    Q_UNUSED(symbolId);
+    const double slip = model.slippageBps * 1e-4;
+    double buyPrice = tick.ask > 0.0 ? tick.ask : tick.price * (1.0 + slip);
+    double sellPrice = tick.bid > 0.0 ? tick.bid : tick.price * (1.0 - slip);
+
+    pendingFills.clear();
+    size_t kept = 0;
+    for (size_t i = 0; i < state.openOrders.size(); ++i) {
+        Order& order = state.openOrders[i];
+        bool filled = false;
+
+        if (eventIndex > order.submitEvent && tick.timestamp >= order.activeTime) {
+            bool buy = order.quantity > 0.0;
+            double executable = buy ? buyPrice : sellPrice;
+
+            if (order.limitPrice == 0.0) {
+                pendingFills.push_back(applyFill(order, state, executable, false));
+                filled = true;
+            }
+            else if (!order.resting) {
+                // Marketable on arrival: takes liquidity at the better of limit and quote
+                if (buy ? executable <= order.limitPrice : executable >= order.limitPrice) {
+                    pendingFills.push_back(applyFill(order, state, executable, false));
+                    filled = true;
+                }
+                else {
+                    order.resting = true;
+                }
+            }
+            else {
+                bool through = model.limitFillOnTouch
+                    ? (buy ? tick.price <= order.limitPrice : tick.price >= order.limitPrice)
+                    : (buy ? tick.price < order.limitPrice : tick.price > order.limitPrice);
+                if (through) {
+                    pendingFills.push_back(applyFill(order, state, order.limitPrice, true));
+                    filled = true;
+                }
+            }
+        }
+
+        if (!filled) {
+            if (kept != i) state.openOrders[kept] = order;
+            ++kept;
+        }
+    }
+    state.openOrders.resize(kept);
+
+    for (const BacktestFill& fill : pendingFills) {
+        strategy->onFill(*this, fill);
+    }
+}
+
+BacktestFill BacktestContext::applyFill(const Order& order, SymbolState& state, double price, bool passive) {
+    double quantity = order.quantity;
+    double size = std::abs(quantity);
+    double notional = size * price;
+    double fee = notional * model.feeBps * 1e-4;
+
+    cash -= quantity * price + fee;
+    markedValue += quantity * state.last.price;
+
+    // Average-cost realised PnL; a round trip ends when the position returns to
+    // (or crosses) zero
+    double held = state.position;
+    state.tripPnl -= fee;
+    if (held == 0.0 || (held > 0.0) == (quantity > 0.0)) {
+        state.averagePrice = (state.averagePrice * std::abs(held) + price * size) / (std::abs(held) + size);
+        state.position = held + quantity;
+    }
+    else {
+        double closed = std::min(size, std::abs(held));
+        double pnl = closed * (price - state.averagePrice) * (held > 0.0 ? 1.0 : -1.0);
+        result.realizedPnl += pnl;
+        state.tripPnl += pnl;
+        state.position = held + quantity;
+
+        bool flipped = size > std::abs(held);
+        if (flipped || std::abs(state.position) <= 1e-12 * std::max(1.0, size)) {
+            ++result.roundTrips;
+            if (state.tripPnl > 0.0) ++winningTrips;
+            state.tripPnl = 0.0;
+            if (flipped)
+                state.averagePrice = price;   // the remainder opens a new trip
+            else
+                state.position = 0.0;
+        }
+    }
+    result.realizedPnl -= fee;
+    result.fees += fee;
+    result.turnover += notional;
+    ++result.fills;
+
+    if (order.decisionPrice > 0.0) {
+        double shortfall = (quantity > 0.0 ? price - order.decisionPrice : order.decisionPrice - price);
+        shortfalls.push_back(shortfall / order.decisionPrice * 1e4);
+    }
+    delaySum += static_cast<double>(currentTime - order.submitTime);
+
+    BacktestFill fill;
+    fill.orderId = order.id;
+    fill.symbolId = order.symbolId;
+    fill.quantity = quantity;
+    fill.price = price;
+    fill.fee = fee;
+    fill.timestamp = currentTime;
+    fill.passive = passive;
+    return fill;
+}
+
+void BacktestContext::sampleEquity(qint64 timestamp) {
+    if (model.sampleIntervalMs <= 0) return;
+    if (nextSample == 0) {
+        nextSample = timestamp + model.sampleIntervalMs;
+        sampledEquity = equity();
+        return;
+    }
+    if (timestamp < nextSample) return;
+
+    // One sample per interval that saw ticks; empty intervals are skipped
+    double change = equity() - sampledEquity;
+    sampledEquity = equity();
+    ++samples;
+    double delta = change - sampleMean;
+    sampleMean += delta / samples;
+    sampleM2 += delta * (change - sampleMean);
+    nextSample = timestamp - (timestamp - nextSample) % model.sampleIntervalMs + model.sampleIntervalMs;
+}
+
+void BacktestContext::finish(double elapsedSeconds) {
+    result.ticks = data.size();
+    result.pnl = equity();
+    result.elapsedSeconds = elapsedSeconds;
+    result.winRate = result.roundTrips > 0 ? static_cast<double>(winningTrips) / result.roundTrips : 0.0;
+
+    if (samples > 1) {
+        double sd = std::sqrt(sampleM2 / (samples - 1));
+        double periodsPerYear = 365.0 * 86400000.0 / model.sampleIntervalMs;   // crypto trades every day
+        if (sd > 0.0)
+            result.sharpe = sampleMean / sd * std::sqrt(periodsPerYear);
+    }
+
+    if (!shortfalls.empty()) {
+        double sum = 0.0;
+        for (double s : shortfalls) sum += s;
+        result.meanShortfallBps = sum / shortfalls.size();
+        size_t index = static_cast<size_t>(0.95 * (shortfalls.size() - 1));
+        std::nth_element(shortfalls.begin(), shortfalls.begin() + index, shortfalls.end());
+        result.p95ShortfallBps = shortfalls[index];
+    }
+    if (result.fills > 0)
+        result.meanFillDelayMs = delaySum / result.fills;
+}
+
+// ---- Built-in strategies ----
+
+namespace {
+    // Long above the slow EMA, short (or flat) below it, via market orders
+    class EmaCrossStrategy : public Strategy {
+    private:
+        int fastPeriod;
+        int slowPeriod;
+        double size;
+        bool allowShort;
+        std::vector<std::pair<Ema, Ema>> averages;
+
+    public:
+        explicit EmaCrossStrategy(const ParameterSet& p)
+            : fastPeriod(static_cast<int>(p.value("fast", 20))),
+            slowPeriod(static_cast<int>(p.value("slow", 100))),
+            size(p.value("size", 1.0)),
+            allowShort(p.value("short", 1.0) != 0.0) {
+        }
+
+        void onStart(BacktestContext& context) override {
+            averages.assign(context.symbolCount(), { Ema(fastPeriod), Ema(slowPeriod) });
+        }
+
+        void onTick(BacktestContext& context, int symbolId, const TickRecord& tick) override {
+            double fast = averages[symbolId].first.update(tick.price);
+            double slow = averages[symbolId].second.update(tick.price);
+            if (!Indicators::ready(fast) || !Indicators::ready(slow)) return;
+            if (context.openOrderCount(symbolId) > 0) return;
+
+            double target = fast > slow ? size : (allowShort ? -size : 0.0);
+            double position = context.position(symbolId);
+            if (target != position)
+                context.submitMarket(symbolId, target - position);
+        }
+    };
+
+    // Rests limit orders z standard deviations either side of a rolling mean,
+    // then exits with a limit at the mean. Quotes follow the mean once it
+    // drifts by half a standard deviation.
+    class MeanReversionStrategy : public Strategy {
+    private:
+        struct SymbolQuotes {
+            RollingWindow window;
+            bool quoting = false;
+            double quotedMean = 0.0;
+            explicit SymbolQuotes(size_t period) : window(period) {}
+        };
+
+        size_t period;
+        double z;
+        double size;
+        std::vector<SymbolQuotes> quotes;
+
+    public:
+        explicit MeanReversionStrategy(const ParameterSet& p)
+            : period(static_cast<size_t>(std::max(2.0, p.value("window", 200)))),
+            z(p.value("z", 2.0)),
+            size(p.value("size", 1.0)) {
+        }
+
+        void onStart(BacktestContext& context) override {
+            quotes.assign(context.symbolCount(), SymbolQuotes(period));
+        }
+
+        void onTick(BacktestContext& context, int symbolId, const TickRecord& tick) override {
+            SymbolQuotes& q = quotes[symbolId];
+            q.window.push(tick.price);
+            if (!q.window.full()) return;
+
+            double mean = q.window.mean();
+            double sd = std::sqrt(q.window.variance());
+            if (sd <= 0.0) return;
+            if (q.quoting && std::abs(mean - q.quotedMean) < 0.5 * sd) return;
+
+            context.cancelAll(symbolId);
+            double position = context.position(symbolId);
+            if (position == 0.0) {
+                context.submitLimit(symbolId, size, mean - z * sd);
+                context.submitLimit(symbolId, -size, mean + z * sd);
+            }
+            else {
+                context.submitLimit(symbolId, -position, mean);
+            }
+            q.quoting = true;
+            q.quotedMean = mean;
+        }
+
+        void onFill(BacktestContext& context, const BacktestFill& fill) override {
+            // Entry filled: pull the other side; exit filled: start over
+            context.cancelAll(fill.symbolId);
+            quotes[fill.symbolId].quoting = false;
+        }
+    };
+}
+
+// ---- Backtester ----
+
+BacktestResult Backtester::run(const ReplayData& data, Strategy& strategy, const FillModel& model,
+    const ParameterSet& parameters) {
+    auto start = std::chrono::steady_clock::now();
+
+    BacktestContext context(data, model.withOverrides(parameters));
+    context.strategy = &strategy;
+    context.result.parameters = parameters;
+
+    strategy.onStart(context);
+    const std::vector<ReplayData::Event>& events = data.stream();
+    for (size_t i = 0; i < events.size(); ++i) {
+        context.eventIndex = i;
+        context.onEvent(events[i]);
+    }
+    strategy.onFinish(context);
+
+    context.finish(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return context.result;
+}
+
+std::vector<BacktestResult> Backtester::sweep(const ReplayData& data, const StrategyFactory& factory,
+    const ParameterGrid& grid, const FillModel& model, WorkStealingPool& pool, const ProgressCallback& progress) {
+    const size_t total = grid.size();
+    std::vector<BacktestResult> results(total);
+    std::atomic<size_t> done{ 0 };
+
+    // Every run reads the same ReplayData and writes only its own result slot
+    for (size_t i = 0; i < total; ++i) {
+        pool.submit([&, i]() {
+            ParameterSet parameters = grid.at(i);
+            std::unique_ptr<Strategy> strategy = factory(parameters);
+            if (strategy)
+                results[i] = run(data, *strategy, model, parameters);
+            else
+                results[i].parameters = parameters;
+
+            size_t finished = done.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (progress)
+                progress(finished, total);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+Backtester::StrategyFactory Backtester::builtinStrategy(const QString& name) {
+    if (name == "ema-cross")
+        return [](const ParameterSet& p) { return std::make_unique<EmaCrossStrategy>(p); };
+    if (name == "mean-reversion")
+        return [](const ParameterSet& p) { return std::make_unique<MeanReversionStrategy>(p); };
+    return StrategyFactory();
+}
+
+QStringList Backtester::builtinStrategyNames() {
+    return { "ema-cross", "mean-reversion" };
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "MarketTick.h"
+
+class TickStore;
+class WorkStealingPool;
+
+// Time-ordered multi-symbol tick stream shared read-only by every run.
+// Loaded once, then replayed by any number of threads without copying.
+class ReplayData {
+public:
+    struct Event {
+        int symbolId;
+        TickRecord tick;
+    };
+
+private:
+    std::vector<Event> events;
+    QStringList symbols;
+
+public:
+    int symbolId(const QString& symbol);
+    void append(int symbolId, const TickRecord& tick) { events.push_back(Event{ symbolId, tick }); }
+    void reserve(size_t count) { events.reserve(count); }
+    // Stable-sorts by timestamp (journals appended by several runs can interleave)
+    void finalize();
+    void clear();
+
+    const std::vector<Event>& stream() const { return events; }
+    const QStringList& symbolList() const { return symbols; }
+    int symbolCount() const { return static_cast<int>(symbols.size()); }
+    size_t size() const { return events.size(); }
+    bool empty() const { return events.empty(); }
+
+    // Loads a TickJournal, keeping 'symbolFilter' (all if empty) within [fromMs, toMs)
+    static bool loadJournal(const QString& path, ReplayData& out, const QStringList& symbolFilter = {},
+        qint64 fromMs = 0, qint64 toMs = 0, QString* error = nullptr);
+    // Loads symbols from a TickDatabase directory, decoding blocks on 'pool' when given
+    static bool loadDatabase(const QString& directory, ReplayData& out, const QStringList& symbolFilter = {},
+        qint64 fromMs = 0, qint64 toMs = 0, QString* error = nullptr, WorkStealingPool* pool = nullptr);
+    // Snapshot of the records currently held in a TickStore
+    static ReplayData fromTickStore(const TickStore& store);
+};
+
+// Named strategy parameters. Looked up when a strategy is constructed, not per tick.
+class ParameterSet {
+private:
+    std::vector<std::pair<QString, double>> values;
+
+public:
+    void set(const QString& name, double value);
+    double value(const QString& name, double fallback = 0.0) const;
+    bool contains(const QString& name) const;
+    const std::vector<std::pair<QString, double>>& entries() const { return values; }
+    QString toString() const;
+};
+
+// Cartesian product of per-parameter value lists, addressed by a dense index
+class ParameterGrid {
+private:
+    std::vector<std::pair<QString, std::vector<double>>> axes;
+
+public:
+    void add(const QString& name, const std::vector<double>& values);
+    // "name=v1,v2,..." or "name=start:stop:step"
+    bool addSpec(const QString& spec, QString* error = nullptr);
+
+    size_t size() const;
+    ParameterSet at(size_t index) const;
+    bool empty() const { return axes.empty(); }
+};
+
+// How orders turn into fills. Parameters named latency_ms, fee_bps and
+// slippage_bps override these fields per run, so latency can be swept like
+// any strategy parameter.
+struct FillModel {
+    qint64 latencyMs = 0;          // decision tick -> order active at the venue
+    double feeBps = 0.0;           // charged on the notional of every fill
+    double slippageBps = 0.0;      // market orders pay this over the trade price when no quote is known
+    bool limitFillOnTouch = false; // false: a resting limit fills only when a trade prints through it
+    qint64 sampleIntervalMs = 60000; // equity sampling for Sharpe ratio
+
+    FillModel withOverrides(const ParameterSet& parameters) const;
+};
+
+struct BacktestFill {
+    int orderId = 0;
+    int symbolId = -1;
+    double quantity = 0.0;         // signed: > 0 bought, < 0 sold
+    double price = 0.0;
+    double fee = 0.0;
+    qint64 timestamp = 0;
+    bool passive = false;          // resting limit order filled by a later trade
+};
+
+class BacktestContext;
+
+// User strategy. Callbacks arrive in replay time order on a single thread;
+// a sweep gives every parameter set its own instance.
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+    virtual void onStart(BacktestContext& context) { Q_UNUSED(context); }
+    virtual void onTick(BacktestContext& context, int symbolId, const TickRecord& tick) = 0;
+    virtual void onFill(BacktestContext& context, const BacktestFill& fill) { Q_UNUSED(context); Q_UNUSED(fill); }
+    virtual void onFinish(BacktestContext& context) { Q_UNUSED(context); }
+};
+
+// Strategy assembled from callables, for one-off experiments
+class CallbackStrategy : public Strategy {
+public:
+    std::function<void(BacktestContext&, int, const TickRecord&)> tick;
+    std::function<void(BacktestContext&, const BacktestFill&)> fill;
+
+    void onTick(BacktestContext& context, int symbolId, const TickRecord& record) override {
+        if (tick) tick(context, symbolId, record);
+    }
+    void onFill(BacktestContext& context, const BacktestFill& record) override {
+        if (fill) fill(context, record);
+    }
+};
+
+struct BacktestResult {
+    ParameterSet parameters;
+    double pnl = 0.0;              // net of fees, open positions marked at their last trade
+    double realizedPnl = 0.0;      // net of fees
+    double fees = 0.0;
+    double turnover = 0.0;         // traded notional
+    double maxDrawdown = 0.0;
+    double sharpe = 0.0;           // annualised from equity samples
+    double winRate = 0.0;          // share of round trips with positive PnL
+    quint64 ticks = 0;
+    quint64 orders = 0;
+    quint64 fills = 0;
+    quint64 cancelled = 0;
+    quint64 roundTrips = 0;
+
+    // Latency sensitivity: cost of the move between the decision tick and the fill
+    double meanShortfallBps = 0.0;
+    double p95ShortfallBps = 0.0;
+    double meanFillDelayMs = 0.0;
+
+    double elapsedSeconds = 0.0;
+};
+
+// Per-run simulator: order entry, matching and accounting.
+//
+// Orders become active latencyMs after the tick that submitted them and can
+// only fill on a later event, so a strategy never trades on the tick it just
+// saw. Each tick only checks the open orders of its own symbol, and equity is
+// kept current incrementally (position * price change), so a run is O(ticks)
+// plus O(fills).
+class BacktestContext {
+private:
+    struct Order {
+        int id;
+        int symbolId;
+        double quantity;
+        double limitPrice;         // 0 = market
+        qint64 submitTime;
+        qint64 activeTime;
+        size_t submitEvent;
+        double decisionPrice;
+        bool resting;              // limit order that was not marketable on arrival
+    };
+
+    struct SymbolState {
+        std::vector<Order> openOrders;
+        TickRecord last;
+        double position = 0.0;
+        double averagePrice = 0.0;
+        double tripPnl = 0.0;
+    };
+
+    const ReplayData& data;
+    FillModel model;
+    std::vector<SymbolState> symbols;
+    BacktestResult result;
+    std::vector<double> shortfalls;
+    std::vector<BacktestFill> pendingFills;   // reported after matching, so callbacks may place orders
+
+    double cash;
+    double markedValue;            // sum of position * last price
+    double peakEquity;
+    qint64 currentTime;
+    size_t eventIndex;
+    int nextOrderId;
+    double delaySum;
+    quint64 winningTrips;
+
+    qint64 nextSample;
+    double sampledEquity;
+    quint64 samples;
+    double sampleMean;
+    double sampleM2;
+
+    Strategy* strategy;
+
+    int submit(int symbolId, double quantity, double limitPrice);
+    void onEvent(const ReplayData::Event& event);
+    void matchOrders(int symbolId, SymbolState& state, const TickRecord& tick);
+    BacktestFill applyFill(const Order& order, SymbolState& state, double price, bool passive);
+    void sampleEquity(qint64 timestamp);
+    void finish(double elapsedSeconds);
+
+    friend class Backtester;
+
+public:
+    BacktestContext(const ReplayData& data, const FillModel& model);
+
+    // Signed quantity: > 0 buys, < 0 sells. Return the order id, 0 if rejected.
+    int submitMarket(int symbolId, double quantity) { return submit(symbolId, quantity, 0.0); }
+    int submitLimit(int symbolId, double quantity, double limitPrice);
+    bool cancel(int orderId);
+    void cancelAll(int symbolId);
+
+    double position(int symbolId) const;
+    double cashBalance() const { return cash; }
+    double equity() const { return cash + markedValue; }
+    qint64 now() const { return currentTime; }
+    size_t openOrderCount(int symbolId) const;
+    const TickRecord& lastTick(int symbolId) const { return symbols[symbolId].last; }
+    const QString& symbolName(int symbolId) const { return data.symbolList().at(symbolId); }
+    int symbolCount() const { return static_cast<int>(symbols.size()); }
+};
+
+class Backtester {
+public:
+    using StrategyFactory = std::function<std::unique_ptr<Strategy>(const ParameterSet& parameters)>;
+    using ProgressCallback = std::function<void(size_t done, size_t total)>;
+
+    // One replay of 'data' through 'strategy'
+    static BacktestResult run(const ReplayData& data, Strategy& strategy, const FillModel& model,
+        const ParameterSet& parameters = ParameterSet());
+
+    // One run per grid point on 'pool'. Results come back in grid order;
+    // 'progress' is called from worker threads.
+    static std::vector<BacktestResult> sweep(const ReplayData& data, const StrategyFactory& factory,
+        const ParameterGrid& grid, const FillModel& model, WorkStealingPool& pool,
+        const ProgressCallback& progress = ProgressCallback());
+
+    // Built-in strategies: "ema-cross", "mean-reversion". Empty factory if unknown.
+    static StrategyFactory builtinStrategy(const QString& name);
+    static QStringList builtinStrategyNames();
+};
@@ -0,0 +1,59 @@
+#include "BarAggregator.h"
+#include <algorithm>
+
+BarAggregator::BarAggregator(qint64 intervalMs)
+    : intervalMs(std::max<qint64>(intervalMs, 1)) {
+}
+
+void BarAggregator::addTrade(int symbolId, const TickRecord& trade) {
+    if (symbolId < 0) return;
+    if (static_cast<size_t>(symbolId) >= openBars.size())
+        openBars.resize(symbolId + 1);
+
+    qint64 bucket = trade.timestamp - (trade.timestamp % intervalMs);
+    Bar& bar = openBars[symbolId];
+
+    if (bar.trades > 0 && bucket > bar.start) {
+        if (onBarClosed) onBarClosed(symbolId, bar);
+        bar.trades = 0;
+    }
+
+    if (bar.trades == 0) {
+        bar.start = bucket;
+        bar.open = bar.high = bar.low = bar.close = trade.price;
+        bar.volume = trade.volume;
+        bar.trades = 1;
+        return;
+    }
+
+    // Late trades (bucket < start) are folded into the current bar
+    bar.high = std::max(bar.high, trade.price);
+    bar.low = std::min(bar.low, trade.price);
+    bar.close = trade.price;
+    bar.volume += trade.volume;
+    ++bar.trades;
+}
+
+const Bar* BarAggregator::openBar(int symbolId) const {
+    if (symbolId < 0 || static_cast<size_t>(symbolId) >= openBars.size())
+        return nullptr;
+    const Bar& bar = openBars[symbolId];
+    return bar.trades > 0 ? &bar : nullptr;
+}
+
+void BarAggregator::restoreOpenBar(int symbolId, const Bar& bar) {
+    if (symbolId < 0) return;
+    if (static_cast<size_t>(symbolId) >= openBars.size())
+        openBars.resize(symbolId + 1);
+    openBars[symbolId] = bar;
+}
+
+void BarAggregator::flush(qint64 nowMs) {
+    for (size_t id = 0; id < openBars.size(); ++id) {
+        Bar& bar = openBars[id];
+        if (bar.trades > 0 && nowMs >= bar.start + intervalMs) {
+            if (onBarClosed) onBarClosed(static_cast<int>(id), bar);
+            bar.trades = 0;
+        }
+    }
+}
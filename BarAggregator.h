@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "MarketTick.h"
+
+// One OHLCV bar
+struct Bar {
+    qint64 start = 0;   // bar open time, ms since epoch
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    int trades = 0;
+};
+
+// Aggregates trades into fixed-interval bars for every symbol id.
+// A bar closes when the first trade of a later interval arrives.
+class BarAggregator {
+public:
+    using BarClosedCallback = std::function<void(int symbolId, const Bar& bar)>;
+
+private:
+    qint64 intervalMs;
+    std::vector<Bar> openBars;   // indexed by symbol id; trades == 0 means no open bar
+    BarClosedCallback onBarClosed;
+
+public:
+    explicit BarAggregator(qint64 intervalMs = 1000);
+
+    void setInterval(qint64 ms) { intervalMs = std::max<qint64>(ms, 1); }
+    qint64 interval() const { return intervalMs; }
+    void setBarClosedCallback(BarClosedCallback callback) { onBarClosed = std::move(callback); }
+
+    void addTrade(int symbolId, const TickRecord& trade);
+
+    // Current (still open) bar, or nullptr when the symbol has none
+    const Bar* openBar(int symbolId) const;
+
+    // Restore an open bar, e.g. from a snapshot
+    void restoreOpenBar(int symbolId, const Bar& bar);
+
+    // Close every open bar whose interval has ended by 'nowMs'
+    void flush(qint64 nowMs);
+};
@@ -0,0 +1,131 @@
+#include "ChartDashboard.h"
+#include <QVBoxLayout>
+#include <algorithm>
+
+ChartDashboard::ChartDashboard(TickStore& store, QWidget* parent)
+    : QWidget(parent),
+    tickStore(store),
+    columns(4),
+    maxDataPoints(100),
+    darkTheme(true)
+{
+    scrollArea = new QScrollArea(this);
+    scrollArea->setWidgetResizable(true);
+
+    gridHost = new QWidget();
+    grid = new QGridLayout(gridHost);
+    grid->setSpacing(4);
+    grid->setContentsMargins(0, 0, 0, 0);
+    scrollArea->setWidget(gridHost);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(scrollArea);
+}
+
+void ChartDashboard::markRendered(Panel& panel) {
+    const TickBuffer& buffer = tickStore.buffer(panel.symbolId);
+    panel.renderedSequence = buffer.totalAppended();
+    panel.renderedEpoch = buffer.epoch();
+}
+
+void ChartDashboard::setSymbols(const QStringList& symbols) {
+    // Keep existing panels (and their rendered state) for symbols that stay
+    std::vector<Panel> next;
+    next.reserve(symbols.size());
+
+    for (const QString& symbol : symbols) {
+        auto it = std::find_if(panels.begin(), panels.end(),
+            [&symbol](const Panel& panel) { return panel.symbol == symbol; });
+        if (it != panels.end()) {
+            next.push_back(std::move(*it));
+            continue;
+        }
+
+        Panel panel;
+        panel.symbol = symbol;
+        panel.symbolId = tickStore.symbolId(symbol);
+        panel.chart = std::make_unique<ChartManager>(gridHost);
+        panel.chart->setMaxDataPoints(maxDataPoints);
+        panel.chart->setDarkTheme(darkTheme);
+        panel.chart->getChartView()->setMinimumSize(320, 220);
+        panel.chart->showSymbol(symbol, tickStore.buffer(panel.symbolId));
+        markRendered(panel);
+        next.push_back(std::move(panel));
+    }
+
+    // Panels for symbols that went away
+    for (Panel& panel : panels) {
+        if (panel.chart) {
+            grid->removeWidget(panel.chart->getChartView());
+            panel.chart->getChartView()->deleteLater();
+        }
+    }
+
+    panels = std::move(next);
+    relayout();
+}
+
+void ChartDashboard::setColumns(int count) {
+    columns = std::max(1, count);
+    relayout();
+}
+
+void ChartDashboard::relayout() {
+    for (size_t i = 0; i < panels.size(); ++i) {
+        QChartView* view = panels[i].chart->getChartView();
+        grid->removeWidget(view);
+        grid->addWidget(view, static_cast<int>(i) / columns, static_cast<int>(i) % columns);
+    }
+}
+
+void ChartDashboard::setMaxDataPoints(int points) {
+    maxDataPoints = points;
+    for (Panel& panel : panels) {
+        panel.chart->setMaxDataPoints(points);
+        panel.chart->showSymbol(panel.symbol, tickStore.buffer(panel.symbolId));
+        markRendered(panel);
+    }
+}
+
+void ChartDashboard::setDarkTheme(bool dark) {
+    darkTheme = dark;
+    for (Panel& panel : panels) {
+        panel.chart->setDarkTheme(dark);
+    }
+}
+
+void ChartDashboard::renderFrame() {
+    // Nothing to do while the dashboard page itself is hidden
+    if (!isVisible())
+        return;
+
+    for (Panel& panel : panels) {
+        QChartView* view = panel.chart->getChartView();
+
+        // Hidden or scrolled out of the viewport: skip entirely, catch up when shown
+        if (!view->isVisible() || view->visibleRegion().isEmpty())
+            continue;
+
+        const TickBuffer& buffer = tickStore.buffer(panel.symbolId);
+        const bool cleared = buffer.epoch() != panel.renderedEpoch;
+        if (cleared || buffer.totalAppended() != panel.renderedSequence) {
+            bool complete = !cleared && buffer.copySince(panel.renderedSequence, scratch);
+            if (complete && scratch.size() <= static_cast<size_t>(maxDataPoints)) {
+                panel.chart->appendTicks(scratch);
+            }
+            else {
+                // Too far behind, wrapped or cleared (data source switch): reload the window
+                panel.chart->showSymbol(panel.symbol, buffer);
+            }
+            markRendered(panel);
+        }
+
+        // Any number of quotes since the last frame collapse into one point
+        const TopOfBook* top = topOfBook ? topOfBook->find(panel.symbolId) : nullptr;
+        if (top && top->hasQuote() && top->quoteVersion != panel.renderedQuoteVersion) {
+            panel.renderedQuoteVersion = top->quoteVersion;
+            panel.chart->addBidAskPoints(top->bid, top->ask, top->quoteTime);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QGridLayout>
+#include <QScrollArea>
+#include <QStringList>
+#include <QWidget>
+#include <memory>
+#include <vector>
+#include "ChartManager.h"
+#include "TickStore.h"
+#include "TopOfBookCache.h"
+
+// Grid of ChartManager panels, one per watched symbol, all fed from the shared
+// TickStore on the owner's frame tick (renderFrame). Each frame only panels that are on screen
+// and whose buffer changed since their last render are touched, so the cost
+// scales with visible panels rather than with tick volume.
+class ChartDashboard : public QWidget {
+private:
+    struct Panel {
+        QString symbol;
+        int symbolId = -1;
+        std::unique_ptr<ChartManager> chart;
+        quint64 renderedSequence = 0;   // TickBuffer::totalAppended() at last render
+        quint64 renderedEpoch = 0;      // TickBuffer::epoch() at last render
+        quint64 renderedQuoteVersion = 0;
+    };
+
+    TickStore& tickStore;
+    const TopOfBookCache* topOfBook = nullptr;
+    std::vector<Panel> panels;
+    QScrollArea* scrollArea;
+    QWidget* gridHost;
+    QGridLayout* grid;
+
+    int columns;
+    int maxDataPoints;
+    bool darkTheme;
+    std::vector<TickRecord> scratch;
+
+    void relayout();
+    void markRendered(Panel& panel);
+
+public:
+    explicit ChartDashboard(TickStore& store, QWidget* parent = nullptr);
+
+    void setSymbols(const QStringList& symbols);
+    void setColumns(int count);
+    void setMaxDataPoints(int points);
+    void setDarkTheme(bool dark);
+    // Source of the bid/ask lines, as on the main chart; without one panels draw price only
+    void setTopOfBook(const TopOfBookCache* cache) { topOfBook = cache; }
+
+    int panelCount() const { return static_cast<int>(panels.size()); }
+
+    // Brings visible panels up to date; called once per frame by the owner
+    void renderFrame();
+};
@@ -1,5 +1,7 @@
 #include "ChartManager.h"
 #include "MockDataGenerator.h"
+#include "TickStore.h"
+#include "TickExporter.h"
 #include <QtCharts/QChart>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
@@ -7,13 +9,15 @@
 #include <QtCharts/QDateTimeAxis>
 #include <QtCore/QDateTime>
 #include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
 #include <QtWidgets/QApplication>
 #include <algorithm>
 #include <chrono>
 #include <iostream>
 
 ChartManager::ChartManager(QWidget* parent)
-    : maxDataPoints(100), minPrice(0), maxPrice(0) {
+    : indicatorSource(nullptr), indicatorsEnabled(false), volumeProfile(nullptr), feedGaps(nullptr),
+    maxDataPoints(100), minPrice(0), maxPrice(0) {
 
     // Create chart and series
     priceChart = new QChart();
@@ -53,6 +57,36 @@ ChartManager::ChartManager(QWidget* parent)
     askSeries->attachAxis(timeAxis);
     askSeries->attachAxis(priceAxis);
 
+    // Indicator overlays share the price axis and stay hidden until enabled
+    const char* overlayNames[OverlayCount] = { "EMA", "SMA", "VWAP", "BB Upper", "BB Lower" };
+    for (int i = 0; i < OverlayCount; ++i) {
+        QLineSeries* series = new QLineSeries();
+        series->setName(overlayNames[i]);
+        series->setVisible(false);
+        priceChart->addSeries(series);
+        series->attachAxis(timeAxis);
+        series->attachAxis(priceAxis);
+        overlays[i].series = series;
+    }
+
+    // Volume profile bars sit above the series, translucent so prices stay readable
+    profileOutside = new QGraphicsPathItem(priceChart);
+    profileInside = new QGraphicsPathItem(priceChart);
+    profilePoc = new QGraphicsPathItem(priceChart);
+    profileOutside->setBrush(QColor(128, 128, 128, 70));
+    profileInside->setBrush(QColor(100, 149, 237, 90));
+    profilePoc->setBrush(QColor(255, 165, 0, 160));
+    for (QGraphicsPathItem* item : { profileOutside, profileInside, profilePoc }) {
+        item->setPen(Qt::NoPen);
+        item->setZValue(10);
+    }
+
+    // Feed gaps sit below the profile, faint enough that a line drawn across them still shows
+    gapShade = new QGraphicsPathItem(priceChart);
+    gapShade->setBrush(QColor(220, 60, 60, 45));
+    gapShade->setPen(Qt::NoPen);
+    gapShade->setZValue(5);
+
     // Configure chart appearance
     setChartTheme(true); // Dark theme by default
     enableAntialiasing(true);
@@ -83,9 +117,11 @@ void ChartManager::clearChart() {
     priceData.clear();
     bidData.clear();
     askData.clear();
+    clearOverlays();
 
     minPrice = 0;
     maxPrice = 0;
+    refreshOverlayItems();
 }
 
 void ChartManager::addMarketTick(const MarketTick& tick) {
@@ -111,6 +147,8 @@ void ChartManager::addMarketTick(const MarketTick& tick) {
     bidSeries->append(bidPoint);
     askSeries->append(askPoint);
 
+    appendLatestOverlay(timeValue);
+
     // Trim old data for performance
     trimOldData();
 
@@ -136,6 +174,8 @@ void ChartManager::addPricePoint(double price, qint64 timestamp) {
     priceData.push_back(point);
     priceSeries->append(point);
 
+    appendLatestOverlay(timestamp);
+
     trimOldData();
     updateAxisRanges();
 }
@@ -157,26 +197,98 @@ void ChartManager::addBidAskPoints(double bid, double ask, qint64 timestamp) {
     updateAxisRanges();
 }
 
-void ChartManager::trimOldData() {
-    // Remove old data points to maintain performance
-    while (priceData.size() > static_cast<size_t>(maxDataPoints)) {
-        priceData.pop_front();
-        priceSeries->removePoints(0, 1);
+void ChartManager::loadTicks(const std::vector<TickRecord>& ticks) {
+    priceData.clear();
+    bidData.clear();
+    askData.clear();
+    minPrice = 0;
+    maxPrice = 0;
+
+    size_t first = ticks.size() > static_cast<size_t>(maxDataPoints) ? ticks.size() - maxDataPoints : 0;
+
+    QList<QPointF> pricePoints;
+    QList<QPointF> bidPoints;
+    QList<QPointF> askPoints;
+    pricePoints.reserve(static_cast<qsizetype>(ticks.size() - first));
+
+    for (size_t i = first; i < ticks.size(); ++i) {
+        const TickRecord& tick = ticks[i];
+        QPointF pricePoint(tick.timestamp, tick.price);
+        priceData.push_back(pricePoint);
+        pricePoints.append(pricePoint);
+
+        // Records without a quote (e.g. live trades) only carry a price
+        if (tick.bid > 0.0 && tick.ask > 0.0) {
+            QPointF bidPoint(tick.timestamp, tick.bid);
+            QPointF askPoint(tick.timestamp, tick.ask);
+            bidData.push_back(bidPoint);
+            askData.push_back(askPoint);
+            bidPoints.append(bidPoint);
+            askPoints.append(askPoint);
+        }
     }
 
-    while (bidData.size() > static_cast<size_t>(maxDataPoints)) {
-        bidData.pop_front();
-        bidSeries->removePoints(0, 1);
+    // One replace() per series triggers a single repaint instead of one per point
+    priceSeries->replace(pricePoints);
+    bidSeries->replace(bidPoints);
+    askSeries->replace(askPoints);
+
+    rebuildOverlays();
+
+    updateAxisRanges();
+}
+
+void ChartManager::appendTicks(const std::vector<TickRecord>& ticks) {
+    if (ticks.empty()) return;
+
+    QList<QPointF> pricePoints;
+    pricePoints.reserve(static_cast<qsizetype>(ticks.size()));
+
+    for (const TickRecord& tick : ticks) {
+        QPointF pricePoint(tick.timestamp, tick.price);
+        priceData.push_back(pricePoint);
+        pricePoints.append(pricePoint);
     }
 
-    while (askData.size() > static_cast<size_t>(maxDataPoints)) {
-        askData.pop_front();
-        askSeries->removePoints(0, 1);
+    priceSeries->append(pricePoints);
+
+    // Conflated batches get one overlay point, at the newest trade
+    appendLatestOverlay(ticks.back().timestamp);
+
+    trimOldData();
+    updateAxisRanges();
+}
+
+void ChartManager::showSymbol(const QString& symbol, const TickBuffer& buffer) {
+    currentSymbol = symbol;
+    priceChart->setTitle(QString("Lightning Trade - %1 Real-time Data").arg(symbol));
+
+    buffer.copyTail(static_cast<size_t>(maxDataPoints), loadScratch);
+    loadTicks(loadScratch);
+}
+
+void ChartManager::trimOldData() {
+    // Remove old data points to maintain performance, one removePoints() call per series
+    auto trim = [this](std::deque<QPointF>& data, QLineSeries* series) {
+        if (data.size() <= static_cast<size_t>(maxDataPoints)) return;
+        size_t excess = data.size() - static_cast<size_t>(maxDataPoints);
+        data.erase(data.begin(), data.begin() + excess);
+        series->removePoints(0, static_cast<int>(excess));
+    };
+
+    trim(priceData, priceSeries);
+    trim(bidData, bidSeries);
+    trim(askData, askSeries);
+    for (Overlay& overlay : overlays) {
+        trim(overlay.data, overlay.series);
     }
 }
 
 void ChartManager::updateAxisRanges() {
-    if (priceData.empty()) return;
+    if (priceData.empty()) {
+        refreshOverlayItems();
+        return;
+    }
 
     // Find min/max values for price axis
     double newMinPrice = std::numeric_limits<double>::max();
@@ -197,6 +309,14 @@ void ChartManager::updateAxisRanges() {
         newMaxPrice = std::max(newMaxPrice, point.y());
     }
 
+    // Bollinger bands are the only overlays that can leave the price envelope
+    for (const auto& point : overlays[OverlayBollingerUpper].data) {
+        newMaxPrice = std::max(newMaxPrice, point.y());
+    }
+    for (const auto& point : overlays[OverlayBollingerLower].data) {
+        newMinPrice = std::min(newMinPrice, point.y());
+    }
+
     // Add some padding
     double padding = (newMaxPrice - newMinPrice) * 0.05; // 5% padding
     newMinPrice -= padding;
@@ -211,6 +331,177 @@ void ChartManager::updateAxisRanges() {
         QDateTime endTime = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(priceData.back().x()));
         timeAxis->setRange(startTime, endTime);
     }
+
+    refreshOverlayItems();
+}
+
+void ChartManager::setVolumeProfile(const VolumeProfile* profile) {
+    volumeProfile = profile;
+    refreshVolumeProfile();
+}
+
+void ChartManager::refreshOverlayItems() {
+    refreshVolumeProfile();
+    refreshFeedGaps();
+}
+
+void ChartManager::setFeedGaps(const std::deque<FeedGap>* gaps) {
+    feedGaps = gaps;
+    refreshFeedGaps();
+}
+
+void ChartManager::refreshFeedGaps() {
+    QPainterPath shade;
+
+    if (feedGaps && !feedGaps->empty() && !priceData.empty()) {
+        const QRectF plot = priceChart->plotArea();
+        const qint64 first = timeAxis->min().toMSecsSinceEpoch();
+        const qint64 last = timeAxis->max().toMSecsSinceEpoch();
+        const double y = priceAxis->min();
+
+        for (auto it = feedGaps->rbegin(); it != feedGaps->rend(); ++it) {
+            const qint64 to = it->isOpen() ? last : it->toTimestamp;
+            if (to < first) break;               // older gaps are further left still
+            if (it->fromTimestamp > last) continue;
+
+            double left = priceChart->mapToPosition(QPointF(static_cast<double>(std::max(it->fromTimestamp, first)), y), priceSeries).x();
+            double right = priceChart->mapToPosition(QPointF(static_cast<double>(std::min(to, last)), y), priceSeries).x();
+            left = std::clamp(left, plot.left(), plot.right());
+            right = std::clamp(right, plot.left(), plot.right());
+            shade.addRect(QRectF(left, plot.top(), std::max(2.0, right - left), plot.height()));
+        }
+    }
+
+    gapShade->setPath(shade);
+}
+
+void ChartManager::refreshVolumeProfile() {
+    QPainterPath outside, inside, poc;
+
+    if (volumeProfile && !volumeProfile->empty() && !priceData.empty()) {
+        const QRectF plot = priceChart->plotArea();
+        const double x = priceData.back().x();
+        const size_t first = volumeProfile->bucketAt(priceAxis->min());
+        const size_t last = volumeProfile->bucketAt(priceAxis->max());
+        const size_t pocBucket = volumeProfile->bucketAt(volumeProfile->pointOfControl());
+
+        // Merge buckets so there is at most about one bar per pixel row
+        size_t rows = std::max<size_t>(1, static_cast<size_t>(plot.height()));
+        size_t step = std::max<size_t>(1, (last - first + 1 + rows - 1) / rows);
+
+        double peak = 0.0;
+        for (size_t i = first; i <= last; i += step) {
+            double volume = 0.0;
+            for (size_t j = i; j < std::min(i + step, last + 1); ++j) volume += volumeProfile->bucketVolume(j);
+            peak = std::max(peak, volume);
+        }
+
+        const double maxWidth = plot.width() * 0.25;
+        for (size_t i = first; peak > 0.0 && i <= last; i += step) {
+            size_t end = std::min(i + step, last + 1);
+            double volume = 0.0;
+            bool hasPoc = false;
+            bool inValue = false;
+            for (size_t j = i; j < end; ++j) {
+                volume += volumeProfile->bucketVolume(j);
+                hasPoc = hasPoc || j == pocBucket;
+                inValue = inValue || volumeProfile->inValueArea(j);
+            }
+            if (volume <= 0.0) continue;
+
+            double top = priceChart->mapToPosition(QPointF(x, volumeProfile->bucketPrice(end - 1) + volumeProfile->bucketSize()), priceSeries).y();
+            double bottom = priceChart->mapToPosition(QPointF(x, volumeProfile->bucketPrice(i)), priceSeries).y();
+            double y = std::clamp(std::min(top, bottom), plot.top(), plot.bottom());
+            double h = std::max(1.0, std::clamp(std::max(top, bottom), plot.top(), plot.bottom()) - y);
+            double w = maxWidth * volume / peak;
+
+            QRectF bar(plot.right() - w, y, w, h);
+            if (hasPoc) poc.addRect(bar);
+            else if (inValue) inside.addRect(bar);
+            else outside.addRect(bar);
+        }
+    }
+
+    profileOutside->setPath(outside);
+    profileInside->setPath(inside);
+    profilePoc->setPath(poc);
+}
+
+void ChartManager::setIndicatorsEnabled(bool enabled) {
+    if (indicatorsEnabled == enabled) return;
+    indicatorsEnabled = enabled;
+
+    for (Overlay& overlay : overlays) {
+        overlay.series->setVisible(enabled);
+    }
+    rebuildOverlays();
+}
+
+void ChartManager::setIndicatorSource(const SymbolIndicators* source) {
+    indicatorSource = source;
+    rebuildOverlays();
+}
+
+IndicatorValues ChartManager::latestIndicators() const {
+    return indicatorSource ? indicatorSource->latest() : IndicatorValues();
+}
+
+void ChartManager::clearOverlays() {
+    for (Overlay& overlay : overlays) {
+        overlay.data.clear();
+        overlay.series->clear();
+    }
+}
+
+void ChartManager::rebuildOverlays() {
+    clearOverlays();
+    if (!indicatorsEnabled || !indicatorSource || priceData.empty())
+        return;
+
+    // Every stored sample inside the plotted window, in one append per series
+    const qreal from = priceData.front().x();
+    OverlayBatch batch;
+    for (const SymbolIndicators::Sample& sample : indicatorSource->recent()) {
+        if (sample.timestamp >= from)
+            collectOverlayPoints(sample.timestamp, sample.values, batch);
+    }
+    appendOverlays(batch);
+}
+
+void ChartManager::appendLatestOverlay(qint64 timestamp) {
+    if (!indicatorsEnabled || !indicatorSource)
+        return;
+    OverlayBatch batch;
+    collectOverlayPoints(timestamp, indicatorSource->latest(), batch);
+    appendOverlays(batch);
+}
+
+void ChartManager::applyOverlayPens() {
+    // QChart::setTheme() recolours every series, so this runs after each theme change
+    const char* overlayColors[OverlayCount] = { "#FFD700", "#DA70D6", "#A0A0A0", "#808080", "#808080" };
+    for (int i = 0; i < OverlayCount; ++i) {
+        overlays[i].series->setPen(QPen(QColor(overlayColors[i]), 1,
+            i >= OverlayBollingerUpper ? Qt::DashLine : Qt::SolidLine));
+    }
+}
+
+void ChartManager::collectOverlayPoints(qint64 timestamp, const IndicatorValues& values, OverlayBatch& batch) {
+    const double byIndex[OverlayCount] = {
+        values.ema, values.sma, values.vwap, values.bollingerUpper, values.bollingerLower
+    };
+    for (int i = 0; i < OverlayCount; ++i) {
+        if (!Indicators::ready(byIndex[i])) continue;
+        QPointF point(timestamp, byIndex[i]);
+        overlays[i].data.push_back(point);
+        batch[i].append(point);
+    }
+}
+
+void ChartManager::appendOverlays(OverlayBatch& batch) {
+    for (int i = 0; i < OverlayCount; ++i) {
+        if (!batch[i].isEmpty())
+            overlays[i].series->append(batch[i]);
+    }
 }
 
 void ChartManager::setChartTheme(bool darkMode) {
@@ -245,6 +536,7 @@ void ChartManager::setChartTheme(bool darkMode) {
 
         chartView->setStyleSheet("background-color: white;");
     }
+    applyOverlayPens();
 }
 
 void ChartManager::enableAntialiasing(bool enable) {
@@ -270,9 +562,26 @@ void ChartManager::saveChartImage(const QString& filename) {
     std::cout << "Chart saved to: " << filename.toStdString() << std::endl;
 }
 
-void ChartManager::exportChartData(const QString& filename) {
-    // This would export the chart data to CSV - placeholder for research features
-    std::cout << "Chart data export to: " << filename.toStdString() << " (feature placeholder)" << std::endl;
+bool ChartManager::exportChartData(const QString& filename, TickExporter& exporter) const {
+    // Bid/ask points are stamped with the quote's own time, not the trade's: join each trade
+    // to the latest quote at or before it (0 until the first quote)
+    std::vector<TickRecord> window;
+    window.reserve(priceData.size());
+    auto bid = bidData.begin();
+    auto ask = askData.begin();
+    double lastBid = 0.0;
+    double lastAsk = 0.0;
+    for (const QPointF& point : priceData) {
+        TickRecord tick;
+        tick.timestamp = static_cast<qint64>(point.x());
+        tick.price = point.y();
+        for (; bid != bidData.end() && bid->x() <= point.x(); ++bid) lastBid = bid->y();
+        for (; ask != askData.end() && ask->x() <= point.x(); ++ask) lastAsk = ask->y();
+        tick.bid = lastBid;
+        tick.ask = lastAsk;
+        window.push_back(tick);
+    }
+    return exporter.start(filename, currentSymbol, std::move(window));
 }
 
 void ChartManager::setDarkTheme(bool dark){
@@ -284,6 +593,7 @@ void ChartManager::setDarkTheme(bool dark){
     else {
         priceChart->setTheme(QChart::ChartThemeLight);
     }
+    applyOverlayPens();
 }
 
 void ChartManager::addDataPoint(double price, qint64 timestamp){
@@ -7,13 +7,20 @@
 #include <QtCharts/QCandlestickSeries>
 #include <QtCharts/QCandlestickSet>
 #include <QtCore/QDateTime>
+#include <QGraphicsPathItem>
 #include <QWidget>
 #include <memory>
+#include <array>
 #include <deque>
 #include <limits>
+#include <vector>
+#include "MarketTick.h"
+#include "Indicators.h"
+#include "VolumeProfile.h"
 
 // Forward declaration
-struct MarketTick;
+class TickBuffer;
+class TickExporter;
 
 class ChartManager {
 private:
@@ -30,13 +37,43 @@ private:
     std::deque<QPointF> bidData;
     std::deque<QPointF> askData;
 
+    // Indicator overlays on the price axis, read from `indicatorSource` (not owned)
+    enum OverlayIndex { OverlayEma, OverlaySma, OverlayVwap, OverlayBollingerUpper, OverlayBollingerLower, OverlayCount };
+    struct Overlay {
+        QLineSeries* series = nullptr;
+        std::deque<QPointF> data;
+    };
+    std::array<Overlay, OverlayCount> overlays;
+    using OverlayBatch = std::array<QList<QPointF>, OverlayCount>;
+    const SymbolIndicators* indicatorSource;
+    bool indicatorsEnabled;
+
+    // Volume-at-price histogram drawn against the price axis (not owned)
+    const VolumeProfile* volumeProfile;
+    QGraphicsPathItem* profileOutside;   // bars outside the value area
+    QGraphicsPathItem* profileInside;    // value area
+    QGraphicsPathItem* profilePoc;       // point of control
+
+    // Feed outages shaded across the plot (not owned)
+    const std::deque<FeedGap>* feedGaps;
+    QGraphicsPathItem* gapShade;
+
     // Chart configuration
     int maxDataPoints;
     QString currentSymbol;
     double minPrice, maxPrice;
+    std::vector<TickRecord> loadScratch;
 
     void updateAxisRanges();
     void trimOldData();
+    void collectOverlayPoints(qint64 timestamp, const IndicatorValues& values, OverlayBatch& batch);
+    void appendOverlays(OverlayBatch& batch);
+    void appendLatestOverlay(qint64 timestamp);
+    void clearOverlays();
+    void rebuildOverlays();
+    void applyOverlayPens();
+    void refreshVolumeProfile();
+    void refreshOverlayItems();
 
 public:
     ChartManager(QWidget* parent = nullptr);
@@ -53,6 +90,34 @@ public:
     void addPricePoint(double price, qint64 timestamp);
     void addBidAskPoints(double bid, double ask, qint64 timestamp);
 
+    // Bulk load: replaces every series in one update instead of per-point appends
+    void loadTicks(const std::vector<TickRecord>& ticks);
+    // Append a batch of new ticks with one series update and one axis refresh.
+    // Price only: live bid/ask comes from top-of-book via addBidAskPoints, stamped
+    // with quote time, and a second source would make the lines step back in time
+    void appendTicks(const std::vector<TickRecord>& ticks);
+    // Re-point the chart at a symbol's already-populated buffer
+    void showSymbol(const QString& symbol, const TickBuffer& buffer);
+
+    // EMA/SMA/VWAP/Bollinger overlays; off by default. The values come from the
+    // symbol's SymbolIndicators, which the owner feeds with every raw trade; the
+    // chart only reads them: one point per update from latest(), and recent()
+    // to redraw the window. Null (the default) draws no overlays.
+    void setIndicatorsEnabled(bool enabled);
+    bool areIndicatorsEnabled() const { return indicatorsEnabled; }
+    void setIndicatorSource(const SymbolIndicators* source);
+    // Values after the symbol's newest trade, including RSI and volatility which have no overlay
+    IndicatorValues latestIndicators() const;
+
+    // Horizontal volume profile along the right of the plot; null hides it.
+    // Redrawn with the axes, so it follows new trades and rescaling.
+    void setVolumeProfile(const VolumeProfile* profile);
+
+    // Shades the time ranges in 'gaps' (e.g. TickStore::gaps()) where the feed
+    // delivered nothing; null hides them. Call refreshFeedGaps() when they change.
+    void setFeedGaps(const std::deque<FeedGap>* gaps);
+    void refreshFeedGaps();
+
     // Chart styling
     void setChartTheme(bool darkMode = true);
     void enableAntialiasing(bool enable = true);
@@ -62,7 +127,9 @@ public:
 
     // Utility functions
     void saveChartImage(const QString& filename);
-    void exportChartData(const QString& filename);
+    // Starts a background export of the plotted window (price with its bid/ask);
+    // false if 'exporter' is still busy. The format follows the file suffix.
+    bool exportChartData(const QString& filename, TickExporter& exporter) const;
 
     void setDarkTheme(bool dark);
     void addDataPoint(double price, qint64 timestamp);
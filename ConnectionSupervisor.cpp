@@ -0,0 +1,156 @@
+#include "ConnectionSupervisor.h"
+#include "WebSocketClient.h"
+#include <QDateTime>
+#include <QHostInfo>
+#include <QRandomGenerator>
+#include <algorithm>
+
+namespace {
+    constexpr int WatchdogMs = 250;
+}
+
+ConnectionSupervisor::ConnectionSupervisor(WebSocketClient& client)
+    : ConnectionSupervisor(client, Options()) {
+}
+
+ConnectionSupervisor::ConnectionSupervisor(WebSocketClient& client, const Options& options)
+    : client(client), options(options) {
+    reconnectTimer.setSingleShot(true);
+    QObject::connect(&reconnectTimer, &QTimer::timeout, &reconnectTimer, [this]() { open(); });
+
+    watchdog.setInterval(WatchdogMs);
+    QObject::connect(&watchdog, &QTimer::timeout, &watchdog, [this]() { checkHealth(); });
+
+    resolveTimer.setInterval(options.resolveEveryMs);
+    QObject::connect(&resolveTimer, &QTimer::timeout, &resolveTimer, [this]() { resolve(); });
+
+    // The watchdog is the context: these die with the supervisor even if the client lives on
+    QObject::connect(&client, &WebSocketClient::connected, &watchdog, [this]() { onConnected(); });
+    QObject::connect(&client, &WebSocketClient::disconnected, &watchdog, [this]() { onDown(); });
+    QObject::connect(&client, &WebSocketClient::errorOccurred, &watchdog, [this](const QString& errorString) {
+        Q_UNUSED(errorString);
+        onDown();
+    });
+    // Heartbeats count: any frame proves the connection is alive
+    QObject::connect(&client, &WebSocketClient::messageReceived, &watchdog, [this](const QString& message) {
+        Q_UNUSED(message);
+        sinceMessage.start();
+    });
+}
+
+void ConnectionSupervisor::start(const QUrl& endpoint) {
+    if (running && endpoint == url && (connecting || client.isConnected()))
+        return;
+
+    url = endpoint;
+    running = true;
+    outage = false;
+    attempt = 0;
+    reconnectTimer.stop();
+
+    resolve();
+    resolveTimer.start();
+    watchdog.start();
+    open();
+}
+
+void ConnectionSupervisor::stop() {
+    running = false;
+    connecting = false;
+    outage = false;
+    reconnectTimer.stop();
+    watchdog.stop();
+    resolveTimer.stop();
+    client.disconnectFromServer();
+}
+
+void ConnectionSupervisor::open() {
+    if (!running)
+        return;
+    connecting = true;
+    sinceConnect.start();
+    client.connectToServer(url);
+}
+
+void ConnectionSupervisor::onConnected() {
+    if (!running)
+        return;
+    connecting = false;
+    sinceConnect.start();
+    sinceMessage.start();
+    if (outage) {
+        outage = false;
+        if (callbacks.restored)
+            callbacks.restored(QDateTime::currentMSecsSinceEpoch());
+    }
+}
+
+void ConnectionSupervisor::onDown() {
+    if (!running)
+        return;
+    connecting = false;
+    if (!outage) {
+        outage = true;
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        if (callbacks.lost)
+            callbacks.lost(sinceMessage.isValid() ? now - sinceMessage.elapsed() : now);
+    }
+    scheduleReconnect();
+}
+
+int ConnectionSupervisor::nextDelayMs() {
+    // Equal jitter: half the exponential step is fixed, the other half random
+    const qint64 step = std::min<qint64>(options.maxBackoffMs,
+        static_cast<qint64>(options.initialBackoffMs) << std::min(attempt, 16));
+    const int half = static_cast<int>(std::max<qint64>(step / 2, 1));
+    return half + static_cast<int>(QRandomGenerator::global()->bounded(half + 1));
+}
+
+void ConnectionSupervisor::scheduleReconnect() {
+    // An error and the disconnect that follows it ask for the same retry
+    if (reconnectTimer.isActive())
+        return;
+    const int delay = nextDelayMs();
+    ++attempt;
+    ++reconnects;
+    if (callbacks.retrying)
+        callbacks.retrying(attempt, delay);
+    reconnectTimer.start(delay);
+}
+
+void ConnectionSupervisor::checkHealth() {
+    if (connecting) {
+        if (sinceConnect.elapsed() > options.connectTimeoutMs) {
+            client.abort();
+            onDown();
+        }
+        return;
+    }
+    if (!client.isConnected())
+        return;
+
+    if (attempt > 0 && sinceConnect.elapsed() > options.stableAfterMs)
+        attempt = 0;
+
+    const qint64 silent = sinceMessage.elapsed();
+    if (silent > options.staleAfterMs) {
+        ++staleAborts;
+        if (callbacks.stale)
+            callbacks.stale(silent);
+        client.abort();
+        onDown();
+    }
+}
+
+void ConnectionSupervisor::resolve() {
+    const QString host = url.host();
+    if (host.isEmpty())
+        return;
+    QHostInfo::lookupHost(host, &resolveTimer, [this](const QHostInfo& info) {
+        if (info.error() != QHostInfo::NoError || info.addresses().isEmpty() || info.addresses() == addresses)
+            return;
+        addresses = info.addresses();
+        if (callbacks.resolved)
+            callbacks.resolved(addresses);
+    });
+}
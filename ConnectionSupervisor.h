@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+#include <functional>
+
+class WebSocketClient;
+
+// Keeps one WebSocketClient connected. A drop, an error or a connection that
+// has gone quiet for longer than the heartbeat allows is followed by a
+// reconnect after a jittered exponential backoff (so a fleet of clients does
+// not hammer the exchange in lockstep). The backoff resets once a connection
+// has stayed up for a while, and an attempt that neither connects nor fails
+// in time is aborted and retried.
+//
+// The endpoint's host is resolved in the background at start and every
+// 'resolveEveryMs' while running, which keeps Qt's host lookup cache warm:
+// a reconnect opens the socket without waiting on DNS.
+//
+// The owner resubscribes from 'connected' as before (SubscriptionManager
+// does the whole watch set in one batch per channel) and learns about
+// outages through 'lost' and 'restored', e.g. to record a FeedGap.
+class ConnectionSupervisor {
+public:
+    struct Options {
+        int initialBackoffMs = 250;
+        int maxBackoffMs = 30000;
+        int staleAfterMs = 3000;       // Kraken sends a heartbeat after about 1 s without data
+        int connectTimeoutMs = 10000;
+        int stableAfterMs = 10000;     // connected this long: the next outage starts from the initial backoff
+        int resolveEveryMs = 30000;
+    };
+
+    struct Callbacks {
+        std::function<void(qint64 lastDataMs)> lost;          // data stopped; wall clock of the last message
+        std::function<void(qint64 nowMs)> restored;           // connected again
+        std::function<void(int attempt, int delayMs)> retrying;
+        std::function<void(qint64 silentMs)> stale;           // about to abort a quiet connection
+        std::function<void(const QList<QHostAddress>& addresses)> resolved;
+    };
+
+private:
+    WebSocketClient& client;
+    Options options;
+    Callbacks callbacks;
+
+    QUrl url;
+    bool running = false;
+    bool connecting = false;
+    bool outage = false;              // 'lost' reported, 'restored' not yet
+    int attempt = 0;                  // reconnects since the last stable connection
+    quint64 reconnects = 0;
+    quint64 staleAborts = 0;
+
+    QTimer reconnectTimer;            // single shot, the pending backoff
+    QTimer watchdog;                  // staleness, connect timeout, backoff reset
+    QTimer resolveTimer;
+    QElapsedTimer sinceMessage;
+    QElapsedTimer sinceConnect;       // attempt start while connecting, connection start once up
+    qint64 lastMessageMs = 0;         // wall clock
+    QList<QHostAddress> addresses;
+
+    void open();
+    void onConnected();
+    void onDown();
+    void scheduleReconnect();
+    void checkHealth();
+    void resolve();
+    int nextDelayMs();
+
+public:
+    explicit ConnectionSupervisor(WebSocketClient& client);
+    ConnectionSupervisor(WebSocketClient& client, const Options& options);
+
+    ConnectionSupervisor(const ConnectionSupervisor&) = delete;
+    ConnectionSupervisor& operator=(const ConnectionSupervisor&) = delete;
+
+    void setCallbacks(const Callbacks& supervisorCallbacks) { callbacks = supervisorCallbacks; }
+
+    // Connects to 'url' and keeps reconnecting until stop()
+    void start(const QUrl& url);
+    // Disconnects on purpose; no outage is reported
+    void stop();
+
+    bool isRunning() const { return running; }
+    bool isOutage() const { return outage; }
+    quint64 reconnectCount() const { return reconnects; }
+    quint64 staleCount() const { return staleAborts; }
+    const QList<QHostAddress>& resolvedAddresses() const { return addresses; }
+};
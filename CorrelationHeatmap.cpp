@@ -0,0 +1,69 @@
+#include "CorrelationHeatmap.h"
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+CorrelationHeatmap::CorrelationHeatmap(const CorrelationMatrix& matrix, const TickStore& store, QWidget* parent)
+    : QWidget(parent),
+    matrix(matrix),
+    tickStore(store),
+    paintedVersion(0),
+    darkTheme(true) {
+    setMinimumSize(160, 160);
+}
+
+void CorrelationHeatmap::refresh() {
+    if (matrix.changeCount() == paintedVersion || !isVisible())
+        return;
+    update();
+}
+
+void CorrelationHeatmap::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    paintedVersion = matrix.changeCount();
+
+    QPainter painter(this);
+    QColor background = darkTheme ? QColor(30, 30, 30) : QColor(255, 255, 255);
+    QColor text = darkTheme ? Qt::white : Qt::black;
+    painter.fillRect(rect(), background);
+
+    int n = static_cast<int>(std::min<size_t>(matrix.symbolCount(), tickStore.symbolCount()));
+    if (n == 0 || matrix.sampleCount() < 2) {
+        painter.setPen(text);
+        painter.drawText(rect(), Qt::AlignCenter, "Waiting for bars...");
+        return;
+    }
+
+    const int labelWidth = 60;
+    const int labelHeight = 16;
+    double cellW = std::max(1.0, (width() - labelWidth) / static_cast<double>(n));
+    double cellH = std::max(1.0, (height() - labelHeight) / static_cast<double>(n));
+    bool showValues = cellW >= 34 && cellH >= 14;
+
+    QFont font = painter.font();
+    font.setPointSizeF(std::clamp(cellH * 0.4, 6.0, 9.0));
+    painter.setFont(font);
+
+    for (int i = 0; i < n; ++i) {
+        painter.setPen(text);
+        painter.drawText(QRectF(0, labelHeight + i * cellH, labelWidth - 4, cellH),
+            Qt::AlignRight | Qt::AlignVCenter, tickStore.symbolName(i));
+        painter.drawText(QRectF(labelWidth + i * cellW, 0, cellW, labelHeight),
+            Qt::AlignCenter, tickStore.symbolName(i).left(showValues ? 6 : 1));
+
+        for (int j = 0; j < n; ++j) {
+            double c = matrix.correlation(i, j);
+            int strength = static_cast<int>(std::abs(c) * 200);
+            QColor colour = c >= 0
+                ? QColor(background.red() + (220 - background.red()) * strength / 200, background.green() * (200 - strength) / 200, background.blue() * (200 - strength) / 200)
+                : QColor(background.red() * (200 - strength) / 200, background.green() * (200 - strength) / 200, background.blue() + (230 - background.blue()) * strength / 200);
+
+            QRectF cell(labelWidth + j * cellW, labelHeight + i * cellH, cellW - 1, cellH - 1);
+            painter.fillRect(cell, colour);
+            if (showValues) {
+                painter.setPen(text);
+                painter.drawText(cell, Qt::AlignCenter, QString::number(c, 'f', 2));
+            }
+        }
+    }
+}
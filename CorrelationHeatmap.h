@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QWidget>
+#include "CorrelationMatrix.h"
+#include "TickStore.h"
+
+// Colour grid of a CorrelationMatrix: blue for -1, neutral for 0, red for +1.
+// refresh() repaints only when the matrix committed a new interval.
+class CorrelationHeatmap : public QWidget {
+private:
+    const CorrelationMatrix& matrix;
+    const TickStore& tickStore;
+    quint64 paintedVersion;
+    bool darkTheme;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+public:
+    CorrelationHeatmap(const CorrelationMatrix& matrix, const TickStore& store, QWidget* parent = nullptr);
+
+    void refresh();
+    void setDarkTheme(bool dark) { darkTheme = dark; update(); }
+};
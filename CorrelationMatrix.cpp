@@ -0,0 +1,156 @@
+#include "CorrelationMatrix.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LT_HAVE_SSE2 1
+#endif
+
+namespace {
+    // row[j] += a * x[j] - b * y[j] for j < n (n even)
+    void updateRow(double* row, double a, const double* x, double b, const double* y, size_t n) {
+#ifdef LT_HAVE_SSE2
+        __m128d va = _mm_set1_pd(a);
+        __m128d vb = _mm_set1_pd(b);
+        for (size_t j = 0; j < n; j += 2) {
+            __m128d r = _mm_loadu_pd(row + j);
+            r = _mm_add_pd(r, _mm_mul_pd(va, _mm_loadu_pd(x + j)));
+            r = _mm_sub_pd(r, _mm_mul_pd(vb, _mm_loadu_pd(y + j)));
+            _mm_storeu_pd(row + j, r);
+        }
+#else
+        for (size_t j = 0; j < n; ++j) {
+            row[j] += a * x[j] - b * y[j];
+        }
+#endif
+    }
+}
+
+CorrelationMatrix::CorrelationMatrix(size_t window)
+    : window(std::max<size_t>(window, 2)),
+    symbols(0),
+    stride(0),
+    head(0),
+    samples(0),
+    sinceRebuild(0),
+    pendingStart(-1),
+    committedStart(-1),
+    reportedCount(0),
+    version(0) {
+}
+
+void CorrelationMatrix::resize(size_t symbolCount) {
+    symbols = symbolCount;
+    stride = (symbolCount + 1) & ~static_cast<size_t>(1);
+
+    sums.assign(stride, 0.0);
+    coMoments.assign(symbols * stride, 0.0);
+    history.assign(window * stride, 0.0);
+    head = 0;
+    samples = 0;
+    sinceRebuild = 0;
+
+    lastClose.resize(symbols, 0.0);
+    pending.assign(stride, 0.0);
+    reported.assign(symbols, 0);
+    reportedCount = 0;
+    ++version;
+}
+
+void CorrelationMatrix::setSymbolCount(size_t count) {
+    if (count > symbols)
+        resize(count);
+}
+
+void CorrelationMatrix::clear() {
+    lastClose.assign(symbols, 0.0);
+    pendingStart = -1;
+    committedStart = -1;
+    resize(symbols);
+}
+
+void CorrelationMatrix::onBarClosed(int symbolId, const Bar& bar) {
+    if (symbolId < 0 || bar.close <= 0.0) return;
+    if (static_cast<size_t>(symbolId) >= symbols)
+        setSymbolCount(static_cast<size_t>(symbolId) + 1);
+
+    double previous = lastClose[symbolId];
+    lastClose[symbolId] = bar.close;
+
+    // Re-closed or late bars only move the reference price
+    if (bar.start <= committedStart)
+        return;
+
+    if (pendingStart >= 0 && bar.start > pendingStart)
+        commitPending();
+    if (pendingStart < 0)
+        pendingStart = bar.start;
+
+    if (previous > 0.0)
+        pending[symbolId] += std::log(bar.close / previous);
+    if (!reported[symbolId]) {
+        reported[symbolId] = 1;
+        ++reportedCount;
+    }
+
+    // Every symbol is in: no need to wait for the next interval
+    if (reportedCount == symbols)
+        commitPending();
+}
+
+void CorrelationMatrix::commitPending() {
+    if (pendingStart < 0) return;
+
+    double* outgoing = history.data() + head * stride;
+    addSample(pending.data(), outgoing);
+    std::copy(pending.begin(), pending.end(), outgoing);
+    head = (head + 1) % window;
+    samples = std::min(samples + 1, window);
+
+    committedStart = pendingStart;
+    pendingStart = -1;
+    std::fill(pending.begin(), pending.end(), 0.0);
+    std::fill(reported.begin(), reported.end(), 0);
+    reportedCount = 0;
+    ++version;
+}
+
+void CorrelationMatrix::addSample(const double* incoming, const double* outgoing) {
+    // The outgoing slot is all zeros until the ring has wrapped, so it can be
+    // subtracted unconditionally
+    for (size_t i = 0; i < symbols; ++i) {
+        sums[i] += incoming[i] - outgoing[i];
+        updateRow(coMoments.data() + i * stride, incoming[i], incoming, outgoing[i], outgoing, stride);
+    }
+
+    // Bound the rounding drift of the add/subtract pairs
+    if (++sinceRebuild >= window * 64)
+        rebuild();
+}
+
+void CorrelationMatrix::rebuild() {
+    std::fill(sums.begin(), sums.end(), 0.0);
+    std::fill(coMoments.begin(), coMoments.end(), 0.0);
+    for (size_t s = 0; s < window; ++s) {
+        const double* x = history.data() + s * stride;
+        for (size_t i = 0; i < symbols; ++i) {
+            sums[i] += x[i];
+            updateRow(coMoments.data() + i * stride, x[i], x, 0.0, x, stride);
+        }
+    }
+    sinceRebuild = 0;
+}
+
+double CorrelationMatrix::covariance(size_t i, size_t j) const {
+    if (samples < 2 || i >= symbols || j >= symbols) return 0.0;
+    double n = static_cast<double>(samples);
+    return (coMoments[i * stride + j] - sums[i] * sums[j] / n) / (n - 1.0);
+}
+
+double CorrelationMatrix::correlation(size_t i, size_t j) const {
+    double varI = covariance(i, i);
+    double varJ = covariance(j, j);
+    if (varI <= 0.0 || varJ <= 0.0) return 0.0;
+    return std::clamp(covariance(i, j) / std::sqrt(varI * varJ), -1.0, 1.0);
+}
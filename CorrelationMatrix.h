@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+#include "BarAggregator.h"
+
+// Rolling covariance/correlation of bar returns across all symbols.
+//
+// Closed bars are gathered into one return vector per bar interval (a symbol
+// without a bar in that interval contributes a zero return). Each completed
+// vector is added to running co-moment sums and the vector leaving the window
+// is subtracted, so the N x N matrix is updated in place in O(N^2) per
+// interval instead of being recomputed from the raw windows. The row updates
+// run over the symbol dimension with SSE2 where available.
+class CorrelationMatrix {
+private:
+    size_t window;          // intervals kept
+    size_t symbols;
+    size_t stride;          // row length, padded to a multiple of 2 doubles
+
+    std::vector<double> sums;          // per symbol
+    std::vector<double> coMoments;     // symbols x stride, sum of x_i * x_j
+    std::vector<double> history;       // window x stride ring of return vectors
+    size_t head;
+    size_t samples;
+    size_t sinceRebuild;
+
+    std::vector<double> lastClose;     // per symbol, 0 until the first bar
+    std::vector<double> pending;       // returns for the interval being assembled
+    std::vector<char> reported;
+    qint64 pendingStart;               // -1 when nothing is pending
+    qint64 committedStart;
+    size_t reportedCount;
+    quint64 version;
+
+    void resize(size_t symbolCount);
+    void commitPending();
+    void addSample(const double* incoming, const double* outgoing);
+    void rebuild();
+
+public:
+    explicit CorrelationMatrix(size_t window = 120);
+
+    // Feed from BarAggregator's bar-closed callback
+    void onBarClosed(int symbolId, const Bar& bar);
+
+    // Grows the matrix; existing history is dropped because old vectors lack the new symbols
+    void setSymbolCount(size_t count);
+    void clear();
+
+    size_t symbolCount() const { return symbols; }
+    size_t sampleCount() const { return samples; }
+    size_t windowSize() const { return window; }
+    quint64 changeCount() const { return version; }   // bumped per committed interval
+
+    double covariance(size_t i, size_t j) const;
+    double correlation(size_t i, size_t j) const;
+};
@@ -0,0 +1,191 @@
+#include "DepthHeatmap.h"
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+DepthHeatmap::DepthHeatmap(QWidget* parent, int columns, int rows)
+    : QWidget(parent),
+    book(nullptr),
+    image(std::max(columns, 2), std::max(rows, 2), QImage::Format_RGB32),
+    writeColumn(0),
+    rowStep(0.0),
+    topPrice(0.0),
+    maxVolume(0.0),
+    darkTheme(true)
+{
+    columnVolume.resize(image.height());
+    buildPalette();
+    image.fill(palette[0]);
+    setMinimumWidth(160);
+
+    // One new column per interval; history is never repainted
+    columnTimer.setInterval(250);
+    connect(&columnTimer, &QTimer::timeout, this, [this]() {
+        paintColumn();
+        update();
+    });
+    columnTimer.start();
+}
+
+void DepthHeatmap::buildPalette() {
+    palette[0] = darkTheme ? qRgb(30, 30, 30) : qRgb(255, 255, 255);
+
+    // Dark blue -> cyan -> yellow -> white
+    for (int i = 1; i < 256; ++i) {
+        double t = (i - 1) / 254.0;
+        int r, g, b;
+        if (t < 1.0 / 3.0) {
+            double u = t * 3.0;
+            r = 0; g = static_cast<int>(40 + 160 * u); b = static_cast<int>(90 + 130 * u);
+        }
+        else if (t < 2.0 / 3.0) {
+            double u = (t - 1.0 / 3.0) * 3.0;
+            r = static_cast<int>(255 * u); g = static_cast<int>(200 + 55 * u); b = static_cast<int>(220 * (1.0 - u));
+        }
+        else {
+            double u = (t - 2.0 / 3.0) * 3.0;
+            r = 255; g = 255; b = static_cast<int>(255 * u);
+        }
+        palette[i] = qRgb(r, g, b);
+    }
+}
+
+void DepthHeatmap::setBook(const OrderBook* orderBook) {
+    book = orderBook;
+    clear();
+}
+
+void DepthHeatmap::setDarkTheme(bool dark) {
+    darkTheme = dark;
+    buildPalette();
+    clear();
+}
+
+void DepthHeatmap::clear() {
+    image.fill(palette[0]);
+    writeColumn = 0;
+    rowStep = 0.0;
+    maxVolume = 0.0;
+    update();
+}
+
+int DepthHeatmap::rowFor(double price) const {
+    return static_cast<int>(std::floor((topPrice - price) / rowStep));
+}
+
+void DepthHeatmap::resetWindow() {
+    // Size rows so the visible book depth spans about half the image
+    double low = book->toPrice(book->bid(book->bidCount() - 1).price);
+    double high = book->toPrice(book->ask(book->askCount() - 1).price);
+    double span = high - low;
+    double mid = (book->bestBid() + book->bestAsk()) / 2.0;
+
+    rowStep = span > 0.0 ? span * 2.0 / image.height() : mid * 1e-5;
+    topPrice = mid + rowStep * image.height() / 2.0;
+}
+
+void DepthHeatmap::scrollRows(int rows) {
+    // Moves the history up by `rows` (down if negative) and blanks what was exposed
+    int height = image.height();
+    qsizetype lineBytes = image.bytesPerLine();
+    uchar* bits = image.bits();
+
+    if (std::abs(rows) >= height) {
+        image.fill(palette[0]);
+        return;
+    }
+
+    if (rows > 0)
+        std::memmove(bits, bits + rows * lineBytes, (height - rows) * lineBytes);
+    else
+        std::memmove(bits - rows * lineBytes, bits, (height + rows) * lineBytes);
+
+    int firstBlank = rows > 0 ? height - rows : 0;
+    int blankCount = std::abs(rows);
+    for (int r = firstBlank; r < firstBlank + blankCount; ++r) {
+        std::fill_n(reinterpret_cast<QRgb*>(image.scanLine(r)), image.width(), palette[0]);
+    }
+}
+
+void DepthHeatmap::paintColumn() {
+    int height = image.height();
+    writeColumn = (writeColumn + 1) % image.width();
+
+    if (!book || !book->isSynced() || !book->hasTopOfBook()) {
+        for (int r = 0; r < height; ++r) {
+            reinterpret_cast<QRgb*>(image.scanLine(r))[writeColumn] = palette[0];
+        }
+        return;
+    }
+
+    if (rowStep <= 0.0)
+        resetWindow();
+
+    // Recentre by whole rows once the mid leaves the middle band
+    double mid = (book->bestBid() + book->bestAsk()) / 2.0;
+    int midRow = rowFor(mid);
+    if (midRow < height / 5 || midRow > height * 4 / 5) {
+        int shift = midRow - height / 2;
+        scrollRows(shift);
+        topPrice -= shift * rowStep;
+    }
+
+    // Resting size per row; several levels can land in one row
+    std::fill(columnVolume.begin(), columnVolume.end(), 0.0);
+    double columnMax = 0.0;
+    auto accumulate = [&](const BookLevel& level) {
+        int row = rowFor(book->toPrice(level.price));
+        if (row < 0 || row >= height) return;
+        columnVolume[row] += book->toVolume(level.volume);
+        columnMax = std::max(columnMax, columnVolume[row]);
+    };
+    for (size_t i = 0; i < book->bidCount(); ++i) accumulate(book->bid(i));
+    for (size_t i = 0; i < book->askCount(); ++i) accumulate(book->ask(i));
+
+    // Slowly decaying scale keeps colours comparable across neighbouring columns
+    maxVolume = std::max(maxVolume * 0.995, columnMax);
+
+    for (int r = 0; r < height; ++r) {
+        double volume = columnVolume[r];
+        int index = 0;
+        if (volume > 0.0 && maxVolume > 0.0)
+            index = 1 + static_cast<int>(254.0 * std::sqrt(std::min(volume / maxVolume, 1.0)));
+        reinterpret_cast<QRgb*>(image.scanLine(r))[writeColumn] = palette[index];
+    }
+
+    // Best bid/ask trace
+    int bidRow = rowFor(book->bestBid());
+    int askRow = rowFor(book->bestAsk());
+    if (bidRow >= 0 && bidRow < height)
+        reinterpret_cast<QRgb*>(image.scanLine(bidRow))[writeColumn] = qRgb(0, 200, 0);
+    if (askRow >= 0 && askRow < height)
+        reinterpret_cast<QRgb*>(image.scanLine(askRow))[writeColumn] = qRgb(220, 0, 0);
+}
+
+void DepthHeatmap::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    QPainter painter(this);
+
+    // The ring's oldest columns start right after the write cursor
+    const QImage& ring = image;
+    int columns = ring.width();
+    int oldCount = columns - 1 - writeColumn;
+    double split = static_cast<double>(width()) * oldCount / columns;
+
+    if (oldCount > 0) {
+        painter.drawImage(QRectF(0, 0, split, height()), ring,
+            QRectF(writeColumn + 1, 0, oldCount, ring.height()));
+    }
+    painter.drawImage(QRectF(split, 0, width() - split, height()), ring,
+        QRectF(0, 0, writeColumn + 1, ring.height()));
+
+    if (rowStep > 0.0) {
+        painter.setPen(darkTheme ? Qt::white : Qt::black);
+        double bottomPrice = topPrice - rowStep * ring.height();
+        painter.drawText(rect().adjusted(4, 2, -4, -2), Qt::AlignTop | Qt::AlignRight,
+            QString::number(topPrice, 'f', 2));
+        painter.drawText(rect().adjusted(4, 2, -4, -2), Qt::AlignBottom | Qt::AlignRight,
+            QString::number(bottomPrice, 'f', 2));
+    }
+}
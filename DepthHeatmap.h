@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QImage>
+#include <QTimer>
+#include <QWidget>
+#include <array>
+#include <vector>
+#include "OrderBook.h"
+
+// Order book liquidity heatmap: time on X, price on Y, resting size as colour.
+//
+// The history lives in one persistent QImage used as a ring of columns. Every
+// interval the write cursor advances and only that one column is painted from
+// the current book; paintEvent blits the two halves of the ring oldest-first,
+// so no pixel of history is ever recomputed. The price window recentres by
+// whole rows when the mid drifts out of its middle band.
+class DepthHeatmap : public QWidget {
+private:
+    const OrderBook* book;
+    QImage image;
+    QTimer columnTimer;
+    int writeColumn;            // column holding the newest sample
+
+    double rowStep;             // price per pixel row, 0 until the first synced book
+    double topPrice;            // price at row 0
+    double maxVolume;           // decaying colour scale
+    bool darkTheme;
+
+    std::vector<double> columnVolume;   // scratch, one entry per row
+    std::array<QRgb, 256> palette;
+
+    void buildPalette();
+    void resetWindow();
+    void scrollRows(int rows);
+    void paintColumn();
+    int rowFor(double price) const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+public:
+    explicit DepthHeatmap(QWidget* parent = nullptr, int columns = 600, int rows = 300);
+
+    // Book to sample; may be null. Switching books clears the history.
+    void setBook(const OrderBook* orderBook);
+    void setColumnInterval(int ms) { columnTimer.setInterval(ms); }
+    void setDarkTheme(bool dark);
+    void clear();
+};
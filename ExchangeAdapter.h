@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <concepts>
+#include "KrakenMessageParser.h"
+
+// Parsed frame shared by every venue: trades, book updates, quotes and events
+using FeedMessage = KrakenMessageParser::Message;
+using FeedMessageType = KrakenMessageParser::MessageType;
+
+enum class Exchange {
+    KrakenV1,
+    KrakenV2
+};
+
+// A venue's answer to a subscribe or unsubscribe request
+struct SubscriptionStatus {
+    enum class Kind {
+        Subscribed,
+        Unsubscribed,
+        Error
+    };
+
+    Kind kind = Kind::Error;
+    QString pair;           // venue pair name; empty if the venue did not say
+    QString channelName;    // "trade", "book-10", ...
+    int channelId = -1;     // -1 on venues without channel ids
+    QString errorMessage;
+};
+
+// An exchange adapter is a policy type: a struct of static functions that
+// carries one venue's wire format. Ingest loops are templates on the policy,
+// so parsing a frame is a direct (usually inlined) call - there is no virtual
+// dispatch or function pointer per message. A venue is added by writing one
+// such struct and listing it in Exchanges.h; nothing in the ingest code forks.
+//
+//   Id, Name, DefaultUrl                 identification and default endpoint
+//   toVenueSymbol / fromVenueSymbol      "BTCUSD" <-> the venue's pair name
+//   subscriptionRequest                  one (un)subscribe message for many pairs
+//                                        and one channel ({"name":"book","depth":10})
+//   parse                                one raw frame into a FeedMessage
+//   parseSubscriptionStatus              an Event message's object into a
+//                                        SubscriptionStatus; false if it is not one
+//   appendTradeFrame                     one trade frame in the venue's format,
+//                                        for synthetic sessions and fixtures
+template <class A>
+concept ExchangeAdapter = requires(const QByteArray& frame, FeedMessage& message, const QString& symbol,
+    const QJsonArray& symbols, const QJsonObject& channel, QByteArray& out, const TickRecord& trade,
+    SubscriptionStatus& status) {
+    { A::Id } -> std::convertible_to<Exchange>;
+    { A::Name } -> std::convertible_to<const char*>;
+    { A::DefaultUrl } -> std::convertible_to<const char*>;
+    { A::toVenueSymbol(symbol) } -> std::same_as<QString>;
+    { A::fromVenueSymbol(symbol) } -> std::same_as<QString>;
+    { A::subscriptionRequest(true, symbols, channel) } -> std::same_as<QString>;
+    { A::parse(frame, message) } -> std::same_as<bool>;
+    { A::parseSubscriptionStatus(channel, status) } -> std::same_as<bool>;
+    A::appendTradeFrame(out, 0, symbol, trade);
+};
+
+// The subscription side of an adapter, for SubscriptionManager. Subscribing is
+// rare, so it goes through plain function pointers instead of making the
+// manager (and everything that owns one) a template.
+struct SubscriptionFormat {
+    QString (*toVenueSymbol)(const QString& uiSymbol) = nullptr;
+    QString (*subscriptionRequest)(bool subscribe, const QJsonArray& venueSymbols, const QJsonObject& channel) = nullptr;
+    bool (*parseSubscriptionStatus)(const QJsonObject& event, SubscriptionStatus& status) = nullptr;
+
+    template <ExchangeAdapter A>
+    static SubscriptionFormat of() {
+        return { &A::toVenueSymbol, &A::subscriptionRequest, &A::parseSubscriptionStatus };
+    }
+};
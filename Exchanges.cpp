@@ -0,0 +1,35 @@
+#include "Exchanges.h"
+
+namespace {
+    constexpr Exchange AllExchanges[] = { Exchange::KrakenV1, Exchange::KrakenV2 };
+}
+
+bool Exchanges::fromName(const QString& name, Exchange& exchange) {
+    for (Exchange candidate : AllExchanges) {
+        if (name.compare(QLatin1String(Exchanges::name(candidate)), Qt::CaseInsensitive) == 0) {
+            exchange = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* Exchanges::name(Exchange exchange) {
+    return withExchange(exchange, []<ExchangeAdapter Adapter>() { return Adapter::Name; });
+}
+
+const char* Exchanges::defaultUrl(Exchange exchange) {
+    return withExchange(exchange, []<ExchangeAdapter Adapter>() { return Adapter::DefaultUrl; });
+}
+
+QStringList Exchanges::names() {
+    QStringList list;
+    for (Exchange exchange : AllExchanges) {
+        list.append(QLatin1String(name(exchange)));
+    }
+    return list;
+}
+
+SubscriptionFormat Exchanges::subscriptionFormat(Exchange exchange) {
+    return withExchange(exchange, []<ExchangeAdapter Adapter>() { return SubscriptionFormat::of<Adapter>(); });
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <utility>
+#include "ExchangeAdapter.h"
+#include "KrakenAdapters.h"
+
+// Every adapter the application knows, and the one place a runtime venue
+// choice (a command-line option, an environment variable) becomes a
+// compile-time policy. withExchange() calls 'f.template operator()<Adapter>()',
+// usually a generic lambda, so the code inside is instantiated once per venue:
+//
+//   withExchange(exchange, [&]<ExchangeAdapter Adapter>() { runIngest<Adapter>(); });
+template <class F>
+decltype(auto) withExchange(Exchange exchange, F&& f) {
+    switch (exchange) {
+    case Exchange::KrakenV2:
+        return std::forward<F>(f).template operator()<KrakenV2>();
+    case Exchange::KrakenV1:
+    default:
+        return std::forward<F>(f).template operator()<KrakenV1>();
+    }
+}
+
+namespace Exchanges {
+    // "kraken-v1", "kraken-v2"; false for an unknown name
+    bool fromName(const QString& name, Exchange& exchange);
+    const char* name(Exchange exchange);
+    const char* defaultUrl(Exchange exchange);
+    QStringList names();
+    SubscriptionFormat subscriptionFormat(Exchange exchange);
+}
@@ -0,0 +1,107 @@
+#include "FeedArbiter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+size_t FeedArbiter::TradeKeyHash::operator()(const TradeKey& key) const {
+    quint64 price;
+    quint64 volume;
+    std::memcpy(&price, &key.price, sizeof(price));
+    std::memcpy(&volume, &key.volume, sizeof(volume));
+
+    // 64-bit multiply-xorshift mix; the fields are already well spread
+    quint64 h = static_cast<quint64>(key.timestamp) * 0x9E3779B97F4A7C15ull;
+    h ^= price + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    h ^= volume + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    h ^= (static_cast<quint64>(key.symbolId) << 8) | static_cast<quint8>(key.side);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+FeedArbiter::FeedArbiter(int connections, int windowMs)
+    : connections(std::clamp(connections, 1, MaxConnections)),
+    windowNs(static_cast<qint64>(std::max(windowMs, 1)) * 1000000),
+    stats(static_cast<size_t>(this->connections)) {
+}
+
+qint64 FeedArbiter::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FeedArbiter::expire(qint64 nowNs) {
+    while (!expiry.empty() && nowNs - expiry.front().arrivalNs > windowNs) {
+        const TradeKey key = expiry.front().key;
+        expiry.pop_front();
+
+        auto it = entries.find(key);
+        if (it == entries.end())
+            continue;
+        // A later occurrence of the same key keeps it alive for another window
+        const Occurrence& latest = it->second.forwarded.back();
+        if (nowNs - latest.arrivalNs <= windowNs) {
+            expiry.push_back({ latest.arrivalNs, key });
+            continue;
+        }
+
+        if (it->second.copies == 1 && connections > 1)
+            ++stats[latest.winner].solo;
+        if (forgottenThrough.size() <= static_cast<size_t>(key.symbolId))
+            forgottenThrough.resize(key.symbolId + 1, 0);
+        forgottenThrough[key.symbolId] = std::max(forgottenThrough[key.symbolId], key.timestamp);
+        entries.erase(it);
+    }
+}
+
+void FeedArbiter::offer(int connection, int symbolId, const std::vector<TickRecord>& trades) {
+    if (connection < 0 || connection >= connections || trades.empty())
+        return;
+
+    const qint64 now = nowNs();
+    expire(now);
+
+    ConnectionStats& own = stats[connection];
+    const qint64 forgotten = static_cast<size_t>(symbolId) < forgottenThrough.size() ? forgottenThrough[symbolId] : 0;
+    forward.clear();
+
+    for (const TickRecord& trade : trades) {
+        ++own.trades;
+        const TradeKey key{ trade.timestamp, trade.price, trade.volume, symbolId, trade.side };
+
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            if (trade.timestamp <= forgotten) {
+                ++own.stale;
+                continue;
+            }
+            it = entries.emplace(key, Entry()).first;
+            expiry.push_back({ now, key });
+        }
+
+        Entry& entry = it->second;
+        const quint16 occurrence = ++entry.seen[connection];
+        if (occurrence == 1)
+            ++entry.copies;
+
+        if (occurrence > entry.forwarded.size()) {
+            entry.forwarded.append({ now, static_cast<quint8>(connection) });
+            ++own.first;
+            forward.push_back(trade);
+        } else {
+            // Measured against the winning copy of this same occurrence
+            const Occurrence& won = entry.forwarded[occurrence - 1];
+            const double micros = (now - won.arrivalNs) / 1000.0;
+            ++own.late;
+            own.lagMicros.add(micros);
+            stats[won.winner].leadMicros.add(micros);
+        }
+    }
+
+    if (forward.empty())
+        return;
+    forwardedCount += forward.size();
+    if (consumer)
+        consumer(symbolId, forward);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QVarLengthArray>
+#include <QtGlobal>
+#include <array>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "MarketTick.h"
+#include "QuantileSketch.h"
+
+// First-arrival arbitration across redundant feed connections. Every
+// connection is subscribed to the same pairs, so each trade normally arrives
+// once per connection; the arbiter forwards whichever copy comes first and
+// drops the rest, which cuts tail latency and lets a stalled connection fall
+// behind without a gap downstream.
+//
+// Kraken v1 trades carry no trade id, so a trade is identified by symbol,
+// timestamp, price, volume and side. Distinct fills can share all five (one
+// taker order sweeping equal resting orders), so identity also includes the
+// occurrence count: the n-th copy of a key on one connection matches the
+// n-th copy on another. Keys are remembered for 'windowMs' after their last
+// forwarded occurrence; a copy no newer than anything already forgotten is
+// dropped as stale, so a stalled connection catching up never re-forwards a
+// trade whose key has expired.
+//
+// Per connection the arbiter counts first arrivals, late copies and trades
+// only it delivered, and keeps sketches of how far its late copies trailed
+// the winning copy of the same occurrence and how far its wins led the copies
+// that followed.
+class FeedArbiter {
+public:
+    static constexpr int MaxConnections = 8;
+
+    using TradeConsumer = std::function<void(int symbolId, const std::vector<TickRecord>& trades)>;
+
+    struct ConnectionStats {
+        quint64 trades = 0;       // trades received on this connection
+        quint64 first = 0;        // copies forwarded because this connection won
+        quint64 late = 0;         // copies dropped because another connection won
+        quint64 solo = 0;         // forwarded trades no other connection delivered within the window
+        quint64 stale = 0;        // copies arriving after their key was forgotten
+        TDigest lagMicros;        // late copies: time behind the winning copy
+        TDigest leadMicros;       // wins: time ahead of each later copy
+    };
+
+private:
+    struct TradeKey {
+        qint64 timestamp;
+        double price;
+        double volume;
+        int symbolId;
+        char side;
+
+        bool operator==(const TradeKey& other) const {
+            return timestamp == other.timestamp && price == other.price && volume == other.volume
+                && symbolId == other.symbolId && side == other.side;
+        }
+    };
+
+    struct TradeKeyHash {
+        size_t operator()(const TradeKey& key) const;
+    };
+
+    // First arrival of one occurrence of a key
+    struct Occurrence {
+        qint64 arrivalNs;
+        quint8 winner;                              // connection that delivered it
+    };
+
+    struct Entry {
+        QVarLengthArray<Occurrence, 2> forwarded;   // occurrences forwarded so far, in order
+        quint8 copies = 0;                          // connections that delivered the key
+        std::array<quint16, MaxConnections> seen{}; // occurrences seen per connection
+    };
+
+    struct Expiry {
+        qint64 arrivalNs;
+        TradeKey key;
+    };
+
+    int connections;
+    qint64 windowNs;
+    TradeConsumer consumer;
+
+    std::unordered_map<TradeKey, Entry, TradeKeyHash> entries;
+    std::deque<Expiry> expiry;                  // one per key, in first-arrival order
+    std::vector<qint64> forgottenThrough;       // per symbol: newest timestamp already expired
+    std::vector<ConnectionStats> stats;
+    std::vector<TickRecord> forward;            // scratch for one offer()
+    quint64 forwardedCount = 0;
+
+    void expire(qint64 nowNs);
+
+public:
+    explicit FeedArbiter(int connections, int windowMs = 10000);
+
+    void setTradeConsumer(TradeConsumer tradeConsumer) { consumer = std::move(tradeConsumer); }
+
+    // Trades from one frame on one connection; the first copies are passed on
+    // to the consumer in one call, in frame order
+    void offer(int connection, int symbolId, const std::vector<TickRecord>& trades);
+
+    int connectionCount() const { return connections; }
+    ConnectionStats& connectionStats(int connection) { return stats[connection]; }
+    quint64 forwardedTrades() const { return forwardedCount; }
+    size_t trackedKeys() const { return entries.size(); }
+
+    // Steady clock used for arrival times
+    static qint64 nowNs();
+};
@@ -0,0 +1,261 @@
+#include "HeadlessBacktest.h"
+#include "KrakenMessageParser.h"
+#include "WorkStealingPool.h"
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimeZone>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+
+namespace {
+    // Milliseconds since epoch or an ISO 8601 date/time (UTC unless it carries an offset)
+    bool parseTime(const QString& value, qint64& ms) {
+        bool ok = false;
+        ms = value.toLongLong(&ok);
+        if (ok) return true;
+
+        QDateTime time = QDateTime::fromString(value, Qt::ISODate);
+        if (!time.isValid()) return false;
+        if (time.timeSpec() == Qt::LocalTime)
+            time.setTimeZone(QTimeZone::UTC);
+        ms = time.toMSecsSinceEpoch();
+        return true;
+    }
+}
+
+bool BacktestOptions::parse(const QStringList& arguments, BacktestOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "backtest", "Run a backtest parameter sweep." });
+    parser.addOption({ "journal", "Tick journal to replay (synthetic ticks if omitted).", "file" });
+    parser.addOption({ "db", "Tick database directory to replay instead of a journal.", "dir" });
+    parser.addOption({ "symbols", "Comma separated symbols to keep from the journal.", "list" });
+    parser.addOption({ "from", "Start time, ms since epoch or ISO 8601.", "time" });
+    parser.addOption({ "to", "End time (exclusive), ms since epoch or ISO 8601.", "time" });
+    parser.addOption({ "ticks", "Synthetic tick count.", "n" });
+    parser.addOption({ "strategy", "Strategy: " + Backtester::builtinStrategyNames().join(", ") + ".", "name" });
+    parser.addOption({ "param", "Swept parameter, name=v1,v2 or name=start:stop:step. Repeatable.", "spec" });
+    parser.addOption({ "latency", "Order latency in ms.", "ms" });
+    parser.addOption({ "fee-bps", "Fee per fill in basis points.", "bps" });
+    parser.addOption({ "slippage-bps", "Market order slippage when no quote is known.", "bps" });
+    parser.addOption({ "fill-on-touch", "Fill resting limits when a trade touches the price." });
+    parser.addOption({ "threads", "Worker threads (default: one per core).", "n" });
+    parser.addOption({ "top", "Number of ranked runs to print.", "n" });
+    parser.addOption({ "report", "Write every run to this JSON file.", "file" });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("journal")) options.journalFile = parser.value("journal");
+    if (parser.isSet("db")) options.databaseDirectory = parser.value("db");
+    if (parser.isSet("symbols")) {
+        for (const QString& symbol : parser.value("symbols").split(',', Qt::SkipEmptyParts)) {
+            options.symbols.append(KrakenMessageParser::normalizeSymbol(symbol.trimmed()));
+        }
+    }
+    if (parser.isSet("from") && !parseTime(parser.value("from"), options.fromMs)) {
+        if (error) *error = "Invalid --from";
+        return false;
+    }
+    if (parser.isSet("to") && !parseTime(parser.value("to"), options.toMs)) {
+        if (error) *error = "Invalid --to";
+        return false;
+    }
+    if (parser.isSet("ticks")) options.syntheticTicks = std::max(1, parser.value("ticks").toInt());
+    if (parser.isSet("strategy")) options.strategy = parser.value("strategy");
+    for (const QString& spec : parser.values("param")) {
+        if (!options.grid.addSpec(spec, error))
+            return false;
+    }
+    if (parser.isSet("latency")) options.fillModel.latencyMs = parser.value("latency").toLongLong();
+    if (parser.isSet("fee-bps")) options.fillModel.feeBps = parser.value("fee-bps").toDouble();
+    if (parser.isSet("slippage-bps")) options.fillModel.slippageBps = parser.value("slippage-bps").toDouble();
+    if (parser.isSet("fill-on-touch")) options.fillModel.limitFillOnTouch = true;
+    if (parser.isSet("threads")) options.threads = std::max(0, parser.value("threads").toInt());
+    if (parser.isSet("top")) options.top = std::max(1, parser.value("top").toInt());
+    if (parser.isSet("report")) options.reportFile = parser.value("report");
+
+    if (!Backtester::builtinStrategy(options.strategy)) {
+        if (error) *error = QString("Unknown --strategy '%1' (available: %2)")
+            .arg(options.strategy, Backtester::builtinStrategyNames().join(", "));
+        return false;
+    }
+    return true;
+}
+
+HeadlessBacktest::HeadlessBacktest(const BacktestOptions& options)
+    : options(options) {
+}
+
+QString HeadlessBacktest::sourceName() const {
+    if (!options.databaseDirectory.isEmpty()) return options.databaseDirectory;
+    if (!options.journalFile.isEmpty()) return options.journalFile;
+    return "synthetic";
+}
+
+bool HeadlessBacktest::loadData() {
+    QString error;
+    bool loaded;
+    if (!options.databaseDirectory.isEmpty()) {
+        WorkStealingPool pool(static_cast<size_t>(options.threads));
+        loaded = ReplayData::loadDatabase(options.databaseDirectory, data, options.symbols, options.fromMs, options.toMs, &error, &pool);
+    }
+    else {
+        loaded = ReplayData::loadJournal(options.journalFile, data, options.symbols, options.fromMs, options.toMs, &error);
+    }
+    if (!loaded) {
+        std::cerr << error.toStdString() << std::endl;
+        return false;
+    }
+    if (data.empty()) {
+        std::cerr << "No ticks in " << sourceName().toStdString() << " for the selected symbols and time range" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void HeadlessBacktest::generateSyntheticData() {
+    // Fixed seed: every run of the same command sees the same ticks
+    QStringList symbols = options.symbols.isEmpty() ? QStringList{ "BTCUSD", "ETHUSD" } : options.symbols;
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 2e-4);
+    std::uniform_real_distribution<double> size(0.001, 0.5);
+
+    std::vector<int> ids;
+    std::vector<double> prices;
+    for (const QString& symbol : symbols) {
+        ids.push_back(data.symbolId(symbol));
+        prices.push_back(ids.size() == 1 ? 30000.0 : 2000.0);
+    }
+
+    data.reserve(options.syntheticTicks);
+    qint64 timestamp = options.fromMs > 0 ? options.fromMs : QDateTime::currentMSecsSinceEpoch() - options.syntheticTicks * 100LL;
+    for (int i = 0; i < options.syntheticTicks; ++i) {
+        size_t s = i % ids.size();
+        prices[s] *= 1.0 + step(rng);
+
+        TickRecord tick;
+        tick.timestamp = timestamp + i * 100LL;
+        tick.price = prices[s];
+        tick.volume = size(rng);
+        tick.bid = prices[s] * (1.0 - 1e-4);
+        tick.ask = prices[s] * (1.0 + 1e-4);
+        tick.side = i % 2 ? 'b' : 's';
+        data.append(ids[s], tick);
+    }
+    data.finalize();
+}
+
+int HeadlessBacktest::run() {
+    auto loadStart = std::chrono::steady_clock::now();
+    if (!options.journalFile.isEmpty() || !options.databaseDirectory.isEmpty()) {
+        if (!loadData())
+            return 1;
+    }
+    else {
+        generateSyntheticData();
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+    const std::vector<ReplayData::Event>& stream = data.stream();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "=== Lightning Trade backtest ===" << std::endl;
+    std::cout << "Source:      " << sourceName().toStdString()
+        << " (" << data.symbolList().join(',').toStdString() << ")" << std::endl;
+    std::cout << "Ticks:       " << data.size() << " from "
+        << QDateTime::fromMSecsSinceEpoch(stream.front().tick.timestamp, QTimeZone::UTC).toString(Qt::ISODate).toStdString() << " to "
+        << QDateTime::fromMSecsSinceEpoch(stream.back().tick.timestamp, QTimeZone::UTC).toString(Qt::ISODate).toStdString()
+        << " (loaded in " << loadSeconds << " s)" << std::endl;
+
+    WorkStealingPool pool(static_cast<size_t>(options.threads));
+    const size_t total = options.grid.size();
+    std::cout << "Strategy:    " << options.strategy.toStdString() << ", " << total << " runs on "
+        << pool.threadCount() << " threads" << std::endl;
+
+    // Progress at every 10% of runs; written from worker threads
+    std::mutex progressMutex;
+    size_t reportedStep = 0;
+    auto progress = [&](size_t done, size_t all) {
+        size_t step = done * 10 / all;
+        std::lock_guard<std::mutex> lock(progressMutex);
+        if (step > reportedStep) {
+            reportedStep = step;
+            std::cerr << "  " << done << "/" << all << " runs" << std::endl;
+        }
+    };
+
+    auto sweepStart = std::chrono::steady_clock::now();
+    std::vector<BacktestResult> results = Backtester::sweep(data, Backtester::builtinStrategy(options.strategy),
+        options.grid, options.fillModel, pool, progress);
+    double sweepSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count();
+
+    std::vector<const BacktestResult*> ranked;
+    for (const BacktestResult& result : results) {
+        ranked.push_back(&result);
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const BacktestResult* a, const BacktestResult* b) { return a->pnl > b->pnl; });
+
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(36) << "parameters" << std::right
+        << std::setw(13) << "pnl" << std::setw(11) << "fees" << std::setw(12) << "max dd"
+        << std::setw(9) << "sharpe" << std::setw(9) << "fills" << std::setw(7) << "win%"
+        << std::setw(10) << "sf bps" << std::setw(10) << "sf p95" << std::setw(10) << "delay ms" << std::endl;
+    for (size_t i = 0; i < ranked.size() && i < static_cast<size_t>(options.top); ++i) {
+        const BacktestResult& r = *ranked[i];
+        QString parameters = r.parameters.toString();
+        std::cout << std::left << std::setw(36) << (parameters.isEmpty() ? "(defaults)" : parameters.toStdString()) << std::right
+            << std::setw(13) << r.pnl << std::setw(11) << r.fees << std::setw(12) << r.maxDrawdown
+            << std::setw(9) << r.sharpe << std::setw(9) << r.fills << std::setw(7) << r.winRate * 100.0
+            << std::setw(10) << r.meanShortfallBps << std::setw(10) << r.p95ShortfallBps
+            << std::setw(10) << r.meanFillDelayMs << std::endl;
+    }
+
+    double replayed = static_cast<double>(data.size()) * total;
+    std::cout << std::endl;
+    std::cout << "Sweep:       " << sweepSeconds << " s, " << (sweepSeconds > 0 ? replayed / sweepSeconds / 1e6 : 0.0)
+        << "M ticks/s across runs, " << pool.stolenCount() << " runs stolen" << std::endl;
+
+    if (!options.reportFile.isEmpty()) {
+        QJsonArray runs;
+        for (const BacktestResult& r : results) {
+            QJsonObject parameters;
+            for (const auto& entry : r.parameters.entries()) {
+                parameters.insert(entry.first, entry.second);
+            }
+            runs.append(QJsonObject{
+                {"parameters", parameters},
+                {"pnl", r.pnl}, {"realized_pnl", r.realizedPnl}, {"fees", r.fees},
+                {"turnover", r.turnover}, {"max_drawdown", r.maxDrawdown}, {"sharpe", r.sharpe},
+                {"win_rate", r.winRate}, {"orders", static_cast<qint64>(r.orders)},
+                {"fills", static_cast<qint64>(r.fills)}, {"cancelled", static_cast<qint64>(r.cancelled)},
+                {"round_trips", static_cast<qint64>(r.roundTrips)},
+                {"shortfall_bps_mean", r.meanShortfallBps}, {"shortfall_bps_p95", r.p95ShortfallBps},
+                {"fill_delay_ms_mean", r.meanFillDelayMs}, {"elapsed_s", r.elapsedSeconds}
+                });
+        }
+        QJsonObject report{
+            {"strategy", options.strategy},
+            {"source", sourceName()},
+            {"ticks", static_cast<qint64>(data.size())},
+            {"sweep_s", sweepSeconds},
+            {"runs", runs}
+        };
+        QFile file(options.reportFile);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(QJsonDocument(report).toJson());
+        }
+        else {
+            std::cerr << "Cannot write report: " << options.reportFile.toStdString() << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include "Backtester.h"
+
+struct BacktestOptions {
+    QString journalFile;              // TickJournal to replay
+    QString databaseDirectory;        // or a TickDatabase; neither = synthetic ticks
+    QStringList symbols;              // empty = every symbol in the journal
+    qint64 fromMs = 0;
+    qint64 toMs = 0;                  // 0 = to the end
+    int syntheticTicks = 1000000;
+    QString strategy{ "ema-cross" };
+    ParameterGrid grid;
+    FillModel fillModel;
+    int threads = 0;                  // 0 = one per core
+    int top = 20;                     // result rows printed
+    QString reportFile;               // optional JSON report with every run
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, BacktestOptions& options, QString* error);
+};
+
+// Loads the replay once, sweeps the parameter grid across a work-stealing
+// pool and prints the runs ranked by PnL. Needs only a QCoreApplication.
+class HeadlessBacktest {
+private:
+    BacktestOptions options;
+    ReplayData data;
+
+    bool loadData();
+    QString sourceName() const;
+    void generateSyntheticData();
+
+public:
+    explicit HeadlessBacktest(const BacktestOptions& options);
+
+    int run();
+};
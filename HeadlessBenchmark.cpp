@@ -0,0 +1,321 @@
+#include "HeadlessBenchmark.h"
+#include "AllocationCounter.h"
+#include "ChartManager.h"
+#include "MockDataGenerator.h"
+#include "TickStore.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+bool BenchmarkOptions::parse(const QStringList& arguments, BenchmarkOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "benchmark", "Run the headless throughput benchmark." });
+    parser.addOption({ "session", "Recorded session (one raw frame per line).", "file" });
+    parser.addOption({ "messages", "Synthetic message count.", "n" });
+    parser.addOption({ "repeat", "Replay the session N times.", "n" });
+    parser.addOption({ "symbols", "Comma separated symbols for synthetic data.", "list" });
+    parser.addOption({ "chart-points", "ChartManager max data points.", "n" });
+    parser.addOption({ "render-every", "Render the chart every N messages.", "n" });
+    parser.addOption({ "min-rate", "Fail if sustained messages/s is below this.", "rate" });
+    parser.addOption({ "report", "Write a JSON report to this file.", "file" });
+    parser.addOption({ "exchange", QString("Wire format of the session: %1.").arg(Exchanges::names().join(", ")), "name" });
+    parser.addOption({ "strict", "Fail if any frame does not parse (fixture replay)." });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("session")) options.sessionFile = parser.value("session");
+    if (parser.isSet("messages")) options.syntheticMessages = parser.value("messages").toInt();
+    if (parser.isSet("repeat")) options.repeat = std::max(1, parser.value("repeat").toInt());
+    if (parser.isSet("symbols")) options.symbols = parser.value("symbols").split(',', Qt::SkipEmptyParts);
+    if (parser.isSet("chart-points")) options.chartPoints = parser.value("chart-points").toInt();
+    if (parser.isSet("render-every")) options.renderEvery = parser.value("render-every").toInt();
+    if (parser.isSet("min-rate")) options.minMessagesPerSecond = parser.value("min-rate").toDouble();
+    if (parser.isSet("report")) options.reportFile = parser.value("report");
+    options.strict = parser.isSet("strict");
+    if (parser.isSet("exchange") && !Exchanges::fromName(parser.value("exchange"), options.exchange)) {
+        if (error) *error = QString("Unknown --exchange '%1'").arg(parser.value("exchange"));
+        return false;
+    }
+
+    if (options.symbols.isEmpty()) {
+        if (error) *error = "At least one symbol is required";
+        return false;
+    }
+    return true;
+}
+
+HeadlessBenchmark::HeadlessBenchmark(const BenchmarkOptions& options)
+    : options(options) {
+}
+
+bool HeadlessBenchmark::loadSession(const QString& fileName, std::vector<QByteArray>& frames) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "Cannot open session file: " << fileName.toStdString() << std::endl;
+        return false;
+    }
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        // '#' starts a comment line (fixture notes); no frame begins with one
+        if (!line.isEmpty() && !line.startsWith('#'))
+            frames.push_back(line);
+    }
+    return !frames.empty();
+}
+
+void HeadlessBenchmark::generateSyntheticSession(const QStringList& symbols, int count, std::vector<QByteArray>& frames, Exchange exchange) {
+    withExchange(exchange, [&]<ExchangeAdapter Adapter>() {
+        // One generator per symbol so each keeps its own random walk
+        std::vector<std::unique_ptr<MockDataGenerator>> generators;
+        QStringList pairs;
+        for (const QString& symbol : symbols) {
+            generators.push_back(std::make_unique<MockDataGenerator>(nullptr));
+            pairs.append(Adapter::toVenueSymbol(symbol));
+        }
+
+        frames.reserve(frames.size() + count);
+        qint64 timestamp = QDateTime::currentMSecsSinceEpoch() - count * 10LL;
+
+        for (int i = 0; i < count; ++i) {
+            int s = i % symbols.size();
+            MarketTick tick = generators[s]->generateTick(symbols.at(s));
+            timestamp += 10;
+
+            TickRecord trade;
+            trade.timestamp = timestamp;
+            trade.price = tick.price;
+            trade.volume = tick.volume / 10000.0;
+            trade.side = i % 2 ? 'b' : 's';
+
+            QByteArray frame;
+            frame.reserve(192);
+            Adapter::appendTradeFrame(frame, 100 + s, pairs.at(s), trade);
+            frames.push_back(frame);
+        }
+    });
+}
+
+double HeadlessBenchmark::percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+qint64 HeadlessBenchmark::peakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+int HeadlessBenchmark::run() {
+    if (!options.sessionFile.isEmpty()) {
+        if (!loadSession(options.sessionFile, frames))
+            return 1;
+    }
+    else {
+        generateSyntheticSession(options.symbols, options.syntheticMessages, frames, options.exchange);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto micros = [](clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double, std::micro>(b - a).count();
+    };
+
+    TickStore tickStore(static_cast<size_t>(std::max(options.chartPoints, 1)) * 8);
+    ChartManager chartManager;
+    chartManager.setMaxDataPoints(options.chartPoints);
+    chartManager.getChartView()->resize(1200, 700);
+    chartManager.getChartView()->show();
+
+    // The chart follows the first symbol, like the GUI follows the selector
+    QString chartSymbol = options.symbols.first();
+    chartManager.setSymbol(chartSymbol);
+
+    const size_t totalMessages = frames.size() * static_cast<size_t>(options.repeat);
+    StageSamples ingest{ "ingest", {} };
+    StageSamples parse{ "parse", {} };
+    StageSamples store{ "store", {} };
+    StageSamples chart{ "chart", {} };
+    StageSamples render{ "render", {} };
+    StageSamples total{ "end-to-end", {} };
+    for (StageSamples* stage : { &ingest, &parse, &store, &chart, &total }) {
+        stage->micros.reserve(totalMessages);
+    }
+
+    FeedMessage message;
+    quint64 tradeCount = 0;
+    quint64 parseErrors = 0;
+    QApplication::processEvents();
+
+    // Counts every module's allocations, Qt's included, for the measured loop only
+    const bool countingAllocations = AllocationCounter::start();
+    auto runStart = clock::now();
+    size_t processed = 0;
+
+    // One instantiation per venue: the parser is called directly inside the loop
+    withExchange(options.exchange, [&]<ExchangeAdapter Adapter>() {
+        for (int pass = 0; pass < options.repeat; ++pass) {
+            for (const QByteArray& raw : frames) {
+                auto t0 = clock::now();
+
+                // Ingest is the UTF-8 -> QString hop QWebSocket performs; the stages are
+                // disjoint, so they add up to the total
+                QString frame = QString::fromUtf8(raw);
+                auto t1 = clock::now();
+
+                if (!Adapter::parse(frame.toUtf8(), message))
+                    ++parseErrors;
+                auto t2 = clock::now();
+
+                int symbolId = -1;
+                if (message.type == FeedMessageType::Trade) {
+                    symbolId = tickStore.symbolId(Adapter::fromVenueSymbol(message.pair));
+                    for (const TickRecord& trade : message.trades) {
+                        tickStore.append(symbolId, trade);
+                    }
+                    tradeCount += message.trades.size();
+                }
+                auto t3 = clock::now();
+
+                bool charted = symbolId >= 0 && tickStore.symbolName(symbolId) == chartSymbol;
+                if (charted) {
+                    for (const TickRecord& trade : message.trades) {
+                        chartManager.addPricePoint(trade.price, trade.timestamp);
+                    }
+                }
+                auto t4 = clock::now();
+
+                ingest.micros.push_back(micros(t0, t1));
+                parse.micros.push_back(micros(t1, t2));
+                store.micros.push_back(micros(t2, t3));
+                if (charted) chart.micros.push_back(micros(t3, t4));
+                total.micros.push_back(micros(t0, t4));
+
+                ++processed;
+                if (options.renderEvery > 0 && processed % options.renderEvery == 0) {
+                    auto r0 = clock::now();
+                    QApplication::processEvents();
+                    chartManager.getChartView()->grab();
+                    render.micros.push_back(micros(r0, clock::now()));
+                }
+            }
+        }
+    });
+
+    double elapsedSeconds = std::chrono::duration<double>(clock::now() - runStart).count();
+    quint64 allocations = AllocationCounter::stop();
+
+    double messagesPerSecond = elapsedSeconds > 0 ? processed / elapsedSeconds : 0.0;
+    double ticksPerSecond = elapsedSeconds > 0 ? tradeCount / elapsedSeconds : 0.0;
+    double allocationsPerTick = tradeCount > 0 ? static_cast<double>(allocations) / tradeCount : 0.0;
+    qint64 peakRss = peakResidentBytes();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "=== Lightning Trade headless benchmark ===" << std::endl;
+    std::cout << "Source:            " << (options.sessionFile.isEmpty()
+        ? QString("synthetic (%1 symbols)").arg(options.symbols.size()).toStdString()
+        : options.sessionFile.toStdString()) << std::endl;
+    std::cout << "Exchange:          " << Exchanges::name(options.exchange) << std::endl;
+    std::cout << "Messages:          " << processed << " (" << parseErrors << " parse errors)" << std::endl;
+    std::cout << "Trades:            " << tradeCount << std::endl;
+    std::cout << "Elapsed:           " << elapsedSeconds << " s" << std::endl;
+    std::cout << "Sustained rate:    " << messagesPerSecond << " msg/s, " << ticksPerSecond << " ticks/s" << std::endl;
+    std::cout << "Peak RSS:          " << peakRss / (1024.0 * 1024.0) << " MiB" << std::endl;
+    if (countingAllocations)
+        std::cout << "Allocations/tick:  " << allocationsPerTick << std::endl;
+    else
+        std::cout << "Allocations/tick:  n/a (no allocator hook on this platform)" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(12) << "stage"
+        << std::right << std::setw(10) << "p50 us" << std::setw(10) << "p90 us"
+        << std::setw(10) << "p99 us" << std::setw(10) << "p99.9 us" << std::setw(12) << "max us" << std::endl;
+
+    QJsonArray stagesJson;
+    for (StageSamples* stage : { &ingest, &parse, &store, &chart, &render, &total }) {
+        double p50 = percentile(stage->micros, 0.50);
+        double p90 = percentile(stage->micros, 0.90);
+        double p99 = percentile(stage->micros, 0.99);
+        double p999 = percentile(stage->micros, 0.999);
+        double max = stage->micros.empty() ? 0.0 : *std::max_element(stage->micros.begin(), stage->micros.end());
+
+        std::cout << std::left << std::setw(12) << stage->name
+            << std::right << std::setw(10) << p50 << std::setw(10) << p90
+            << std::setw(10) << p99 << std::setw(10) << p999 << std::setw(12) << max << std::endl;
+
+        stagesJson.append(QJsonObject{
+            {"stage", stage->name},
+            {"samples", static_cast<qint64>(stage->micros.size())},
+            {"p50_us", p50}, {"p90_us", p90}, {"p99_us", p99}, {"p999_us", p999}, {"max_us", max}
+            });
+    }
+
+    if (!options.reportFile.isEmpty()) {
+        QJsonObject report{
+            {"exchange", QString(Exchanges::name(options.exchange))},
+            {"messages", static_cast<qint64>(processed)},
+            {"trades", static_cast<qint64>(tradeCount)},
+            {"parse_errors", static_cast<qint64>(parseErrors)},
+            {"elapsed_s", elapsedSeconds},
+            {"messages_per_s", messagesPerSecond},
+            {"ticks_per_s", ticksPerSecond},
+            {"peak_rss_bytes", peakRss},
+            {"allocations_per_tick", countingAllocations ? QJsonValue(allocationsPerTick) : QJsonValue()},
+            {"stages", stagesJson}
+        };
+        QFile file(options.reportFile);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(QJsonDocument(report).toJson());
+        }
+        else {
+            std::cerr << "Cannot write report: " << options.reportFile.toStdString() << std::endl;
+        }
+    }
+
+    if (options.strict && parseErrors > 0) {
+        std::cerr << "FAIL: " << parseErrors << " frames did not parse as " << Exchanges::name(options.exchange) << std::endl;
+        return 1;
+    }
+    if (options.minMessagesPerSecond > 0 && messagesPerSecond < options.minMessagesPerSecond) {
+        std::cerr << "FAIL: sustained rate " << messagesPerSecond
+            << " msg/s is below the gate of " << options.minMessagesPerSecond << " msg/s" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Exchanges.h"
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+struct BenchmarkOptions {
+    QString sessionFile;              // recorded frames, one raw frame per line; empty = synthetic
+    int syntheticMessages = 100000;
+    int repeat = 1;                   // replay the session this many times
+    QStringList symbols{ "BTCUSD", "ETHUSD" };
+    int chartPoints = 500;
+    int renderEvery = 250;            // render the chart every N messages (0 = never)
+    double minMessagesPerSecond = 0;  // regression gate, 0 disables
+    QString reportFile;               // optional JSON report
+    Exchange exchange = Exchange::KrakenV1;  // wire format of the session and of synthetic frames
+    bool strict = false;              // any parse error fails the run (fixture replay)
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, BenchmarkOptions& options, QString* error);
+};
+
+// Pushes a recorded or synthetic exchange stream through the real
+// ingest -> parse -> store -> ChartManager path without a visible window.
+// Requires a QApplication (normally on the "offscreen" platform).
+class HeadlessBenchmark {
+private:
+    struct StageSamples {
+        const char* name;
+        std::vector<double> micros;
+    };
+
+    BenchmarkOptions options;
+    std::vector<QByteArray> frames;
+
+    static double percentile(std::vector<double>& samples, double p);
+    static qint64 peakResidentBytes();
+
+public:
+    explicit HeadlessBenchmark(const BenchmarkOptions& options);
+
+    // Recorded session: one raw frame per line, '#' lines skipped. Also used by the transport benchmark.
+    static bool loadSession(const QString& fileName, std::vector<QByteArray>& frames);
+    // Trade frames in 'exchange's wire format cycling through 'symbols', one random walk per symbol
+    static void generateSyntheticSession(const QStringList& symbols, int count, std::vector<QByteArray>& frames,
+        Exchange exchange = Exchange::KrakenV1);
+
+    // Runs the benchmark and prints the report. Returns the process exit code.
+    int run();
+};
@@ -0,0 +1,146 @@
+#include "HeadlessBusReader.h"
+#include "KrakenMessageParser.h"
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+bool BusReaderOptions::parse(const QStringList& arguments, BusReaderOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "bus-read", "Run the sample tick bus consumer." });
+    parser.addOption({ "bus", "Shared memory bus name.", "name" });
+    parser.addOption({ "symbols", "Comma separated symbols to keep.", "list" });
+    parser.addOption({ "from-start", "Read the ticks still in the ring before new ones." });
+    parser.addOption({ "spin", "Busy-poll instead of sleeping when idle." });
+    parser.addOption({ "print", "Print every tick." });
+    parser.addOption({ "seconds", "Stop after this many seconds.", "s" });
+    parser.addOption({ "stats-interval", "Report interval in milliseconds.", "ms" });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("bus")) options.busName = parser.value("bus");
+    if (parser.isSet("symbols")) {
+        for (const QString& symbol : parser.value("symbols").split(',', Qt::SkipEmptyParts)) {
+            options.symbols.append(KrakenMessageParser::normalizeSymbol(symbol.trimmed()));
+        }
+    }
+    options.fromStart = parser.isSet("from-start");
+    options.spin = parser.isSet("spin");
+    options.printTicks = parser.isSet("print");
+    if (parser.isSet("seconds")) options.seconds = std::max(0, parser.value("seconds").toInt());
+    if (parser.isSet("stats-interval")) options.statsIntervalMs = std::max(100, parser.value("stats-interval").toInt());
+
+    if (options.busName.isEmpty()) {
+        if (error) *error = "Invalid --bus";
+        return false;
+    }
+    return true;
+}
+
+HeadlessBusReader::HeadlessBusReader(const BusReaderOptions& options)
+    : options(options) {
+}
+
+int HeadlessBusReader::run() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point started = Clock::now();
+    auto elapsedSeconds = [&]() { return std::chrono::duration<double>(Clock::now() - started).count(); };
+    auto finished = [&]() { return options.seconds > 0 && elapsedSeconds() >= options.seconds; };
+
+    // Symbol filter by bus id, filled in as new ids appear
+    std::vector<signed char> wanted;
+    auto accepts = [&](int symbolId) {
+        if (options.symbols.isEmpty()) return true;
+        if (static_cast<size_t>(symbolId) >= wanted.size())
+            wanted.resize(symbolId + 1, -1);
+        if (wanted[symbolId] < 0) {
+            QString name = reader.symbolName(symbolId);
+            if (name.isEmpty()) return false;   // not visible yet; ask again next tick
+            wanted[symbolId] = options.symbols.contains(name) ? 1 : 0;
+        }
+        return wanted[symbolId] == 1;
+    };
+
+    std::vector<qint64> latencies;
+    latencies.reserve(1 << 20);
+    quint64 total = 0;
+    quint64 intervalTicks = 0;
+    quint64 lostAtReport = 0;
+    Clock::time_point lastReport = Clock::now();
+
+    auto report = [&]() {
+        double seconds = std::chrono::duration<double>(Clock::now() - lastReport).count();
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) {
+            return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1000.0;
+        };
+        std::cout << std::fixed << std::setprecision(1)
+            << "[" << elapsedSeconds() << "s] " << intervalTicks / std::max(seconds, 1e-9) << " ticks/s"
+            << ", total " << total
+            << ", lost " << reader.lost() - lostAtReport
+            << ", backlog " << reader.backlog()
+            << ", latency us p50 " << percentile(0.5) << " p99 " << percentile(0.99)
+            << " max " << percentile(1.0) << std::endl;
+        latencies.clear();
+        intervalTicks = 0;
+        lostAtReport = reader.lost();
+        lastReport = Clock::now();
+    };
+
+    auto onTick = [&](const TickBusReader::Tick& tick) {
+        if (!accepts(tick.symbolId)) return;
+        latencies.push_back(TickBus::nowNs() - tick.publishNs);
+        ++total;
+        ++intervalTicks;
+        if (options.printTicks) {
+            std::cout << QDateTime::fromMSecsSinceEpoch(tick.record.timestamp).toString("hh:mm:ss.zzz").toStdString()
+                << ' ' << reader.symbolName(tick.symbolId).toStdString()
+                << ' ' << std::setprecision(8) << tick.record.price << ' ' << tick.record.volume
+                << ' ' << (tick.record.side ? tick.record.side : '-') << '\n';
+        }
+    };
+
+    QString error;
+    bool waitingReported = false;
+    while (!finished()) {
+        // Attach, or re-attach once a closed publisher's ring is drained (a new
+        // one with another capacity lives in a new region)
+        if (!reader.isOpen() || (reader.publisherClosed() && reader.backlog() == 0)) {
+            if (reader.isOpen())
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            if (!reader.open(options.busName, !options.fromStart, &error)) {
+                if (!waitingReported) {
+                    std::cout << "Waiting for tick bus: " << error.toStdString() << std::endl;
+                    waitingReported = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                continue;
+            }
+            wanted.clear();
+            if (!waitingReported || !reader.publisherClosed())
+                std::cout << "Attached to tick bus " << options.busName.toStdString()
+                    << (reader.publisherClosed() ? " (publisher not running)" : "") << std::endl;
+            waitingReported = reader.publisherClosed();
+        }
+
+        if (reader.poll(onTick) == 0) {
+            if (options.spin)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        if (Clock::now() - lastReport >= std::chrono::milliseconds(options.statsIntervalMs))
+            report();
+    }
+
+    report();
+    return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include "TickBus.h"
+
+struct BusReaderOptions {
+    QString busName{ TickBusPublisher::DefaultName };
+    QStringList symbols;              // empty = every symbol on the bus
+    bool fromStart = false;           // replay what is still in the ring first
+    bool spin = false;                // busy-poll instead of sleeping when idle
+    bool printTicks = false;
+    int seconds = 0;                  // 0 = until killed
+    int statsIntervalMs = 1000;
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, BusReaderOptions& options, QString* error);
+};
+
+// Sample tick bus consumer: attaches to the shared ring, optionally prints
+// ticks and reports throughput, loss and publish-to-read latency.
+class HeadlessBusReader {
+private:
+    BusReaderOptions options;
+    TickBusReader reader;
+
+public:
+    explicit HeadlessBusReader(const BusReaderOptions& options);
+
+    int run();
+};
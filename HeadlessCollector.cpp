@@ -0,0 +1,423 @@
+#include "HeadlessCollector.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace {
+    // Longest a tick waits in an open tick database block before it is written
+    constexpr qint64 DatabaseSealAfterMs = 60000;
+}
+
+bool CollectorOptions::parse(const QStringList& arguments, CollectorOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "collect", "Run the headless collector." });
+    parser.addOption({ "symbols", "Comma separated symbols, e.g. BTCUSD,ETHUSD.", "list" });
+    parser.addOption({ "exchange", QString("Feed protocol: %1.").arg(Exchanges::names().join(", ")), "name" });
+    parser.addOption({ "url", "WebSocket endpoint; defaults to the exchange's.", "url" });
+    parser.addOption({ "journal", "Binary tick journal to append to.", "file" });
+    parser.addOption({ "db", "Compressed tick database directory to append to.", "dir" });
+    parser.addOption({ "record", "Record raw frames (benchmark session format).", "file" });
+    parser.addOption({ "bus", "Publish trades on this shared memory tick bus.", "name" });
+    parser.addOption({ "mcast", "Republish trades on UDP multicast, e.g. 239.255.42.99:30001.", "group:port" });
+    parser.addOption({ "connections", "Parallel connections with first-arrival arbitration of trades.", "n" });
+    parser.addOption({ "bar-interval", "Bar interval in seconds.", "s" });
+    parser.addOption({ "stats-interval", "Metrics report interval in seconds.", "s" });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("symbols")) {
+        options.symbols.clear();
+        for (const QString& symbol : parser.value("symbols").split(',', Qt::SkipEmptyParts)) {
+            options.symbols.append(KrakenMessageParser::normalizeSymbol(symbol.trimmed()));
+        }
+    }
+    if (parser.isSet("exchange") && !Exchanges::fromName(parser.value("exchange"), options.exchange)) {
+        if (error) *error = QString("Unknown --exchange '%1'").arg(parser.value("exchange"));
+        return false;
+    }
+    options.url = QUrl(parser.isSet("url") ? parser.value("url") : QString(Exchanges::defaultUrl(options.exchange)));
+    if (parser.isSet("journal")) options.journalFile = parser.value("journal");
+    if (parser.isSet("db")) options.databaseDirectory = parser.value("db");
+    if (parser.isSet("record")) options.recordFile = parser.value("record");
+    if (parser.isSet("bus")) options.busName = parser.value("bus");
+    if (parser.isSet("mcast")) options.multicast = parser.value("mcast");
+
+    // Counts and intervals are whole numbers >= 1; 0 would make the stats timer spin
+    auto positive = [&parser, error](const char* name, int max, int& value) {
+        bool ok = false;
+        const int parsed = parser.value(name).toInt(&ok);
+        if (!ok || parsed < 1 || parsed > max) {
+            if (error) *error = QString("--%1 must be a whole number from 1 to %2").arg(name).arg(max);
+            return false;
+        }
+        value = parsed;
+        return true;
+    };
+    constexpr int MaxIntervalSeconds = std::numeric_limits<int>::max() / 1000;
+    int seconds = 0;
+    if (parser.isSet("connections") && !positive("connections", FeedArbiter::MaxConnections, options.connections))
+        return false;
+    if (parser.isSet("bar-interval")) {
+        if (!positive("bar-interval", MaxIntervalSeconds, seconds)) return false;
+        options.barIntervalMs = seconds * 1000;
+    }
+    if (parser.isSet("stats-interval")) {
+        if (!positive("stats-interval", MaxIntervalSeconds, seconds)) return false;
+        options.statsIntervalMs = seconds * 1000;
+    }
+
+    if (options.symbols.isEmpty()) {
+        if (error) *error = "At least one symbol is required";
+        return false;
+    }
+    if (!options.url.isValid()) {
+        if (error) *error = "Invalid --url";
+        return false;
+    }
+    QHostAddress group;
+    quint16 port;
+    if (!options.multicast.isEmpty() && !TickMulticast::parseEndpoint(options.multicast, group, port)) {
+        if (error) *error = "Invalid --mcast, expected an IPv4 multicast group[:port]";
+        return false;
+    }
+    return true;
+}
+
+HeadlessCollector::HeadlessCollector(const CollectorOptions& options)
+    : options(options),
+    barAggregator(options.barIntervalMs),
+    messageCount(0),
+    parseErrors(0),
+    bytesReceived(0),
+    messagesAtLastReport(0),
+    lastReportMs(0)
+{
+    // Register symbols up front so ids are stable and in command-line order.
+    // The subscription manager reuses these ids for routing.
+    for (const QString& symbol : options.symbols) {
+        metricsFor(tickStore.symbolId(symbol));
+    }
+
+    barAggregator.setBarClosedCallback([this](int symbolId, const Bar& bar) {
+        ++metricsFor(symbolId).bars;
+        Q_UNUSED(bar);
+    });
+}
+
+HeadlessCollector::~HeadlessCollector() {
+    // Closing a socket may emit disconnected(); tear them down while everything else is alive
+    for (Connection& connection : connections) {
+        connection.supervisor.reset();
+        connection.client.reset();
+    }
+    journal.close();
+    if (database) database->close();
+    if (recordFile.isOpen()) recordFile.close();
+    bus.close();
+    multicast.close();
+}
+
+bool HeadlessCollector::start() {
+    if (!options.journalFile.isEmpty() && !journal.open(options.journalFile))
+        return false;
+
+    if (!options.databaseDirectory.isEmpty()) {
+        database = std::make_unique<TickDatabase>(options.databaseDirectory);
+        QString error;
+        if (!database->open(&error)) {
+            qWarning() << error;
+            return false;
+        }
+    }
+
+    if (!options.recordFile.isEmpty()) {
+        recordFile.setFileName(options.recordFile);
+        if (!recordFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qWarning() << "Cannot open record file:" << options.recordFile << recordFile.errorString();
+            return false;
+        }
+    }
+
+    if (!options.busName.isEmpty()) {
+        QString error;
+        if (!bus.open(options.busName, 1 << 16, &error)) {
+            qWarning() << error;
+            return false;
+        }
+        qInfo() << "Publishing trades on tick bus" << options.busName;
+    }
+
+    if (!options.multicast.isEmpty()) {
+        QHostAddress group;
+        quint16 port = TickMulticast::DefaultPort;
+        TickMulticast::parseEndpoint(options.multicast, group, port);
+        QString error;
+        if (!multicast.open(group, port, &error)) {
+            qWarning() << error;
+            return false;
+        }
+        qInfo() << "Republishing trades on multicast" << group.toString() << port;
+    }
+
+    if (options.connections > 1) {
+        arbiter = std::make_unique<FeedArbiter>(options.connections);
+        arbiter->setTradeConsumer(
+            [this](int symbolId, const std::vector<TickRecord>& trades) { onTrades(symbolId, trades); });
+    }
+
+    connections.resize(options.connections);
+    for (int index = 0; index < options.connections; ++index) {
+        Connection& connection = connections[index];
+        connection.client = std::make_unique<WebSocketClient>();
+        connection.client->setMessageLogging(false);
+
+        WebSocketClient* client = connection.client.get();
+
+        connection.subscriptions = std::make_unique<SubscriptionManager>(tickStore,
+            [client](const QString& message) { client->sendMessage(message); },
+            Exchanges::subscriptionFormat(options.exchange));
+        if (arbiter) {
+            connection.subscriptions->setDefaultTradeConsumer(
+                [this, index](int symbolId, const std::vector<TickRecord>& trades) { arbiter->offer(index, symbolId, trades); });
+        } else {
+            connection.subscriptions->setDefaultTradeConsumer(
+                [this](int symbolId, const std::vector<TickRecord>& trades) { onTrades(symbolId, trades); });
+        }
+        connection.subscriptions->watch(options.symbols);
+
+        QObject::connect(client, &WebSocketClient::connected, client, [this, index]() { onConnected(index); });
+        QObject::connect(client, &WebSocketClient::disconnected, client, [this, index]() { onDisconnected(index); });
+        QObject::connect(client, &WebSocketClient::errorOccurred, client, [index](const QString& errorString) {
+            qWarning() << "Collector WebSocket error on connection" << index << ":" << errorString;
+        });
+        // The venue is chosen once here; each message goes straight to its adapter's parser
+        withExchange(options.exchange, [&]<ExchangeAdapter Adapter>() {
+            QObject::connect(client, &WebSocketClient::messageReceived, client,
+                [this, index](const QString& message) { onMessage<Adapter>(index, message); });
+        });
+
+        connection.supervisor = std::make_unique<ConnectionSupervisor>(*client);
+        ConnectionSupervisor::Callbacks supervisorCallbacks;
+        supervisorCallbacks.lost = [this, index](qint64 lastDataMs) { onFeedLost(index, lastDataMs); };
+        supervisorCallbacks.restored = [this, index](qint64 nowMs) { onFeedRestored(index, nowMs); };
+        supervisorCallbacks.retrying = [index](int attempt, int delayMs) {
+            qInfo() << "Connection" << index << "reconnecting in" << delayMs << "ms, attempt" << attempt;
+        };
+        supervisorCallbacks.stale = [index](qint64 silentMs) {
+            qWarning() << "Connection" << index << "silent for" << silentMs << "ms, dropping it";
+        };
+        supervisorCallbacks.resolved = [index](const QList<QHostAddress>& addresses) {
+            for (const QHostAddress& address : addresses) {
+                qInfo() << "Connection" << index << "endpoint resolved:" << address.toString();
+            }
+        };
+        connection.supervisor->setCallbacks(supervisorCallbacks);
+    }
+
+    QObject::connect(&statsTimer, &QTimer::timeout, &statsTimer, [this]() { reportStats(); });
+    statsTimer.start(options.statsIntervalMs);
+    uptime.start();
+
+    qInfo() << "Collector connecting to" << options.url.toString() << "(" << Exchanges::name(options.exchange) << ")"
+        << "for" << options.symbols.join(',')
+        << "over" << options.connections << (options.connections == 1 ? "connection" : "connections");
+    for (Connection& connection : connections) {
+        connection.supervisor->start(options.url);
+    }
+    return true;
+}
+
+void HeadlessCollector::onConnected(int connection) {
+    qInfo() << "Collector connected, connection" << connection;
+    connections[connection].subscriptions->setConnected(true);
+}
+
+void HeadlessCollector::onDisconnected(int connection) {
+    qWarning() << "Collector disconnected, connection" << connection;
+    connections[connection].subscriptions->setConnected(false);
+    journal.flush();
+    if (database) database->flush();
+    if (recordFile.isOpen()) recordFile.flush();
+}
+
+void HeadlessCollector::onFeedLost(int connection, qint64 lastDataMs) {
+    for (const Connection& other : connections) {
+        if (!other.supervisor->isOutage())
+            return;   // another connection still carries the feed
+    }
+    tickStore.beginGap(lastDataMs);
+    statistics.breakReturns();
+    qWarning() << "Feed gap opened on losing connection" << connection << "; last data at"
+        << QDateTime::fromMSecsSinceEpoch(lastDataMs).toString("hh:mm:ss.zzz");
+}
+
+void HeadlessCollector::onFeedRestored(int connection, qint64 nowMs) {
+    if (!tickStore.inGap())
+        return;
+    tickStore.endGap(nowMs);
+    const FeedGap& gap = tickStore.gaps().back();
+    qInfo() << "Feed gap closed by connection" << connection << "after"
+        << (gap.toTimestamp - gap.fromTimestamp) / 1000.0 << "s";
+}
+
+template <ExchangeAdapter Adapter>
+void HeadlessCollector::onMessage(int connection, const QString& message) {
+    ++messageCount;
+
+    QByteArray frame = message.toUtf8();
+    bytesReceived += frame.size();
+
+    // The session file replays one connection's view of the feed
+    if (recordFile.isOpen() && connection == 0) {
+        recordFile.write(frame);
+        recordFile.write("\n", 1);
+    }
+
+    if (!Adapter::parse(frame, parsedMessage)) {
+        ++parseErrors;
+        return;
+    }
+
+    SubscriptionManager& subscriptions = *connections[connection].subscriptions;
+    if (parsedMessage.type == FeedMessageType::Event) {
+        subscriptions.handleEvent(parsedMessage.eventData);
+        // Errors are already logged by the manager
+        SubscriptionStatus status;
+        if (Adapter::parseSubscriptionStatus(parsedMessage.eventData, status)
+            && status.kind != SubscriptionStatus::Kind::Error)
+            qInfo() << "Event:" << parsedMessage.event
+                << (status.kind == SubscriptionStatus::Kind::Subscribed ? "subscribed" : "unsubscribed")
+                << status.pair << status.channelName;
+        return;
+    }
+
+    if (parsedMessage.type == FeedMessageType::Trade)
+        subscriptions.dispatch(parsedMessage);
+}
+
+void HeadlessCollector::onTrades(int symbolId, const std::vector<TickRecord>& trades) {
+    const QString& symbol = tickStore.symbolName(symbolId);
+    SymbolMetrics& symbolMetrics = metricsFor(symbolId);
+
+    int busId = -1;
+    if (bus.isOpen()) {
+        while (busSymbolIds.size() <= static_cast<size_t>(symbolId)) {
+            busSymbolIds.push_back(bus.symbolId(tickStore.symbolName(static_cast<int>(busSymbolIds.size()))));
+        }
+        busId = busSymbolIds[symbolId];
+    }
+    int multicastId = -1;
+    if (multicast.isOpen()) {
+        while (multicastSymbolIds.size() <= static_cast<size_t>(symbolId)) {
+            multicastSymbolIds.push_back(multicast.symbolId(tickStore.symbolName(static_cast<int>(multicastSymbolIds.size()))));
+        }
+        multicastId = multicastSymbolIds[symbolId];
+    }
+
+    for (const TickRecord& trade : trades) {
+        tickStore.append(symbolId, trade);
+        barAggregator.addTrade(symbolId, trade);
+        journal.append(symbol, trade);
+        if (database) database->append(symbol, trade);
+        if (busId >= 0) bus.publish(busId, trade);
+        if (multicastId >= 0) multicast.publish(multicastId, trade);
+
+        ++symbolMetrics.trades;
+        symbolMetrics.volume += trade.volume;
+        symbolMetrics.notional += trade.volume * trade.price;
+        symbolMetrics.lastPrice = trade.price;
+        statistics.add(symbolId, trade);
+    }
+    // One datagram per exchange message rather than waiting for a full packet
+    multicast.flush();
+}
+
+HeadlessCollector::SymbolMetrics& HeadlessCollector::metricsFor(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= metrics.size())
+        metrics.resize(symbolId + 1);
+    return metrics[symbolId];
+}
+
+void HeadlessCollector::reportStats() {
+    barAggregator.flush(QDateTime::currentMSecsSinceEpoch());
+    journal.flush();
+    // Bounds what a crash can take with it; full blocks still compress best
+    if (database) database->flushOlderThan(DatabaseSealAfterMs);
+    if (recordFile.isOpen()) recordFile.flush();
+
+    qint64 nowMs = uptime.elapsed();
+    double seconds = (nowMs - lastReportMs) / 1000.0;
+    double rate = seconds > 0 ? (messageCount - messagesAtLastReport) / seconds : 0.0;
+    messagesAtLastReport = messageCount;
+    lastReportMs = nowMs;
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "[collector] up " << nowMs / 1000 << "s, "
+        << messageCount << " msgs (" << rate << " msg/s), "
+        << bytesReceived / 1024 << " KiB, "
+        << parseErrors << " parse errors, journal " << journal.bytesWritten() / 1024 << " KiB"
+        << std::endl;
+
+    quint64 reconnects = 0;
+    for (const Connection& connection : connections) {
+        reconnects += connection.supervisor->reconnectCount();
+    }
+    qint64 gapMs = 0;
+    for (const FeedGap& gap : tickStore.gaps()) {
+        gapMs += (gap.isOpen() ? QDateTime::currentMSecsSinceEpoch() : gap.toTimestamp) - gap.fromTimestamp;
+    }
+    std::cout << "    feed: " << reconnects << " reconnects, " << tickStore.gaps().size() << " gaps totalling "
+        << gapMs / 1000.0 << "s" << (tickStore.inGap() ? " (gap open)" : "") << std::endl;
+
+    for (int id = 0; id < tickStore.symbolCount(); ++id) {
+        const SymbolMetrics& m = metricsFor(id);
+        std::cout << "    " << std::left << std::setw(10) << tickStore.symbolName(id).toStdString() << std::right
+            << " trades " << m.trades
+            << "  bars " << m.bars
+            << "  volume " << m.volume
+            << "  notional " << m.notional
+            << "  last " << m.lastPrice
+            << std::endl;
+
+        StatisticsSnapshot s = statistics.snapshot(id);
+        if (s.trades == 0) continue;
+        std::cout << "               price p5/p50/p95 " << s.priceQuantiles[0] << "/" << s.priceQuantiles[2]
+            << "/" << s.priceQuantiles[4]
+            << "  size p50/p90/p99 " << std::setprecision(6) << s.sizeQuantiles[0] << "/" << s.sizeQuantiles[1]
+            << "/" << s.sizeQuantiles[2]
+            << "  return sd " << std::setprecision(2) << s.returnStdev * 1e4 << " bp"
+            << std::endl;
+    }
+
+    if (arbiter)
+        reportArbitration();
+}
+
+void HeadlessCollector::reportArbitration() {
+    std::cout << "    arbitration: " << arbiter->forwardedTrades() << " trades forwarded, "
+        << arbiter->trackedKeys() << " keys tracked" << std::endl;
+    std::cout << std::setprecision(1);
+    for (int index = 0; index < arbiter->connectionCount(); ++index) {
+        FeedArbiter::ConnectionStats& s = arbiter->connectionStats(index);
+        const double firstShare = s.trades > 0 ? 100.0 * s.first / s.trades : 0.0;
+        std::cout << "      connection " << index << (connections[index].client->isConnected() ? "" : " (down)")
+            << "  trades " << s.trades
+            << "  first " << s.first << " (" << firstShare << "%)"
+            << "  late " << s.late
+            << "  solo " << s.solo
+            << "  stale " << s.stale;
+        if (s.late > 0)
+            std::cout << "  lag p50/p99 " << s.lagMicros.quantile(0.5) << "/" << s.lagMicros.quantile(0.99) << " us";
+        if (s.leadMicros.count() > 0)
+            std::cout << "  lead p50/p99 " << s.leadMicros.quantile(0.5) << "/" << s.leadMicros.quantile(0.99) << " us";
+        std::cout << std::endl;
+    }
+    std::cout << std::setprecision(2);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+#include <memory>
+#include <vector>
+#include "BarAggregator.h"
+#include "ConnectionSupervisor.h"
+#include "Exchanges.h"
+#include "FeedArbiter.h"
+#include "KrakenMessageParser.h"
+#include "SessionStatistics.h"
+#include "SubscriptionManager.h"
+#include "TickBus.h"
+#include "TickDatabase.h"
+#include "TickMulticast.h"
+#include "TickJournal.h"
+#include "TickStore.h"
+#include "WebSocketClient.h"
+
+struct CollectorOptions {
+    QStringList symbols{ "BTCUSD" };
+    Exchange exchange = Exchange::KrakenV1;
+    QUrl url{ KrakenV1::DefaultUrl };   // the exchange's default unless --url is given
+    QString journalFile;          // binary tick journal (TickJournal)
+    QString databaseDirectory;    // compressed tick database (TickDatabase)
+    QString recordFile;           // raw frames, one per line (benchmark --session input)
+    QString busName;              // shared memory tick bus to publish on (TickBus)
+    QString multicast;            // "group:port" to republish on over UDP multicast (TickMulticast)
+    int connections = 1;          // redundant connections to the same endpoint (FeedArbiter)
+    int barIntervalMs = 60000;
+    int statsIntervalMs = 10000;
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, CollectorOptions& options, QString* error);
+};
+
+// Capture-only mode: WebSocket ingest, parsing, bar aggregation, journaling
+// and periodic metrics under a QCoreApplication. Creates no GUI objects.
+//
+// With more than one connection, each holds its own subscriptions (channel
+// ids differ per connection) and their trades meet in a FeedArbiter, which
+// passes on the first copy of each. Every connection is kept up by a
+// ConnectionSupervisor; a feed gap is recorded only while all are down.
+class HeadlessCollector {
+private:
+    struct Connection {
+        std::unique_ptr<WebSocketClient> client;
+        std::unique_ptr<SubscriptionManager> subscriptions;
+        std::unique_ptr<ConnectionSupervisor> supervisor;
+    };
+
+    struct SymbolMetrics {
+        quint64 trades = 0;
+        quint64 bars = 0;
+        double volume = 0.0;
+        double notional = 0.0;
+        double lastPrice = 0.0;
+    };
+
+    CollectorOptions options;
+    std::vector<Connection> connections;
+    std::unique_ptr<FeedArbiter> arbiter;
+    QTimer statsTimer;
+    QElapsedTimer uptime;
+
+    FeedMessage parsedMessage;
+    TickStore tickStore;
+    BarAggregator barAggregator;
+    TickJournal journal;
+    std::unique_ptr<TickDatabase> database;
+    QFile recordFile;
+    TickBusPublisher bus;
+    std::vector<int> busSymbolIds;   // bus id per tick store id
+    TickMulticastPublisher multicast;
+    std::vector<int> multicastSymbolIds;
+
+    std::vector<SymbolMetrics> metrics;
+    StatisticsEngine statistics;
+    quint64 messageCount;
+    quint64 parseErrors;
+    quint64 bytesReceived;
+    quint64 messagesAtLastReport;
+    qint64 lastReportMs;
+
+    void onConnected(int connection);
+    void onDisconnected(int connection);
+    template <ExchangeAdapter Adapter>
+    void onMessage(int connection, const QString& message);
+    void onFeedLost(int connection, qint64 lastDataMs);
+    void onFeedRestored(int connection, qint64 nowMs);
+    void onTrades(int symbolId, const std::vector<TickRecord>& trades);
+    void reportStats();
+    void reportArbitration();
+    SymbolMetrics& metricsFor(int symbolId);
+
+public:
+    explicit HeadlessCollector(const CollectorOptions& options);
+    ~HeadlessCollector();
+
+    // Opens outputs and connects. Returns false if an output cannot be opened.
+    bool start();
+};
@@ -0,0 +1,249 @@
+#include "HeadlessFixtureCheck.h"
+#include "OrderBook.h"
+#include "SubscriptionManager.h"
+#include "TickStore.h"
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <iostream>
+#include <memory>
+
+namespace {
+    double decimalValue(int64_t mantissa, int decimals) {
+        double scale = 1.0;
+        for (int i = 0; i < decimals; ++i) scale *= 10.0;
+        return static_cast<double>(mantissa) / scale;
+    }
+
+    // Every level of 'update' must be in the book at exactly its wire price and
+    // volume - or gone, if it deleted the level or fell beyond the book's depth.
+    // Levels rescaled to a coarser book precision fail here.
+    bool levelsLanded(const OrderBook& book, const BookUpdate& update, QString* problem) {
+        auto checkSide = [&](const std::vector<BookLevelUpdate>& levels, bool isBid) {
+            const size_t count = isBid ? book.bidCount() : book.askCount();
+            auto level = [&](size_t i) -> const BookLevel& { return isBid ? book.bid(i) : book.ask(i); };
+
+            for (const BookLevelUpdate& wire : levels) {
+                const double price = decimalValue(wire.price, wire.priceDecimals);
+                const double volume = decimalValue(wire.volume, wire.volumeDecimals);
+                size_t i = 0;
+                while (i < count && book.toPrice(level(i).price) != price) ++i;
+
+                const char* side = isBid ? "bid" : "ask";
+                if (i < count) {
+                    if (volume == 0.0 || book.toVolume(level(i).volume) != volume) {
+                        *problem = QString("%1 %2 holds %3, expected %4")
+                            .arg(side).arg(price, 0, 'f', 10).arg(book.toVolume(level(i).volume), 0, 'f', 10).arg(volume, 0, 'f', 10);
+                        return false;
+                    }
+                    continue;
+                }
+
+                const bool beyondDepth = count == book.maxDepth()
+                    && (isBid ? price < book.toPrice(level(count - 1).price) : price > book.toPrice(level(count - 1).price));
+                if (volume != 0.0 && !beyondDepth) {
+                    *problem = QString("%1 %2 is missing from the book").arg(side).arg(price, 0, 'f', 10);
+                    return false;
+                }
+            }
+            return true;
+        };
+        return checkSide(update.asks, false) && checkSide(update.bids, true);
+    }
+}
+
+bool FixtureCheckOptions::parse(const QStringList& arguments, FixtureCheckOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "check-fixtures", "Replay the recorded adapter fixtures and verify them." });
+    parser.addOption({ "fixtures", "Directory holding <exchange>.txt sessions.", "dir" });
+    parser.addOption({ "exchange", QString("Comma separated adapters to check: %1.").arg(Exchanges::names().join(", ")), "list" });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("fixtures")) options.directory = parser.value("fixtures");
+    if (parser.isSet("exchange")) {
+        for (const QString& name : parser.value("exchange").split(',', Qt::SkipEmptyParts)) {
+            Exchange exchange;
+            if (!Exchanges::fromName(name.trimmed(), exchange)) {
+                if (error) *error = QString("Unknown --exchange '%1'").arg(name);
+                return false;
+            }
+            options.exchanges.push_back(exchange);
+        }
+    }
+
+    if (!QDir(options.directory).exists()) {
+        if (error) *error = QString("Fixture directory not found: %1").arg(options.directory);
+        return false;
+    }
+    return true;
+}
+
+HeadlessFixtureCheck::HeadlessFixtureCheck(const FixtureCheckOptions& options)
+    : options(options) {
+}
+
+bool HeadlessFixtureCheck::loadFixture(const QString& path, Fixture& fixture) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "Cannot open fixture: " << path.toStdString() << std::endl;
+        return false;
+    }
+
+    fixture.path = path;
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty())
+            continue;
+        if (line.startsWith('#')) {
+            const QByteArray comment = line.mid(1).trimmed();
+            if (!comment.startsWith("expect "))
+                continue;
+            for (const QByteArray& pair : comment.mid(7).split(' ')) {
+                const qsizetype equals = pair.indexOf('=');
+                if (equals > 0)
+                    fixture.expected.insert(QString::fromUtf8(pair.left(equals)), pair.mid(equals + 1).toLongLong());
+            }
+            continue;
+        }
+        fixture.frames.push_back(line);
+        fixture.lines.push_back(lineNumber);
+    }
+    return true;
+}
+
+template <ExchangeAdapter Adapter>
+bool HeadlessFixtureCheck::check(const Fixture& fixture) {
+    QHash<QString, qint64> counts{
+        {"trades", 0}, {"quotes", 0}, {"books", 0}, {"checksums", 0}, {"confirmed", 0}, {"rejected", 0}
+    };
+    QStringList problems;
+    int line = 0;
+
+    // The manager sees the fixture exactly as it would see the feed; nothing is sent
+    TickStore tickStore(1024);
+    SubscriptionManager subscriptions(tickStore, nullptr, SubscriptionFormat::of<Adapter>());
+    std::vector<std::unique_ptr<OrderBook>> books;
+
+    subscriptions.setDefaultTradeConsumer([&](int, const std::vector<TickRecord>& trades) {
+        counts["trades"] += static_cast<qint64>(trades.size());
+    });
+    subscriptions.setQuoteConsumer([&](int, const KrakenMessageParser::Quote&) {
+        ++counts["quotes"];
+    });
+    subscriptions.setBookConsumer([&](int symbolId, const BookUpdate& update) {
+        if (static_cast<size_t>(symbolId) >= books.size())
+            books.resize(symbolId + 1);
+        if (!books[symbolId])
+            books[symbolId] = std::make_unique<OrderBook>(10);
+        OrderBook& book = *books[symbolId];
+
+        ++counts["books"];
+        if (!book.apply(update)) {
+            problems.append(QString("line %1: book checksum %2 does not match %3").arg(line).arg(update.checksum).arg(book.checksum()));
+            return;
+        }
+        if (update.hasChecksum)
+            ++counts["checksums"];
+        QString problem;
+        if (book.isSynced() && !levelsLanded(book, update, &problem))
+            problems.append(QString("line %1: %2").arg(line).arg(problem));
+    });
+    subscriptions.setErrorConsumer([&](const SubscriptionStatus&) {
+        ++counts["rejected"];
+    });
+
+    FeedMessage message;
+    for (size_t i = 0; i < fixture.frames.size(); ++i) {
+        line = fixture.lines[i];
+        if (!Adapter::parse(fixture.frames[i], message)) {
+            problems.append(QString("line %1: does not parse as %2").arg(line).arg(Adapter::Name));
+            continue;
+        }
+
+        switch (message.type) {
+        case FeedMessageType::Event: {
+            SubscriptionStatus status;
+            if (Adapter::parseSubscriptionStatus(message.eventData, status) && status.kind == SubscriptionStatus::Kind::Subscribed) {
+                ++counts["confirmed"];
+                // Confirmed pairs are the ones data frames are routed to
+                subscriptions.watch({ Adapter::fromVenueSymbol(status.pair) });
+            }
+            subscriptions.handleEvent(message.eventData);
+            break;
+        }
+        case FeedMessageType::Trade:
+        case FeedMessageType::Book:
+        case FeedMessageType::Quote:
+            if (!subscriptions.dispatch(message))
+                problems.append(QString("line %1: %2 frame for %3 was not routed").arg(line).arg(message.channelName, message.pair));
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (auto it = fixture.expected.constBegin(); it != fixture.expected.constEnd(); ++it) {
+        if (!counts.contains(it.key()))
+            problems.append(QString("unknown expectation '%1'").arg(it.key()));
+        else if (counts.value(it.key()) != it.value())
+            problems.append(QString("expected %1=%2, replay gave %3").arg(it.key()).arg(it.value()).arg(counts.value(it.key())));
+    }
+
+    std::cout << Adapter::Name << ": " << fixture.frames.size() << " frames, "
+        << counts["trades"] << " trades, " << counts["quotes"] << " quotes, "
+        << counts["books"] << " book frames (" << counts["checksums"] << " checksums), "
+        << counts["confirmed"] << " subscriptions confirmed, " << counts["rejected"] << " rejected"
+        << (problems.isEmpty() ? " - OK" : " - FAIL") << std::endl;
+    for (const QString& problem : problems) {
+        std::cout << "  " << QFileInfo(fixture.path).fileName().toStdString() << ": " << problem.toStdString() << std::endl;
+    }
+    return problems.isEmpty();
+}
+
+int HeadlessFixtureCheck::run() {
+    std::vector<Exchange> exchanges = options.exchanges;
+    const bool explicitList = !exchanges.empty();
+    if (!explicitList) {
+        for (const QString& name : Exchanges::names()) {
+            Exchange exchange;
+            Exchanges::fromName(name, exchange);
+            exchanges.push_back(exchange);
+        }
+    }
+
+    int checked = 0;
+    int failed = 0;
+    for (Exchange exchange : exchanges) {
+        const QString path = QDir(options.directory).filePath(QString("%1.txt").arg(Exchanges::name(exchange)));
+        if (!QFileInfo::exists(path)) {
+            // Only a venue asked for by name must have a fixture
+            if (explicitList) {
+                std::cerr << "No fixture for " << Exchanges::name(exchange) << ": " << path.toStdString() << std::endl;
+                ++failed;
+            }
+            continue;
+        }
+
+        Fixture fixture;
+        if (!loadFixture(path, fixture)) {
+            ++failed;
+            continue;
+        }
+        ++checked;
+        if (!withExchange(exchange, [&]<ExchangeAdapter Adapter>() { return check<Adapter>(fixture); }))
+            ++failed;
+    }
+
+    if (checked == 0 && failed == 0) {
+        std::cerr << "No fixtures in " << options.directory.toStdString() << std::endl;
+        return 1;
+    }
+    return failed > 0 ? 1 : 0;
+}
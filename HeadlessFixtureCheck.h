@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Exchanges.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+struct FixtureCheckOptions {
+    QString directory{ "fixtures" };   // holds one "<exchange>.txt" session per adapter
+    std::vector<Exchange> exchanges;   // empty = every adapter with a fixture
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, FixtureCheckOptions& options, QString* error);
+};
+
+// Replays each adapter's recorded session through its parser, a
+// SubscriptionManager and per-symbol OrderBooks, and fails on any frame that
+// does not parse or route, any book checksum mismatch, and any book level
+// that does not land at exactly its wire price and volume.
+//
+// Fixture lines are raw frames; lines starting with '#' are comments, and a
+// "# expect trades=3 books=3 ..." line lists counts the replay must reproduce:
+// trades, quotes, books (frames applied), checksums (verified), confirmed and
+// rejected (subscription acknowledgements).
+class HeadlessFixtureCheck {
+private:
+    struct Fixture {
+        QString path;
+        std::vector<QByteArray> frames;
+        std::vector<int> lines;             // line number of each frame
+        QHash<QString, qint64> expected;
+    };
+
+    FixtureCheckOptions options;
+
+    static bool loadFixture(const QString& path, Fixture& fixture);
+    template <ExchangeAdapter Adapter>
+    bool check(const Fixture& fixture);
+
+public:
+    explicit HeadlessFixtureCheck(const FixtureCheckOptions& options);
+
+    // Prints one line per fixture. Returns the process exit code.
+    int run();
+};
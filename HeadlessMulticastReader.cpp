@@ -0,0 +1,186 @@
+#include "HeadlessMulticastReader.h"
+#include "KrakenMessageParser.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+bool MulticastReaderOptions::parse(const QStringList& arguments, MulticastReaderOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "mcast-read", "Run the sample multicast tick consumer." });
+    parser.addOption({ "mcast", "Multicast group and port, e.g. 239.255.42.99:30001.", "group:port" });
+    parser.addOption({ "symbols", "Comma separated symbols to keep.", "list" });
+    parser.addOption({ "print", "Print every tick." });
+    parser.addOption({ "seconds", "Stop after this many seconds.", "s" });
+    parser.addOption({ "stats-interval", "Report interval in milliseconds.", "ms" });
+    parser.addOption({ "gap-timeout", "Give up on a gap after this many milliseconds.", "ms" });
+    parser.addOption({ "from", "First sequence number wanted (gap-filled from the publisher's history).", "seq" });
+    parser.addOption({ "loopback-test", "Publish this many synthetic ticks in-process and verify delivery.", "n" });
+    parser.addOption({ "drop", "Loopback test: fraction of datagrams to drop, e.g. 0.05.", "rate" });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("mcast") && !TickMulticast::parseEndpoint(parser.value("mcast"), options.group, options.port)) {
+        if (error) *error = "Invalid --mcast, expected an IPv4 multicast group[:port]";
+        return false;
+    }
+    if (parser.isSet("symbols")) {
+        for (const QString& symbol : parser.value("symbols").split(',', Qt::SkipEmptyParts)) {
+            options.symbols.append(KrakenMessageParser::normalizeSymbol(symbol.trimmed()));
+        }
+    }
+    options.printTicks = parser.isSet("print");
+    if (parser.isSet("seconds")) options.seconds = std::max(0, parser.value("seconds").toInt());
+    if (parser.isSet("stats-interval")) options.statsIntervalMs = std::max(100, parser.value("stats-interval").toInt());
+    if (parser.isSet("gap-timeout")) options.gapTimeoutMs = std::max(10, parser.value("gap-timeout").toInt());
+    if (parser.isSet("from")) options.fromSequence = parser.value("from").toULongLong();
+    if (parser.isSet("loopback-test")) options.loopbackTicks = std::max(0, parser.value("loopback-test").toInt());
+    if (parser.isSet("drop")) options.dropRate = std::clamp(parser.value("drop").toDouble(), 0.0, 0.9);
+    return true;
+}
+
+HeadlessMulticastReader::HeadlessMulticastReader(const MulticastReaderOptions& options)
+    : options(options) {
+}
+
+int HeadlessMulticastReader::run() {
+    if (options.loopbackTicks > 0)
+        return runLoopbackTest();
+
+    QElapsedTimer uptime;
+    uptime.start();
+    quint64 total = 0;
+    quint64 intervalTicks = 0;
+    qint64 lastReportMs = 0;
+
+    auto onTick = [&](const TickMulticastReceiver::Tick& tick) {
+        if (!options.symbols.isEmpty() && !options.symbols.contains(receiver.symbolName(tick.symbolId)))
+            return;
+        ++total;
+        ++intervalTicks;
+        if (options.printTicks) {
+            std::cout << QDateTime::fromMSecsSinceEpoch(tick.record.timestamp).toString("hh:mm:ss.zzz").toStdString()
+                << ' ' << tick.sequence
+                << ' ' << receiver.symbolName(tick.symbolId).toStdString()
+                << ' ' << std::setprecision(8) << tick.record.price << ' ' << tick.record.volume
+                << ' ' << (tick.record.side ? tick.record.side : '-') << '\n';
+        }
+    };
+
+    receiver.setGapTimeout(options.gapTimeoutMs);
+    receiver.setStartSequence(options.fromSequence);
+    QString error;
+    if (!receiver.open(options.group, options.port, onTick, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 1;
+    }
+    std::cout << "Joined " << options.group.toString().toStdString() << ':' << options.port << std::endl;
+
+    auto report = [&]() {
+        const qint64 now = uptime.elapsed();
+        const double seconds = std::max<qint64>(now - lastReportMs, 1) / 1000.0;
+        std::cout << std::fixed << std::setprecision(1)
+            << "[" << now / 1000.0 << "s] " << intervalTicks / seconds << " ticks/s"
+            << ", total " << total
+            << ", next seq " << receiver.nextSequence()
+            << ", gap-filled " << receiver.filled()
+            << ", lost " << receiver.lost()
+            << ", duplicates " << receiver.duplicates()
+            << ", gap requests " << receiver.gapRequests() << std::endl;
+        intervalTicks = 0;
+        lastReportMs = now;
+    };
+
+    QTimer statsTimer;
+    QObject::connect(&statsTimer, &QTimer::timeout, &statsTimer, report);
+    statsTimer.start(options.statsIntervalMs);
+    if (options.seconds > 0)
+        QTimer::singleShot(options.seconds * 1000, &statsTimer, []() { QCoreApplication::quit(); });
+
+    QCoreApplication::exec();
+    report();
+    return 0;
+}
+
+int HeadlessMulticastReader::runLoopbackTest() {
+    // Content is a function of the sequence number, so every delivered tick can be checked
+    auto expectedTick = [](quint64 sequence) {
+        TickRecord tick;
+        tick.timestamp = 1700000000000 + static_cast<qint64>(sequence);
+        tick.price = 100.0 + static_cast<double>(sequence % 10000) * 0.01;
+        tick.volume = static_cast<double>(sequence % 7 + 1);
+        tick.bid = tick.price - 0.01;
+        tick.ask = tick.price + 0.01;
+        tick.side = sequence % 2 ? 'b' : 's';
+        return tick;
+    };
+
+    const quint64 ticks = static_cast<quint64>(options.loopbackTicks);
+    quint64 received = 0;
+    quint64 mismatches = 0;
+    quint64 lastSequence = 0;
+    QElapsedTimer clock;
+
+    TickMulticastPublisher publisher;
+    publisher.setTestDropRate(options.dropRate);
+
+    auto onTick = [&](const TickMulticastReceiver::Tick& tick) {
+        const TickRecord want = expectedTick(tick.sequence);
+        if (tick.sequence != lastSequence + 1 || tick.record.timestamp != want.timestamp
+            || tick.record.price != want.price || tick.record.volume != want.volume || tick.record.side != want.side
+            || receiver.symbolName(tick.symbolId) != (tick.sequence % 3 ? "BTCUSD" : "ETHUSD"))
+            ++mismatches;
+        lastSequence = tick.sequence;
+        if (++received == ticks)
+            QCoreApplication::quit();
+    };
+
+    receiver.setGapTimeout(options.gapTimeoutMs);
+    receiver.setStartSequence(1);
+    QString error;
+    if (!receiver.open(options.group, options.port, onTick, &error) || !publisher.open(options.group, options.port, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 1;
+    }
+    const int symbolIds[2] = { publisher.symbolId("ETHUSD"), publisher.symbolId("BTCUSD") };
+
+    // Bursts from the event loop, so the receiver drains (and gap-fills) alongside
+    quint64 published = 0;
+    QTimer publishTimer;
+    QObject::connect(&publishTimer, &QTimer::timeout, &publishTimer, [&]() {
+        const quint64 burst = std::min<quint64>(ticks - published, 600);
+        for (quint64 i = 0; i < burst; ++i) {
+            const quint64 sequence = ++published;
+            publisher.publish(symbolIds[sequence % 3 ? 1 : 0], expectedTick(sequence));
+        }
+        publisher.flush();
+        if (published == ticks)
+            publishTimer.stop();
+    });
+    QTimer::singleShot(std::max(options.seconds, 30) * 1000, &publishTimer, []() { QCoreApplication::quit(); });
+
+    clock.start();
+    publishTimer.start(1);
+    QCoreApplication::exec();
+    const double seconds = std::max<qint64>(clock.elapsed(), 1) / 1000.0;
+
+    const bool passed = received == ticks && mismatches == 0 && receiver.lost() == 0;
+    std::cout << std::fixed << std::setprecision(1)
+        << "Loopback test: published " << publisher.published()
+        << " ticks in " << publisher.sent() << " datagrams (" << publisher.dropped() << " dropped on purpose)"
+        << ", received " << received << " in order in " << seconds << "s (" << received / seconds << " ticks/s)"
+        << ", gap-filled " << receiver.filled()
+        << ", lost " << receiver.lost()
+        << ", duplicates " << receiver.duplicates()
+        << ", gap requests " << receiver.gapRequests() << "/" << publisher.gapRequestsServed()
+        << ", mismatches " << mismatches
+        << " - " << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed ? 0 : 1;
+}
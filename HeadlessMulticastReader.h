@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QHostAddress>
+#include <QString>
+#include <QStringList>
+#include "TickMulticast.h"
+
+struct MulticastReaderOptions {
+    QHostAddress group{ QString(TickMulticast::DefaultGroup) };
+    quint16 port = TickMulticast::DefaultPort;
+    QStringList symbols;              // empty = every symbol in the stream
+    bool printTicks = false;
+    int seconds = 0;                  // 0 = until killed
+    int statsIntervalMs = 1000;
+    int gapTimeoutMs = 500;
+    quint64 fromSequence = 0;         // 0 = join live
+    int loopbackTicks = 0;            // > 0: publish this many synthetic ticks in-process and verify them
+    double dropRate = 0.0;            // loopback test: datagrams the publisher drops on purpose
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, MulticastReaderOptions& options, QString* error);
+};
+
+// Sample multicast consumer: joins the group, prints or counts ticks and
+// reports throughput, gap-fills and loss. With --loopback-test it also runs
+// a publisher in the same process, drops datagrams on purpose and checks that
+// every tick still arrives exactly once and in order.
+class HeadlessMulticastReader {
+private:
+    MulticastReaderOptions options;
+    TickMulticastReceiver receiver;
+
+    int runLoopbackTest();
+
+public:
+    explicit HeadlessMulticastReader(const MulticastReaderOptions& options);
+
+    // Runs the event loop until done; returns the process exit code
+    int run();
+};
@@ -0,0 +1,192 @@
+#include "HeadlessWsBenchmark.h"
+#include "HeadlessBenchmark.h"
+#include "LocalFeedServer.h"
+#include "NativeWebSocketClient.h"
+#include "WebSocketClient.h"
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+
+bool WsBenchmarkOptions::parse(const QStringList& arguments, WsBenchmarkOptions& options, QString* error) {
+    QCommandLineParser parser;
+    parser.addOption({ "ws-bench", "Run the WebSocket transport benchmark." });
+    parser.addOption({ "session", "Recorded session (one raw frame per line).", "file" });
+    parser.addOption({ "messages", "Synthetic message count.", "n" });
+    parser.addOption({ "symbols", "Comma separated symbols for synthetic data.", "list" });
+    parser.addOption({ "rate", "Messages per second from the stand-in server, 0 = as fast as possible.", "rate" });
+    parser.addOption({ "clients", "Comma separated: qt, native, native-qt, native-spin.", "list" });
+    parser.addOption({ "cpu", "Pin the native client's network thread to this core.", "n" });
+    parser.addOption({ "timeout", "Give up on a client after this many seconds.", "s" });
+
+    if (!parser.parse(arguments)) {
+        if (error) *error = parser.errorText();
+        return false;
+    }
+
+    if (parser.isSet("session")) options.sessionFile = parser.value("session");
+    if (parser.isSet("messages")) options.syntheticMessages = std::max(1, parser.value("messages").toInt());
+    if (parser.isSet("symbols")) options.symbols = parser.value("symbols").split(',', Qt::SkipEmptyParts);
+    if (parser.isSet("rate")) options.rate = std::max(0.0, parser.value("rate").toDouble());
+    if (parser.isSet("clients")) options.clients = parser.value("clients").split(',', Qt::SkipEmptyParts);
+    if (parser.isSet("cpu")) options.cpu = parser.value("cpu").toInt();
+    if (parser.isSet("timeout")) options.timeoutSeconds = std::max(1, parser.value("timeout").toInt());
+
+    const QStringList known{ "qt", "native", "native-qt", "native-spin" };
+    for (const QString& client : options.clients) {
+        if (!known.contains(client)) {
+            if (error) *error = QString("Unknown client '%1'").arg(client);
+            return false;
+        }
+    }
+    if (options.symbols.isEmpty() || options.clients.isEmpty()) {
+        if (error) *error = "At least one symbol and one client are required";
+        return false;
+    }
+    return true;
+}
+
+HeadlessWsBenchmark::HeadlessWsBenchmark(const WsBenchmarkOptions& options)
+    : options(options) {
+}
+
+double HeadlessWsBenchmark::percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+HeadlessWsBenchmark::Result HeadlessWsBenchmark::runClient(const QString& client) {
+    Result result;
+    result.client = client;
+    result.latencyMicros.reserve(frames.size());
+
+    LocalFeedServer server(frames, options.rate);
+    if (!server.start(&result.error))
+        return result;
+
+    // Runs on whichever thread delivers messages to the handler, one at a time
+    std::atomic<size_t> received{ 0 };
+    std::atomic<bool> failed{ false };
+    qint64 lastReceivedNs = 0;
+    auto record = [&]() {
+        const qint64 now = LocalFeedServer::nowNs();
+        const size_t index = received.load(std::memory_order_relaxed);
+        if (index >= server.messageCount())
+            return;
+        result.latencyMicros.push_back((now - server.sendTimeNs(index)) / 1000.0);
+        lastReceivedNs = now;
+        received.store(index + 1, std::memory_order_release);
+    };
+
+    QEventLoop loop;
+    QTimer watchdog;
+    const qint64 deadline = LocalFeedServer::nowNs() + static_cast<qint64>(options.timeoutSeconds) * 1000000000;
+    QObject::connect(&watchdog, &QTimer::timeout, &loop, [&]() {
+        if (received.load(std::memory_order_acquire) == server.messageCount() || failed.load()
+            || LocalFeedServer::nowNs() > deadline)
+            loop.quit();
+    });
+    watchdog.start(10);
+
+    if (client == "qt") {
+        WebSocketClient socket;
+        socket.setMessageLogging(false);
+        QObject::connect(&socket, &WebSocketClient::connected, &loop, [&]() { socket.sendMessage("start"); });
+        QObject::connect(&socket, &WebSocketClient::messageReceived, &loop, [&](const QString& message) {
+            Q_UNUSED(message);
+            record();
+        });
+        QObject::connect(&socket, &WebSocketClient::errorOccurred, &loop, [&](const QString& errorString) {
+            result.error = errorString;
+            failed.store(true);
+        });
+        socket.connectToServer(server.url());
+        loop.exec();
+        socket.disconnectFromServer();
+    } else {
+        NativeWebSocketClient::Options nativeOptions;
+        nativeOptions.busyPoll = client == "native-spin";
+        nativeOptions.cpu = options.cpu;
+        NativeWebSocketClient socket(nativeOptions);
+
+        // Queued handlers die with this object, so none can run after the loop is gone
+        QObject context;
+        NativeWebSocketClient::Callbacks callbacks;
+        callbacks.connected = [&]() { socket.sendMessage("start"); };
+        callbacks.errorOccurred = [&](const QString& errorString) {
+            if (!failed.exchange(true))
+                result.error = errorString;
+        };
+        if (client == "native-qt") {
+            callbacks.messageReceived = [&](const QString& message) {
+                Q_UNUSED(message);
+                record();
+            };
+            socket.setCallbacks(callbacks, &context);
+        } else {
+            callbacks.frameReceived = [&](const char* data, size_t size) {
+                Q_UNUSED(data);
+                Q_UNUSED(size);
+                record();
+            };
+            socket.setCallbacks(callbacks);
+        }
+        socket.connectToServer(server.url());
+        loop.exec();
+        socket.disconnectFromServer();
+    }
+    server.stop();
+
+    result.received = received.load();
+    if (result.received > 0)
+        result.seconds = (lastReceivedNs - server.sendTimeNs(0)) / 1e9;
+    if (result.received < server.messageCount() && result.error.isEmpty())
+        result.error = QString("received %1 of %2").arg(result.received).arg(server.messageCount());
+    return result;
+}
+
+int HeadlessWsBenchmark::run() {
+    if (!options.sessionFile.isEmpty()) {
+        if (!HeadlessBenchmark::loadSession(options.sessionFile, frames))
+            return 1;
+    } else {
+        HeadlessBenchmark::generateSyntheticSession(options.symbols, options.syntheticMessages, frames);
+    }
+
+    size_t bytes = 0;
+    for (const QByteArray& frame : frames) {
+        bytes += static_cast<size_t>(frame.size());
+    }
+    std::cout << "Stand-in server: " << frames.size() << " messages, " << bytes / std::max<size_t>(frames.size(), 1)
+        << " bytes average, " << (options.rate > 0 ? QString("%1/s").arg(options.rate).toStdString() : std::string("flood"))
+        << " over loopback" << (options.cpu >= 0 ? ", native thread on core " + std::to_string(options.cpu) : std::string())
+        << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(13) << "client" << std::right << std::setw(12) << "msgs/s"
+        << std::setw(10) << "p50 us" << std::setw(10) << "p90 us" << std::setw(10) << "p99 us"
+        << std::setw(11) << "p99.9 us" << std::setw(12) << "max us" << std::endl;
+
+    bool allReceived = true;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const QString& client : options.clients) {
+        Result result = runClient(client);
+        std::vector<double>& samples = result.latencyMicros;
+        const double max = samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+        std::cout << std::left << std::setw(13) << client.toStdString() << std::right
+            << std::setw(12) << (result.seconds > 0 ? result.received / result.seconds : 0.0)
+            << std::setw(10) << percentile(samples, 0.50) << std::setw(10) << percentile(samples, 0.90)
+            << std::setw(10) << percentile(samples, 0.99) << std::setw(11) << percentile(samples, 0.999)
+            << std::setw(12) << max;
+        if (!result.error.isEmpty()) {
+            std::cout << "  (" << result.error.toStdString() << ")";
+            allReceived = false;
+        }
+        std::cout << std::endl;
+    }
+    return allReceived ? 0 : 1;
+}
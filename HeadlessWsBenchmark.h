@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+struct WsBenchmarkOptions {
+    QString sessionFile;              // recorded frames, one per line; empty = synthetic
+    int syntheticMessages = 100000;
+    QStringList symbols{ "BTCUSD", "ETHUSD" };
+    double rate = 20000;              // messages/s from the stand-in server, 0 = flood
+    QStringList clients{ "qt", "native", "native-qt", "native-spin" };
+    int cpu = -1;                     // core for the native client's network thread
+    int timeoutSeconds = 60;
+
+    // Returns false (and fills 'error') on bad arguments
+    static bool parse(const QStringList& arguments, WsBenchmarkOptions& options, QString* error);
+};
+
+// Transport benchmark: streams the same frames from a LocalFeedServer on
+// loopback to each client in turn and reports throughput and the latency
+// from the server's send() to the message handler:
+//   qt           WebSocketClient (QWebSocket), handler on the event loop as QString
+//   native       NativeWebSocketClient, zero-copy handler on its epoll thread
+//   native-qt    NativeWebSocketClient, QString handler queued to the event loop
+//   native-spin  as native, spinning on the socket instead of waiting in epoll
+// The difference between qt and native is what the Qt event loop costs on the
+// hot path; native-qt separates the socket stack from the thread hand-off.
+class HeadlessWsBenchmark {
+private:
+    struct Result {
+        QString client;
+        size_t received = 0;
+        double seconds = 0.0;
+        std::vector<double> latencyMicros;
+        QString error;
+    };
+
+    WsBenchmarkOptions options;
+    std::vector<QByteArray> frames;
+
+    Result runClient(const QString& client);
+    static double percentile(std::vector<double>& samples, double p);
+
+public:
+    explicit HeadlessWsBenchmark(const WsBenchmarkOptions& options);
+
+    // Runs every client and prints the report. Returns the process exit code.
+    int run();
+};
@@ -0,0 +1,342 @@
+#include "HistoryLoader.h"
+#include "KrakenMessageParser.h"
+#include "TickDatabase.h"
+#include "TickJournal.h"
+#include "WorkStealingPool.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    const char* skipField(const char* p, const char* end) {
+        while (p < end && *p != ',') ++p;
+        return p < end ? p + 1 : end;
+    }
+
+    bool parseDouble(const char*& p, const char* end, double& value) {
+        while (p < end && *p == ' ') ++p;
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc()) return false;
+        p = next;
+        return true;
+    }
+
+    // Kraken dumps use unix seconds; values that are already milliseconds pass through
+    qint64 toMilliseconds(double time) {
+        return time < 1e11 ? std::llround(time * 1000.0) : std::llround(time);
+    }
+
+    // Trades: time, price, volume. OHLCVT: time, open, high, low, close, volume, count -
+    // one tick per bar at the close, stamped with the bar's open time.
+    bool parseRow(const char* p, const char* end, HistoryLoader::Source format, TickRecord& tick) {
+        double time, price, volume;
+        if (!parseDouble(p, end, time)) return false;
+        p = skipField(p, end);
+        if (format == HistoryLoader::Source::KrakenOhlc) {
+            p = skipField(skipField(skipField(p, end), end), end);
+        }
+        if (!parseDouble(p, end, price)) return false;
+        p = skipField(p, end);
+        if (!parseDouble(p, end, volume)) return false;
+
+        tick = TickRecord();
+        tick.timestamp = toMilliseconds(time);
+        tick.price = price;
+        tick.volume = volume;
+        return true;
+    }
+
+    const char* lineEnd(const char* p, const char* end) {
+        const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        return newline ? static_cast<const char*>(newline) : end;
+    }
+
+    // Column count of the first line that starts with a number; None if there is none
+    HistoryLoader::Source detectFormat(const char* p, const char* end) {
+        while (p < end) {
+            const char* eol = lineEnd(p, end);
+            double time;
+            const char* field = p;
+            if (parseDouble(field, eol, time)) {
+                int columns = 1 + static_cast<int>(std::count(p, eol, ','));
+                if (columns >= 6) return HistoryLoader::Source::KrakenOhlc;
+                if (columns >= 3) return HistoryLoader::Source::KrakenTrades;
+                return HistoryLoader::Source::None;
+            }
+            p = eol + 1;
+        }
+        return HistoryLoader::Source::None;
+    }
+
+    qint64 parseLines(const char* p, const char* end, HistoryLoader::Source format, std::vector<TickRecord>& out) {
+        out.reserve(out.size() + static_cast<size_t>(end - p) / 32);
+        qint64 skipped = 0;
+        TickRecord tick;
+        while (p < end) {
+            const char* eol = lineEnd(p, end);
+            if (parseRow(p, eol, format, tick))
+                out.push_back(tick);
+            else if (eol - p > 1 || (eol - p == 1 && *p != '\r'))
+                ++skipped;
+            p = eol + 1;
+        }
+        return skipped;
+    }
+
+    // Start of the last 'rows' lines, ignoring trailing blank lines
+    const char* tailStart(const char* begin, const char* end, size_t rows) {
+        const char* p = end;
+        while (p > begin && (p[-1] == '\n' || p[-1] == '\r')) --p;
+        while (p > begin) {
+            if (p[-1] == '\n' && --rows == 0)
+                return p;
+            --p;
+        }
+        return begin;
+    }
+}
+
+HistoryLoader::HistoryLoader(const QString& directory)
+    : directory(directory) {
+}
+
+HistoryLoader::~HistoryLoader() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stopping = true;
+        requests.clear();
+    }
+    requestAdded.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+void HistoryLoader::loadAsync(const QString& symbol, size_t maxTicks, QObject* context, LoadCallback done) {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.push_back({ symbol, maxTicks, context, std::move(done) });
+        if (!worker.joinable())
+            worker = std::thread(&HistoryLoader::workerLoop, this);
+    }
+    requestAdded.notify_one();
+}
+
+void HistoryLoader::workerLoop() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            requestAdded.wait(lock, [this]() { return stopping || !requests.empty(); });
+            if (stopping)
+                return;
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        auto result = std::make_shared<Result>();
+        bool found = load(request.symbol, request.maxTicks, *result);
+        QMetaObject::invokeMethod(request.context, [done = std::move(request.done), found, result]() {
+            done(found, *result);
+        }, Qt::QueuedConnection);
+    }
+}
+
+QString HistoryLoader::defaultDirectory() {
+    QString configured = qEnvironmentVariable("LIGHTNINGTRADE_HISTORY");
+    if (!configured.isEmpty())
+        return configured;
+    return QDir(QCoreApplication::applicationDirPath()).filePath("history");
+}
+
+QString HistoryLoader::sourceName(Source source) {
+    switch (source) {
+    case Source::Database: return "tick database";
+    case Source::Journal: return "journal";
+    case Source::KrakenTrades: return "Kraken trades CSV";
+    case Source::KrakenOhlc: return "Kraken OHLC CSV";
+    default: return "none";
+    }
+}
+
+QStringList HistoryLoader::candidateNames(const QString& symbol) const {
+    QStringList names{ KrakenMessageParser::normalizeSymbol(symbol) };
+    QString pair = KrakenMessageParser::normalizeSymbol(KrakenMessageParser::toKrakenSymbol(symbol));
+    if (!names.contains(pair))
+        names.append(pair);
+    return names;
+}
+
+TickDatabase* HistoryLoader::openDatabase() {
+    // Indexed once; a collector appending meanwhile is picked up on the next run
+    if (!databaseChecked) {
+        databaseChecked = true;
+        QDir dir(directory);
+        if (dir.exists() && !dir.entryList({ "*.ltdb" }, QDir::Files).isEmpty()) {
+            auto opened = std::make_unique<TickDatabase>(directory, true);
+            if (opened->open())
+                database = std::move(opened);
+        }
+    }
+    return database.get();
+}
+
+WorkStealingPool* HistoryLoader::parsePool() {
+    if (!pool)
+        pool = std::make_unique<WorkStealingPool>();
+    return pool.get();
+}
+
+bool HistoryLoader::loadJournal(const QStringList& names, size_t maxTicks, Result& result) {
+    QDir dir(directory);
+    for (const QFileInfo& file : dir.entryInfoList({ "*.ltj" }, QDir::Files, QDir::Time)) {
+        // Journals have no index; only the chunks holding the tail are decoded
+        result.ticks.clear();
+        WorkStealingPool* journalPool = file.size() > ParallelThreshold ? parsePool() : nullptr;
+        if (!TickJournal::read(file.filePath(), names, maxTicks, result.ticks, journalPool) || result.ticks.empty())
+            continue;
+
+        result.source = Source::Journal;
+        result.path = file.filePath();
+        return true;
+    }
+    return false;
+}
+
+bool HistoryLoader::findCsv(const QStringList& names, QString& path, Source& source) const {
+    QDir dir(directory);
+    for (const QString& name : names) {
+        if (dir.exists(name + ".csv")) {
+            path = dir.filePath(name + ".csv");
+            source = Source::KrakenTrades;
+            return true;
+        }
+
+        // "<PAIR>_<minutes>.csv": the finest bars give the densest chart
+        int bestMinutes = std::numeric_limits<int>::max();
+        for (const QString& file : dir.entryList({ name + "_*.csv" }, QDir::Files)) {
+            bool ok = false;
+            int minutes = file.mid(name.size() + 1, file.size() - name.size() - 5).toInt(&ok);
+            if (ok && minutes > 0 && minutes < bestMinutes) {
+                bestMinutes = minutes;
+                path = dir.filePath(file);
+            }
+        }
+        if (bestMinutes != std::numeric_limits<int>::max()) {
+            source = Source::KrakenOhlc;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HistoryLoader::load(const QString& symbol, size_t maxTicks, Result& result) {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    QElapsedTimer timer;
+    timer.start();
+    result = Result();
+
+    if (!QDir(directory).exists())
+        return false;
+    const QStringList names = candidateNames(symbol);
+
+    bool found = false;
+    if (TickDatabase* db = openDatabase()) {
+        const QStringList stored = db->symbols();
+        for (const QString& name : names) {
+            if (!stored.contains(name)) continue;
+            bool ok = maxTicks > 0
+                ? db->tail(name, maxTicks, result.ticks)
+                : db->query(name, 0, 0, result.ticks, parsePool());
+            if (ok && !result.ticks.empty()) {
+                result.source = Source::Database;
+                result.path = db->path();
+                found = true;
+                break;
+            }
+            result.ticks.clear();
+        }
+    }
+
+    if (!found)
+        found = loadJournal(names, maxTicks, result);
+
+    QString csvPath;
+    Source csvSource;
+    if (!found && findCsv(names, csvPath, csvSource)) {
+        WorkStealingPool* csvPool = QFileInfo(csvPath).size() > ParallelThreshold ? parsePool() : nullptr;
+        found = parseKrakenCsv(csvPath, maxTicks, result.ticks, csvPool, &result.skippedRows, &result.source)
+            && !result.ticks.empty();
+        result.path = csvPath;
+    }
+
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return found;
+}
+
+bool HistoryLoader::parseKrakenCsv(const QString& path, size_t maxRows, std::vector<TickRecord>& out,
+    WorkStealingPool* pool, qint64* skippedRows, Source* format) {
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+    if (in.size() == 0)
+        return true;
+
+    const uchar* data = in.map(0, in.size());
+    if (!data)
+        return false;
+
+    const char* begin = reinterpret_cast<const char*>(data);
+    const char* end = begin + in.size();
+    if (maxRows > 0)
+        begin = tailStart(begin, end, maxRows);
+
+    Source detected = detectFormat(begin, end);
+    if (format) *format = detected;
+    if (detected == Source::None) {
+        in.unmap(const_cast<uchar*>(data));
+        return false;
+    }
+
+    qint64 skipped = 0;
+    if (!pool || pool->threadCount() < 2 || end - begin < ParallelThreshold) {
+        skipped = parseLines(begin, end, detected, out);
+    }
+    else {
+        // Chunks start just after a newline, so no row is split or parsed twice
+        size_t chunks = pool->threadCount() * 4;
+        std::vector<const char*> bounds{ begin };
+        for (size_t i = 1; i < chunks; ++i) {
+            const char* p = std::max(begin + (end - begin) * static_cast<qint64>(i) / static_cast<qint64>(chunks), bounds.back());
+            p = std::min(lineEnd(p, end) + 1, end);
+            bounds.push_back(p);
+        }
+        bounds.push_back(end);
+
+        std::vector<std::vector<TickRecord>> parts(chunks);
+        std::vector<qint64> partSkipped(chunks, 0);
+        for (size_t i = 0; i < chunks; ++i) {
+            pool->submit([&, i]() { partSkipped[i] = parseLines(bounds[i], bounds[i + 1], detected, parts[i]); });
+        }
+        pool->wait();
+
+        size_t total = out.size();
+        for (const auto& part : parts) total += part.size();
+        out.reserve(total);
+        for (size_t i = 0; i < chunks; ++i) {
+            out.insert(out.end(), parts[i].begin(), parts[i].end());
+            skipped += partSkipped[i];
+        }
+    }
+    in.unmap(const_cast<uchar*>(data));
+
+    if (skippedRows) *skippedRows += skipped;
+    return true;
+}
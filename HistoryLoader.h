@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MarketTick.h"
+
+class QObject;
+class TickDatabase;
+class WorkStealingPool;
+
+// Recent history for a symbol from local files, so a chart has context before
+// the first live trade arrives.
+//
+// The history directory is searched in order of decode cost: a TickDatabase
+// ("<SYMBOL>.ltdb"), TickJournals ("*.ltj", newest first) and Kraken's CSV
+// dumps - "<PAIR>.csv" trades (unix time, price, volume) or "<PAIR>_<minutes>.csv"
+// OHLCVT bars, the finest interval winning. Both the UI symbol (BTCUSD) and
+// Kraken's pair (XBTUSD) are tried.
+//
+// CSVs are memory-mapped and never copied: for a tail window the newline scan
+// runs backwards from the end of the file, so only the rows that will be shown
+// are touched however long the dump is. Large ranges are split on line
+// boundaries and parsed with std::from_chars on a work-stealing pool, each chunk
+// into its own vector, then joined in file order. Journals are mapped too and
+// decoded chunk-parallel on the same pool (TickJournal::read).
+//
+// loadAsync() runs loads on the loader's own thread, one at a time in request
+// order, so the GUI never waits on a disk.
+class HistoryLoader {
+public:
+    enum class Source {
+        None,
+        Database,
+        Journal,
+        KrakenTrades,
+        KrakenOhlc
+    };
+
+    struct Result {
+        std::vector<TickRecord> ticks;
+        Source source = Source::None;
+        QString path;
+        qint64 skippedRows = 0;    // lines that did not parse (headers, junk)
+        double elapsedMs = 0.0;
+    };
+
+    using LoadCallback = std::function<void(bool found, const Result& result)>;
+
+    // Ranges smaller than this are parsed on the calling thread
+    static constexpr qint64 ParallelThreshold = 4 * 1024 * 1024;
+
+private:
+    QString directory;
+    std::unique_ptr<TickDatabase> database;
+    bool databaseChecked = false;
+    std::unique_ptr<WorkStealingPool> pool;
+    std::mutex loadMutex;   // one load at a time: the database and pool are shared
+
+    struct Request {
+        QString symbol;
+        size_t maxTicks;
+        QObject* context;
+        LoadCallback done;
+    };
+    std::thread worker;
+    std::mutex requestMutex;
+    std::condition_variable requestAdded;
+    std::deque<Request> requests;
+    bool stopping = false;
+
+    QStringList candidateNames(const QString& symbol) const;
+    TickDatabase* openDatabase();
+    WorkStealingPool* parsePool();
+    bool loadJournal(const QStringList& names, size_t maxTicks, Result& result);
+    void workerLoop();
+    bool findCsv(const QStringList& names, QString& path, Source& source) const;
+
+public:
+    explicit HistoryLoader(const QString& directory = defaultDirectory());
+    ~HistoryLoader();
+
+    HistoryLoader(const HistoryLoader&) = delete;
+    HistoryLoader& operator=(const HistoryLoader&) = delete;
+
+    // "history" next to the executable, or $LIGHTNINGTRADE_HISTORY
+    static QString defaultDirectory();
+    QString path() const { return directory; }
+
+    // The newest 'maxTicks' (0 = all) ticks for 'symbol' in time order. Returns
+    // false if no history file has the symbol.
+    bool load(const QString& symbol, size_t maxTicks, Result& result);
+
+    // load() on the loader's thread; 'done' is then called on 'context''s thread.
+    // 'context' must outlive the loader, whose destructor drops queued requests
+    // and waits for the running one.
+    void loadAsync(const QString& symbol, size_t maxTicks, QObject* context, LoadCallback done);
+
+    // Parses a Kraken trades or OHLCVT CSV; 'maxRows' > 0 keeps only the last rows.
+    // The format is taken from the column count of the first data row.
+    static bool parseKrakenCsv(const QString& path, size_t maxRows, std::vector<TickRecord>& out,
+        WorkStealingPool* pool = nullptr, qint64* skippedRows = nullptr, Source* format = nullptr);
+
+    static QString sourceName(Source source);
+};
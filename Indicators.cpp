@@ -0,0 +1,299 @@
+#include "Indicators.h"
+#include <algorithm>
+
+RollingWindow::RollingWindow(size_t period)
+    : values(std::max<size_t>(period, 1), 0.0),
+    head(0),
+    count(0),
+    origin(0.0),
+    sum(0.0),
+    sumSquares(0.0),
+    sinceRebuild(0) {
+}
+
+void RollingWindow::reset() {
+    head = 0;
+    count = 0;
+    origin = 0.0;
+    sum = 0.0;
+    sumSquares = 0.0;
+    sinceRebuild = 0;
+}
+
+void RollingWindow::rebuild() {
+    sum = 0.0;
+    sumSquares = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double v = values[(head + i) % values.size()];
+        sum += v;
+        sumSquares += v * v;
+    }
+    sinceRebuild = 0;
+}
+
+void RollingWindow::push(double value) {
+    if (count == 0)
+        origin = value;
+    double v = value - origin;
+
+    if (count < values.size()) {
+        values[(head + count) % values.size()] = v;
+        ++count;
+    }
+    else {
+        double evicted = values[head];
+        sum -= evicted;
+        sumSquares -= evicted * evicted;
+        values[head] = v;
+        head = (head + 1) % values.size();
+    }
+    sum += v;
+    sumSquares += v * v;
+
+    // Amortised O(1): one full pass every 64 window lengths
+    if (++sinceRebuild >= values.size() * 64)
+        rebuild();
+}
+
+double RollingWindow::mean() const {
+    if (count == 0) return Indicators::NotReady;
+    return origin + sum / count;
+}
+
+double RollingWindow::variance() const {
+    if (count == 0) return Indicators::NotReady;
+    double m = sum / count;
+    return std::max(0.0, sumSquares / count - m * m);
+}
+
+Ema::Ema(int period)
+    : alpha(2.0 / (std::max(period, 1) + 1.0)),
+    value(0.0),
+    period(std::max(period, 1)),
+    count(0) {
+}
+
+double Ema::update(double price) {
+    value = count == 0 ? price : value + alpha * (price - value);
+    ++count;
+    return current();
+}
+
+Rsi::Rsi(int period)
+    : period(std::max(period, 1)),
+    count(0),
+    previous(0.0),
+    averageGain(0.0),
+    averageLoss(0.0) {
+}
+
+double Rsi::update(double price) {
+    if (count++ == 0) {
+        previous = price;
+        return Indicators::NotReady;
+    }
+
+    double change = price - previous;
+    previous = price;
+    double gain = change > 0.0 ? change : 0.0;
+    double loss = change < 0.0 ? -change : 0.0;
+
+    // Simple average over the first `period` changes, Wilder smoothing after
+    int changes = count - 1;
+    if (changes <= period) {
+        averageGain += (gain - averageGain) / changes;
+        averageLoss += (loss - averageLoss) / changes;
+        if (changes < period) return Indicators::NotReady;
+    }
+    else {
+        averageGain = (averageGain * (period - 1) + gain) / period;
+        averageLoss = (averageLoss * (period - 1) + loss) / period;
+    }
+
+    if (averageLoss == 0.0) return averageGain == 0.0 ? 50.0 : 100.0;
+    return 100.0 - 100.0 / (1.0 + averageGain / averageLoss);
+}
+
+StreamingIndicators::StreamingIndicators(const IndicatorConfig& config)
+    : config(config),
+    ema(config.emaPeriod),
+    smaWindow(config.smaPeriod),
+    bollingerWindow(config.bollingerPeriod),
+    rsi(config.rsiPeriod),
+    returnWindow(config.volatilityPeriod),
+    previousPrice(0.0),
+    vwapNotional(0.0),
+    vwapVolume(0.0) {
+}
+
+void StreamingIndicators::reset() {
+    ema.reset();
+    smaWindow.reset();
+    bollingerWindow.reset();
+    rsi.reset();
+    returnWindow.reset();
+    previousPrice = 0.0;
+    resetVwap();
+}
+
+IndicatorValues StreamingIndicators::update(const TickRecord& tick) {
+    IndicatorValues out;
+    double price = tick.price;
+
+    out.ema = ema.update(price);
+
+    smaWindow.push(price);
+    if (smaWindow.full())
+        out.sma = smaWindow.mean();
+
+    bollingerWindow.push(price);
+    if (bollingerWindow.full()) {
+        double middle = bollingerWindow.mean();
+        double band = config.bollingerWidth * std::sqrt(bollingerWindow.variance());
+        out.bollingerMiddle = middle;
+        out.bollingerUpper = middle + band;
+        out.bollingerLower = middle - band;
+    }
+
+    out.rsi = rsi.update(price);
+
+    if (previousPrice > 0.0 && price > 0.0) {
+        returnWindow.push(std::log(price / previousPrice));
+        if (returnWindow.full())
+            out.volatility = std::sqrt(returnWindow.variance());
+    }
+    previousPrice = price;
+
+    if (tick.volume > 0.0) {
+        vwapNotional += price * tick.volume;
+        vwapVolume += tick.volume;
+    }
+    if (vwapVolume > 0.0)
+        out.vwap = vwapNotional / vwapVolume;
+
+    return out;
+}
+
+void StreamingIndicators::backfill(const std::vector<TickRecord>& ticks, std::vector<IndicatorValues>& out) {
+    reset();
+    const size_t n = ticks.size();
+    out.assign(n, IndicatorValues());
+    if (n == 0) return;
+
+    // Contiguous columns
+    std::vector<double> price(n), volume(n);
+    for (size_t i = 0; i < n; ++i) {
+        price[i] = ticks[i].price;
+        volume[i] = ticks[i].volume;
+    }
+
+    // Prefix sums of price relative to the first tick, and of its square
+    const double origin = price[0];
+    std::vector<double> s1(n + 1, 0.0), s2(n + 1, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        double v = price[i] - origin;
+        s1[i + 1] = s1[i] + v;
+        s2[i + 1] = s2[i] + v * v;
+    }
+
+    auto windowMean = [&](size_t end, size_t period) {
+        return origin + (s1[end] - s1[end - period]) / period;
+    };
+    auto windowVariance = [&](size_t end, size_t period) {
+        double m = (s1[end] - s1[end - period]) / period;
+        return std::max(0.0, (s2[end] - s2[end - period]) / period - m * m);
+    };
+
+    const size_t smaPeriod = static_cast<size_t>(std::max(config.smaPeriod, 1));
+    for (size_t i = smaPeriod - 1; i < n; ++i) {
+        out[i].sma = windowMean(i + 1, smaPeriod);
+    }
+
+    const size_t bbPeriod = static_cast<size_t>(std::max(config.bollingerPeriod, 1));
+    for (size_t i = bbPeriod - 1; i < n; ++i) {
+        double middle = windowMean(i + 1, bbPeriod);
+        double band = config.bollingerWidth * std::sqrt(windowVariance(i + 1, bbPeriod));
+        out[i].bollingerMiddle = middle;
+        out[i].bollingerUpper = middle + band;
+        out[i].bollingerLower = middle - band;
+    }
+
+    // VWAP: running notional and volume
+    double notional = 0.0, totalVolume = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (volume[i] > 0.0) {
+            notional += price[i] * volume[i];
+            totalVolume += volume[i];
+        }
+        if (totalVolume > 0.0)
+            out[i].vwap = notional / totalVolume;
+    }
+
+    // Volatility: prefix sums over log returns (return j lands on tick j + 1)
+    const size_t volPeriod = static_cast<size_t>(std::max(config.volatilityPeriod, 1));
+    if (n > volPeriod) {
+        std::vector<double> r1(n, 0.0), r2(n, 0.0);
+        double returnOrigin = 0.0;
+        for (size_t i = 1; i < n; ++i) {
+            double r = (price[i] > 0.0 && price[i - 1] > 0.0) ? std::log(price[i] / price[i - 1]) : 0.0;
+            if (i == 1) returnOrigin = r;
+            r -= returnOrigin;
+            r1[i] = r1[i - 1] + r;
+            r2[i] = r2[i - 1] + r * r;
+        }
+        for (size_t i = volPeriod; i < n; ++i) {
+            double m = (r1[i] - r1[i - volPeriod]) / volPeriod;
+            double var = std::max(0.0, (r2[i] - r2[i - volPeriod]) / volPeriod - m * m);
+            out[i].volatility = std::sqrt(var);
+        }
+    }
+
+    // Recurrences
+    for (size_t i = 0; i < n; ++i) {
+        out[i].ema = ema.update(price[i]);
+        out[i].rsi = rsi.update(price[i]);
+    }
+
+    // Seed the running state: the windows only need their last period of samples
+    for (size_t i = n - std::min(n, smaPeriod); i < n; ++i) {
+        smaWindow.push(price[i]);
+    }
+    for (size_t i = n - std::min(n, bbPeriod); i < n; ++i) {
+        bollingerWindow.push(price[i]);
+    }
+    for (size_t i = n > volPeriod ? n - volPeriod : 1; i < n; ++i) {
+        if (price[i - 1] > 0.0 && price[i] > 0.0)
+            returnWindow.push(std::log(price[i] / price[i - 1]));
+    }
+    previousPrice = price[n - 1];
+    vwapNotional = notional;
+    vwapVolume = totalVolume;
+}
+
+SymbolIndicators::SymbolIndicators(const IndicatorConfig& config)
+    : indicators(config) {
+}
+
+void SymbolIndicators::update(const TickRecord& tick) {
+    latestValues = indicators.update(tick);
+    if (history.size() == HistoryCapacity)
+        history.pop_front();
+    history.push_back({ tick.timestamp, latestValues });
+}
+
+void SymbolIndicators::backfill(const std::vector<TickRecord>& ticks) {
+    std::vector<IndicatorValues> values;
+    indicators.backfill(ticks, values);
+
+    latestValues = values.empty() ? IndicatorValues() : values.back();
+    history.clear();
+    for (size_t i = ticks.size() - std::min(ticks.size(), HistoryCapacity); i < ticks.size(); ++i) {
+        history.push_back({ ticks[i].timestamp, values[i] });
+    }
+}
+
+void SymbolIndicators::reset() {
+    indicators.reset();
+    latestValues = IndicatorValues();
+    history.clear();
+}
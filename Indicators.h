@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "MarketTick.h"
+
+// Streaming technical indicators, O(1) per tick.
+//
+// Every indicator keeps only running state (sums over a fixed ring, smoothed
+// averages, cumulative totals), so a tick costs the same however long the
+// window is. Values are NaN until an indicator has seen enough ticks.
+
+namespace Indicators {
+    constexpr double NotReady = std::numeric_limits<double>::quiet_NaN();
+    inline bool ready(double value) { return !std::isnan(value); }
+}
+
+// Fixed-length window with running sum and sum of squares. Values are stored
+// relative to the first sample so the sums stay small and the variance does
+// not cancel catastrophically at BTC-sized prices; the sums are rebuilt from
+// the ring now and then to stop rounding drift.
+class RollingWindow {
+private:
+    std::vector<double> values;
+    size_t head;
+    size_t count;
+    double origin;
+    double sum;
+    double sumSquares;
+    size_t sinceRebuild;
+
+    void rebuild();
+
+public:
+    explicit RollingWindow(size_t period);
+
+    void push(double value);
+    void reset();
+
+    bool full() const { return count == values.size(); }
+    size_t size() const { return count; }
+    double mean() const;
+    double variance() const;   // population variance
+};
+
+class Ema {
+private:
+    double alpha;
+    double value;
+    int period;
+    int count;
+
+public:
+    explicit Ema(int period);
+    double update(double price);
+    double current() const { return count >= period ? value : Indicators::NotReady; }
+    void reset() { value = 0.0; count = 0; }
+};
+
+// Wilder's RSI
+class Rsi {
+private:
+    int period;
+    int count;
+    double previous;
+    double averageGain;
+    double averageLoss;
+
+public:
+    explicit Rsi(int period);
+    double update(double price);
+    void reset() { count = 0; previous = averageGain = averageLoss = 0.0; }
+};
+
+struct IndicatorConfig {
+    int emaPeriod = 20;
+    int smaPeriod = 20;
+    int bollingerPeriod = 20;
+    double bollingerWidth = 2.0;   // standard deviations
+    int rsiPeriod = 14;
+    int volatilityPeriod = 50;     // log returns
+};
+
+struct IndicatorValues {
+    double ema = Indicators::NotReady;
+    double sma = Indicators::NotReady;
+    double vwap = Indicators::NotReady;
+    double bollingerUpper = Indicators::NotReady;
+    double bollingerMiddle = Indicators::NotReady;
+    double bollingerLower = Indicators::NotReady;
+    double rsi = Indicators::NotReady;
+    double volatility = Indicators::NotReady;   // stdev of per-tick log returns
+};
+
+// All indicators for one symbol's tick stream
+class StreamingIndicators {
+private:
+    IndicatorConfig config;
+    Ema ema;
+    RollingWindow smaWindow;
+    RollingWindow bollingerWindow;
+    Rsi rsi;
+    RollingWindow returnWindow;
+    double previousPrice;
+    double vwapNotional;
+    double vwapVolume;
+
+public:
+    explicit StreamingIndicators(const IndicatorConfig& config = IndicatorConfig());
+
+    IndicatorValues update(const TickRecord& tick);
+    void reset();
+    void resetVwap() { vwapNotional = vwapVolume = 0.0; }   // new session
+
+    const IndicatorConfig& configuration() const { return config; }
+
+    // Backfill: restarts from a fresh state and fills 'out' with the values
+    // update() would produce for each of 'ticks', computed as prefix sums over
+    // contiguous arrays so the windowed indicators are a subtraction per tick
+    // in loops the compiler can vectorise. EMA and RSI are recurrences and stay
+    // sequential. The running state is left as if every tick had gone through
+    // update(), so live ticks continue from it.
+    void backfill(const std::vector<TickRecord>& ticks, std::vector<IndicatorValues>& out);
+};
+
+// One symbol's indicators, fed with every raw trade by whoever owns the tick
+// stream - not by a chart, whose points are conflated and windowed. The values
+// after the most recent trades are kept so a chart switching to the symbol can
+// redraw its overlays without recomputing anything.
+class SymbolIndicators {
+public:
+    struct Sample {
+        qint64 timestamp;
+        IndicatorValues values;
+    };
+    static constexpr size_t HistoryCapacity = 1024;   // above the chart's largest window
+
+private:
+    StreamingIndicators indicators;
+    IndicatorValues latestValues;
+    std::deque<Sample> history;
+
+public:
+    explicit SymbolIndicators(const IndicatorConfig& config = IndicatorConfig());
+
+    void update(const TickRecord& tick);
+    // Replaces all state with 'ticks' (oldest first) in one batch
+    void backfill(const std::vector<TickRecord>& ticks);
+    void reset();
+
+    const IndicatorValues& latest() const { return latestValues; }
+    // Oldest first; at most HistoryCapacity samples
+    const std::deque<Sample>& recent() const { return history; }
+};
@@ -0,0 +1,264 @@
+#include "KrakenAdapters.h"
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QTimeZone>
+
+namespace {
+    // Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's days_from_civil)
+    qint64 daysFromCivil(int year, int month, int day) {
+        year -= month <= 2;
+        const qint64 era = (year >= 0 ? year : year - 399) / 400;
+        const int yearOfEra = year - static_cast<int>(era * 400);
+        const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    bool appendLevels(const QJsonArray& levels, std::vector<BookLevelUpdate>& out) {
+        // Each level: {"price": 0.5666, "qty": 4831.75496356}. JSON drops trailing
+        // zeros, so levels are printed at one fixed scale: OrderBook takes its
+        // precision from the first level and would truncate any finer one.
+        for (const auto& levelVal : levels) {
+            const QJsonObject level = levelVal.toObject();
+            const QByteArray price = QByteArray::number(level.value("price").toDouble(), 'f', KrakenV2::BookPriceDecimals);
+            const QByteArray volume = QByteArray::number(level.value("qty").toDouble(), 'f', KrakenV2::BookQtyDecimals);
+
+            BookLevelUpdate update;
+            if (!OrderBook::parseDecimal(price.constData(), price.constData() + price.size(), update.price, update.priceDecimals))
+                return false;
+            if (!OrderBook::parseDecimal(volume.constData(), volume.constData() + volume.size(), update.volume, update.volumeDecimals))
+                return false;
+            out.push_back(update);
+        }
+        return true;
+    }
+}
+
+QString KrakenV1::subscriptionRequest(bool subscribe, const QJsonArray& venueSymbols, const QJsonObject& channel) {
+    QJsonObject message{
+        {"event", subscribe ? "subscribe" : "unsubscribe"},
+        {"pair", venueSymbols},
+        {"subscription", channel}
+    };
+    return QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact));
+}
+
+bool KrakenV1::parseSubscriptionStatus(const QJsonObject& event, SubscriptionStatus& status) {
+    if (event.value("event").toString() != "subscriptionStatus")
+        return false;
+
+    const QString state = event.value("status").toString();
+    if (state == "subscribed")
+        status.kind = SubscriptionStatus::Kind::Subscribed;
+    else if (state == "unsubscribed")
+        status.kind = SubscriptionStatus::Kind::Unsubscribed;
+    else if (state == "error")
+        status.kind = SubscriptionStatus::Kind::Error;
+    else
+        return false;
+    status.pair = event.value("pair").toString();
+    status.channelName = event.value("channelName").toString();
+    status.channelId = event.value("channelID").toInt(-1);
+    status.errorMessage = event.value("errorMessage").toString();
+    return true;
+}
+
+void KrakenV1::appendTradeFrame(QByteArray& out, int channelId, const QString& venueSymbol, const TickRecord& trade) {
+    out.append('[').append(QByteArray::number(channelId)).append(",[[\"")
+        .append(QByteArray::number(trade.price, 'f', 1)).append("\",\"")
+        .append(QByteArray::number(trade.volume, 'f', 8)).append("\",\"")
+        .append(QByteArray::number(trade.timestamp / 1000.0, 'f', 6)).append("\",\"")
+        .append(trade.side == 'b' ? "b" : "s").append("\",\"m\",\"\"]],\"trade\",\"")
+        .append(venueSymbol.toUtf8()).append("\"]");
+}
+
+QString KrakenV2::toVenueSymbol(const QString& uiSymbol) {
+    QString normalized = KrakenMessageParser::normalizeSymbol(uiSymbol);
+    if (normalized.startsWith("XBT"))
+        normalized.replace(0, 3, "BTC");
+    return KrakenMessageParser::splitPair(normalized);
+}
+
+QString KrakenV2::fromVenueSymbol(const QString& venueSymbol) {
+    QString normalized = KrakenMessageParser::normalizeSymbol(venueSymbol);
+    if (normalized.startsWith("XBT"))
+        normalized.replace(0, 3, "BTC");
+    return normalized;
+}
+
+QString KrakenV2::subscriptionRequest(bool subscribe, const QJsonArray& venueSymbols, const QJsonObject& channel) {
+    QJsonObject params;
+    for (auto it = channel.constBegin(); it != channel.constEnd(); ++it) {
+        if (it.key() != "name")
+            params.insert(it.key(), it.value());
+    }
+
+    const QString name = channel.value("name").toString();
+    if (name == "spread") {
+        params.insert("channel", "ticker");
+        params.insert("event_trigger", "bbo");
+    } else {
+        params.insert("channel", name);
+    }
+    // v1 sends no trade history on subscribe; keep it that way so a resubscribe cannot duplicate trades
+    if (name == "trade" && subscribe)
+        params.insert("snapshot", false);
+    params.insert("symbol", venueSymbols);
+
+    QJsonObject message{
+        {"method", subscribe ? "subscribe" : "unsubscribe"},
+        {"params", params}
+    };
+    return QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact));
+}
+
+qint64 KrakenV2::parseTimestamp(const QString& text) {
+    // YYYY-MM-DDTHH:MM:SS[.fraction]Z
+    if (text.size() < 20 || text.at(4) != '-' || text.at(7) != '-' || text.at(10) != 'T'
+        || text.at(13) != ':' || text.at(16) != ':')
+        return -1;
+
+    auto number = [&text](int from, int length) {
+        int value = 0;
+        for (int i = from; i < from + length; ++i) {
+            const QChar c = text.at(i);
+            if (!c.isDigit()) return -1;
+            value = value * 10 + c.digitValue();
+        }
+        return value;
+    };
+    const int year = number(0, 4), month = number(5, 2), day = number(8, 2);
+    const int hour = number(11, 2), minute = number(14, 2), second = number(17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || minute < 0 || second < 0)
+        return -1;
+
+    int millis = 0;
+    int i = 19;
+    if (i < text.size() && text.at(i) == '.') {
+        int digits = 0;
+        for (++i; i < text.size() && text.at(i).isDigit(); ++i, ++digits) {
+            if (digits < 3) millis = millis * 10 + text.at(i).digitValue();
+        }
+        for (; digits < 3; ++digits) millis *= 10;
+    }
+    if (i >= text.size() || text.at(i) != 'Z')
+        return -1;
+
+    const qint64 seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return seconds * 1000 + millis;
+}
+
+bool KrakenV2::parse(const QByteArray& frame, FeedMessage& out) {
+    out.clear();
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(frame, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject())
+        return false;
+
+    const QJsonObject obj = doc.object();
+    const QString channel = obj.value("channel").toString();
+
+    // Responses to requests: {"method":"subscribe","result":{...},"success":true,...}
+    if (channel.isEmpty()) {
+        out.type = FeedMessageType::Event;
+        out.event = obj.value("method").toString();
+        out.eventData = obj;
+        return true;
+    }
+    if (channel == "heartbeat") {
+        out.type = FeedMessageType::Heartbeat;
+        return true;
+    }
+    if (channel == "status") {
+        out.type = FeedMessageType::Event;
+        out.event = channel;
+        out.eventData = obj;
+        return true;
+    }
+
+    out.channelName = channel;
+    const QJsonArray data = obj.value("data").toArray();
+    if (data.isEmpty())
+        return true;
+    // Data frames carry one symbol each
+    out.pair = data.at(0).toObject().value("symbol").toString();
+
+    if (channel == "trade") {
+        out.type = FeedMessageType::Trade;
+        out.trades.reserve(data.size());
+        for (const auto& tradeVal : data) {
+            const QJsonObject trade = tradeVal.toObject();
+            const qint64 timestamp = parseTimestamp(trade.value("timestamp").toString());
+            const QJsonValue price = trade.value("price");
+            if (timestamp < 0 || !price.isDouble())
+                continue;
+
+            TickRecord record;
+            record.timestamp = timestamp;
+            record.price = price.toDouble();
+            record.volume = trade.value("qty").toDouble();
+            const QString side = trade.value("side").toString();
+            record.side = side.isEmpty() ? 0 : side.at(0).toLatin1();
+            out.trades.push_back(record);
+        }
+        return true;
+    }
+
+    if (channel == "ticker") {
+        const QJsonObject ticker = data.at(0).toObject();
+        if (!ticker.value("bid").isDouble() || !ticker.value("ask").isDouble())
+            return false;
+        out.type = FeedMessageType::Quote;
+        out.quote.bid = ticker.value("bid").toDouble();
+        out.quote.ask = ticker.value("ask").toDouble();
+        out.quote.bidSize = ticker.value("bid_qty").toDouble();
+        out.quote.askSize = ticker.value("ask_qty").toDouble();
+        const qint64 timestamp = parseTimestamp(ticker.value("timestamp").toString());
+        out.quote.timestamp = timestamp > 0 ? timestamp : 0;
+        return true;
+    }
+
+    if (channel == "book") {
+        const QJsonObject book = data.at(0).toObject();
+        out.type = FeedMessageType::Book;
+        out.book.snapshot = obj.value("type").toString() == "snapshot";
+        return appendLevels(book.value("asks").toArray(), out.book.asks)
+            && appendLevels(book.value("bids").toArray(), out.book.bids);
+    }
+
+    return true;
+}
+
+bool KrakenV2::parseSubscriptionStatus(const QJsonObject& event, SubscriptionStatus& status) {
+    const QString method = event.value("method").toString();
+    if (method != "subscribe" && method != "unsubscribe")
+        return false;
+
+    // Successes echo the request in "result"; failures name the symbol at the top level
+    const QJsonObject result = event.value("result").toObject();
+    if (event.value("success").toBool()) {
+        status.kind = method == "subscribe" ? SubscriptionStatus::Kind::Subscribed : SubscriptionStatus::Kind::Unsubscribed;
+        status.errorMessage.clear();
+    }
+    else {
+        status.kind = SubscriptionStatus::Kind::Error;
+        status.errorMessage = event.value("error").toString();
+    }
+    status.pair = result.contains("symbol") ? result.value("symbol").toString() : event.value("symbol").toString();
+    status.channelName = result.value("channel").toString();
+    status.channelId = -1;
+    return true;
+}
+
+void KrakenV2::appendTradeFrame(QByteArray& out, int channelId, const QString& venueSymbol, const TickRecord& trade) {
+    Q_UNUSED(channelId);
+    const QDateTime time = QDateTime::fromMSecsSinceEpoch(trade.timestamp, QTimeZone::UTC);
+    out.append("{\"channel\":\"trade\",\"type\":\"update\",\"data\":[{\"symbol\":\"").append(venueSymbol.toUtf8())
+        .append("\",\"side\":\"").append(trade.side == 'b' ? "buy" : "sell")
+        .append("\",\"price\":").append(QByteArray::number(trade.price, 'f', 1))
+        .append(",\"qty\":").append(QByteArray::number(trade.volume, 'f', 8))
+        .append(",\"ord_type\":\"market\",\"trade_id\":").append(QByteArray::number(trade.timestamp))
+        .append(",\"timestamp\":\"").append(time.toString(Qt::ISODateWithMs).toUtf8()).append("\"}]}");
+}
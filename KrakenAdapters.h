@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ExchangeAdapter.h"
+
+// Kraken WebSocket API v1 (wss://ws.kraken.com/): array data frames keyed by
+// channelID, "XBT/USD" pairs, string-encoded numbers. The parser is
+// KrakenMessageParser, unchanged.
+struct KrakenV1 {
+    static constexpr Exchange Id = Exchange::KrakenV1;
+    static constexpr const char* Name = "kraken-v1";
+    static constexpr const char* DefaultUrl = "wss://ws.kraken.com/";
+
+    static QString toVenueSymbol(const QString& uiSymbol) { return KrakenMessageParser::toKrakenSymbol(uiSymbol); }
+    static QString fromVenueSymbol(const QString& venueSymbol) { return KrakenMessageParser::fromKrakenSymbol(venueSymbol); }
+
+    // {"event":"subscribe","pair":[...],"subscription":{"name":"book","depth":10}}
+    static QString subscriptionRequest(bool subscribe, const QJsonArray& venueSymbols, const QJsonObject& channel);
+
+    static bool parse(const QByteArray& frame, FeedMessage& out) { return KrakenMessageParser::parse(frame, out); }
+
+    // {"event":"subscriptionStatus","status":"subscribed","channelID":42,"channelName":"book-10","pair":"XBT/USD",...}
+    static bool parseSubscriptionStatus(const QJsonObject& event, SubscriptionStatus& status);
+
+    // [channelID, [[price, volume, time, side, orderType, misc]], "trade", pair]
+    static void appendTradeFrame(QByteArray& out, int channelId, const QString& venueSymbol, const TickRecord& trade);
+};
+
+// Kraken WebSocket API v2 (wss://ws.kraken.com/v2): JSON objects with a
+// "channel" and a "data" array, "BTC/USD" symbols, numbers as JSON numbers
+// and RFC 3339 timestamps. There are no channel ids, so frames are routed by
+// symbol. The generic "spread" channel maps to v2's ticker with bbo triggers.
+//
+// v2 book checksums are computed over prices and quantities printed at the
+// pair's precision, which JSON numbers do not carry; book frames are passed
+// on without a checksum (OrderBook then applies them unverified). Book levels
+// are scaled to BookPriceDecimals/BookQtyDecimals, finer than any Kraken pair
+// quotes, so every level of a book shares one precision.
+struct KrakenV2 {
+    static constexpr Exchange Id = Exchange::KrakenV2;
+    static constexpr const char* Name = "kraken-v2";
+    static constexpr const char* DefaultUrl = "wss://ws.kraken.com/v2";
+    static constexpr int BookPriceDecimals = 10;
+    static constexpr int BookQtyDecimals = 8;
+
+    static QString toVenueSymbol(const QString& uiSymbol);
+    static QString fromVenueSymbol(const QString& venueSymbol);
+
+    // {"method":"subscribe","params":{"channel":"book","symbol":[...],"depth":10}}
+    static QString subscriptionRequest(bool subscribe, const QJsonArray& venueSymbols, const QJsonObject& channel);
+
+    static bool parse(const QByteArray& frame, FeedMessage& out);
+
+    // {"method":"subscribe","result":{"channel":"book","symbol":"BTC/USD",...},"success":true,...}
+    // or {"method":"subscribe","error":"Currency pair not supported","success":false,"symbol":"FOO/USD",...}
+    static bool parseSubscriptionStatus(const QJsonObject& event, SubscriptionStatus& status);
+
+    // {"channel":"trade","type":"update","data":[{"symbol":..,"side":..,"price":..,"qty":..,..}]}
+    static void appendTradeFrame(QByteArray& out, int channelId, const QString& venueSymbol, const TickRecord& trade);
+
+    // "2023-09-25T07:48:36.925533Z" -> ms since epoch; -1 if malformed
+    static qint64 parseTimestamp(const QString& text);
+};
+
+static_assert(ExchangeAdapter<KrakenV1>);
+static_assert(ExchangeAdapter<KrakenV2>);
@@ -0,0 +1,205 @@
+#include "KrakenMessageParser.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QStringList>
+#include <array>
+
+namespace {
+    // Quote currencies recognised when splitting "SOLUSD" into "SOL/USD", longest first
+    const std::array<const char*, 12> QuoteCurrencies = {
+        "USDT", "USDC", "USD", "EUR", "GBP", "CAD", "JPY", "CHF", "AUD", "BTC", "XBT", "ETH"
+    };
+
+    // Assets whose v1 WebSocket code differs from the common ticker
+    struct AssetAlias {
+        const char* common;
+        const char* legacy;
+    };
+    const std::array<AssetAlias, 2> LegacyAssets = { {
+        { "BTC", "XBT" },
+        { "DOGE", "XDG" },
+    } };
+}
+
+bool KrakenMessageParser::parse(const QString& frame, Message& out) {
+    return parse(frame.toUtf8(), out);
+}
+
+bool KrakenMessageParser::parse(const QByteArray& frame, Message& out) {
+    out.clear();
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(frame, &parseError);
+    if (parseError.error != QJsonParseError::NoError)
+        return false;
+
+    if (doc.isObject()) {
+        QJsonObject obj = doc.object();
+        out.event = obj.value("event").toString();
+        if (out.event == "heartbeat") {
+            out.type = MessageType::Heartbeat;
+            return true;
+        }
+        out.type = MessageType::Event;
+        out.eventData = obj;
+        return true;
+    }
+
+    if (!doc.isArray())
+        return false;
+
+    // [channelID, payload, channelName, pair]
+    QJsonArray arr = doc.array();
+    if (arr.size() < 4)
+        return false;
+
+    out.channelId = arr.at(0).toInt(-1);
+    out.channelName = arr.at(arr.size() - 2).toString();
+    out.pair = arr.at(arr.size() - 1).toString();
+
+    if (out.channelName.startsWith("book")) {
+        out.type = MessageType::Book;
+
+        // Snapshot: {"as":[...],"bs":[...]}; update: {"a":[...]} and/or {"b":[...],"c":"checksum"}
+        // Ask and bid updates may arrive as two separate objects in one frame.
+        for (qsizetype i = 1; i < arr.size() - 2; ++i) {
+            QJsonObject payload = arr.at(i).toObject();
+            for (auto it = payload.constBegin(); it != payload.constEnd(); ++it) {
+                const QString& key = it.key();
+                if (key == "as" || key == "bs") {
+                    out.book.snapshot = true;
+                    if (!parseBookLevels(it.value().toArray(), key == "as" ? out.book.asks : out.book.bids))
+                        return false;
+                }
+                else if (key == "a" || key == "b") {
+                    if (!parseBookLevels(it.value().toArray(), key == "a" ? out.book.asks : out.book.bids))
+                        return false;
+                }
+                else if (key == "c") {
+                    bool ok = false;
+                    out.book.checksum = it.value().toString().toUInt(&ok);
+                    out.book.hasChecksum = ok;
+                }
+            }
+        }
+        return true;
+    }
+
+    if (out.channelName == "spread") {
+        // [bid, ask, timestamp, bidVolume, askVolume]
+        QJsonArray spread = arr.at(1).toArray();
+        if (spread.size() < 3) return false;
+        out.type = MessageType::Quote;
+        out.quote.bid = spread.at(0).toString().toDouble();
+        out.quote.ask = spread.at(1).toString().toDouble();
+        out.quote.timestamp = static_cast<qint64>(spread.at(2).toString().toDouble() * 1000);
+        out.quote.bidSize = spread.at(3).toString().toDouble();
+        out.quote.askSize = spread.at(4).toString().toDouble();
+        return true;
+    }
+
+    if (out.channelName == "ticker") {
+        // {"a":[price, wholeLotVolume, lotVolume], "b":[...], ...}
+        QJsonObject ticker = arr.at(1).toObject();
+        QJsonArray ask = ticker.value("a").toArray();
+        QJsonArray bid = ticker.value("b").toArray();
+        if (ask.isEmpty() || bid.isEmpty()) return false;
+        out.type = MessageType::Quote;
+        out.quote.ask = ask.at(0).toString().toDouble();
+        out.quote.bid = bid.at(0).toString().toDouble();
+        out.quote.askSize = ask.at(2).toString().toDouble();
+        out.quote.bidSize = bid.at(2).toString().toDouble();
+        return true;
+    }
+
+    if (out.channelName != "trade")
+        return true;
+
+    out.type = MessageType::Trade;
+
+    // Each trade: [price, volume, time, side, orderType, misc]
+    QJsonArray trades = arr.at(1).toArray();
+    out.trades.reserve(trades.size());
+
+    for (const auto& tradeVal : trades) {
+        QJsonArray trade = tradeVal.toArray();
+
+        bool priceOk = false;
+        double price = trade.at(0).toString().toDouble(&priceOk);
+        if (!priceOk) continue;
+
+        bool tsOk = false;
+        double timestamp = trade.at(2).toString().toDouble(&tsOk);
+        if (!tsOk) continue;
+
+        TickRecord record;
+        record.timestamp = static_cast<qint64>(timestamp * 1000);
+        record.price = price;
+        record.volume = trade.at(1).toString().toDouble();
+
+        QString side = trade.at(3).toString();
+        record.side = side.isEmpty() ? 0 : side.at(0).toLatin1();
+
+        out.trades.push_back(record);
+    }
+
+    return true;
+}
+
+bool KrakenMessageParser::parseBookLevels(const QJsonArray& levels, std::vector<BookLevelUpdate>& out) {
+    // Each level: [price, volume, timestamp] plus an optional "r" republish flag
+    for (const auto& levelVal : levels) {
+        QJsonArray level = levelVal.toArray();
+        if (level.size() < 2) return false;
+
+        QByteArray price = level.at(0).toString().toLatin1();
+        QByteArray volume = level.at(1).toString().toLatin1();
+
+        BookLevelUpdate update;
+        if (!OrderBook::parseDecimal(price.constData(), price.constData() + price.size(), update.price, update.priceDecimals))
+            return false;
+        if (!OrderBook::parseDecimal(volume.constData(), volume.constData() + volume.size(), update.volume, update.volumeDecimals))
+            return false;
+        out.push_back(update);
+    }
+    return true;
+}
+
+QString KrakenMessageParser::normalizeSymbol(const QString& symbol) {
+    QString sym = symbol.toUpper();
+    sym.remove('/');
+    return sym;
+}
+
+QString KrakenMessageParser::splitPair(const QString& normalized) {
+    for (const char* quote : QuoteCurrencies) {
+        const qsizetype length = static_cast<qsizetype>(qstrlen(quote));
+        if (normalized.size() > length && normalized.endsWith(QLatin1String(quote)))
+            return normalized.left(normalized.size() - length) + '/' + QLatin1String(quote);
+    }
+    return normalized;
+}
+
+QString KrakenMessageParser::toKrakenSymbol(const QString& uiSymbol) {
+    // v1 pairs keep Kraken's legacy asset codes on both sides ("XBT/USD", "ETH/XBT")
+    QStringList assets = splitPair(normalizeSymbol(uiSymbol)).split('/');
+    for (QString& asset : assets) {
+        for (const AssetAlias& alias : LegacyAssets) {
+            if (asset == QLatin1String(alias.common))
+                asset = QLatin1String(alias.legacy);
+        }
+    }
+    return assets.join('/');
+}
+
+QString KrakenMessageParser::fromKrakenSymbol(const QString& krakenSymbol) {
+    QStringList assets = splitPair(normalizeSymbol(krakenSymbol)).split('/');
+    for (QString& asset : assets) {
+        for (const AssetAlias& alias : LegacyAssets) {
+            if (asset == QLatin1String(alias.legacy))
+                asset = QLatin1String(alias.common);
+        }
+    }
+    return assets.join(QString());
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <vector>
+#include "MarketTick.h"
+#include "OrderBook.h"
+
+// Parses raw Kraken v1 WebSocket frames into trade records, book updates and quotes.
+// Shared by the GUI, the headless collector and the benchmark so they all
+// exercise exactly the same parse path.
+class KrakenMessageParser {
+public:
+    enum class MessageType {
+        Unknown,
+        Heartbeat,
+        Event,
+        Trade,
+        Book,
+        Quote       // spread or ticker channel
+    };
+
+    // Best bid/ask from the spread or ticker channel
+    struct Quote {
+        double bid = 0.0;
+        double ask = 0.0;
+        double bidSize = 0.0;
+        double askSize = 0.0;
+        qint64 timestamp = 0;   // ms; ticker frames carry none (0)
+    };
+
+    struct Message {
+        MessageType type = MessageType::Unknown;
+        int channelId = -1;
+        QString event;          // "systemStatus", "subscriptionStatus", ...
+        QJsonObject eventData;  // full event object for Event messages
+        QString channelName;    // "trade", "book-10", ...
+        QString pair;           // Kraken pair, e.g. "XBT/USD"
+        std::vector<TickRecord> trades;
+        BookUpdate book;
+        Quote quote;
+
+        void clear() {
+            type = MessageType::Unknown;
+            channelId = -1;
+            event.clear();
+            eventData = QJsonObject();
+            channelName.clear();
+            pair.clear();
+            trades.clear(); // keeps capacity for the next frame
+            book.clear();
+            quote = Quote();
+        }
+    };
+
+    // Parse one frame into 'out'. Returns false for malformed frames.
+    static bool parse(const QByteArray& frame, Message& out);
+    static bool parse(const QString& frame, Message& out);
+
+    // Symbol mapping between UI symbols ("BTCUSD") and Kraken pairs ("XBT/USD")
+    static QString normalizeSymbol(const QString& symbol);
+    // "SOLUSD" -> "SOL/USD" on a known quote currency; returned unchanged if none matches
+    static QString splitPair(const QString& normalized);
+    static QString toKrakenSymbol(const QString& uiSymbol);
+    static QString fromKrakenSymbol(const QString& krakenSymbol);
+
+private:
+    static bool parseBookLevels(const QJsonArray& levels, std::vector<BookLevelUpdate>& out);
+};
@@ -1,5 +1,8 @@
 #include "LightningTradeMainWindow.h"
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QTextCursor>
 #include <QString>
 #include <QVBoxLayout>
@@ -15,6 +18,7 @@
 #include <QJsonArray>
 #include <QMap>
 #include <chrono>
+#include <limits>
 
 // Constructor
 LightningTradeMainWindow::LightningTradeMainWindow(QWidget* parent)
@@ -22,21 +26,28 @@ LightningTradeMainWindow::LightningTradeMainWindow(QWidget* parent)
     generator(nullptr),
     realTimeTimer(nullptr),
     totalUpdates(0),
-    totalUpdateTime(0.0)
+    totalUpdateTime(0.0),
+    websocketClient(nullptr)
 {
     setupUI();
-    previousSymbol = symbolSelector->currentText();
 
     initializeComponents();
     connectSignals();
     updateStatusBar("Ready - Lightning Trade Research App");
-    startWebSocket();
+    // The supervisor only runs while live, so mock data never records feed gaps
+    if (currentDataSource == DataSourceMode::LiveFeed)
+        startWebSocket();
     
 
 }
 
 // Destructor
 LightningTradeMainWindow::~LightningTradeMainWindow() {
+    saveState();
+
+    // The client is a Qt child and outlives our members; stop it calling back into them
+    if (websocketClient)
+        websocketClient->disconnect(this);
     delete generator;
 }
 
@@ -46,6 +57,22 @@ void LightningTradeMainWindow::switchDataSource(DataSourceMode mode) {
 
     currentDataSource = mode;
     realTimeTimer->stop();
+    ++backfillGeneration;
+
+    // Background buffers hold one source's data; don't mix mock and live ticks
+    tickStore.clear();
+    topOfBook.clear();
+    renderedQuoteVersion = 0;
+    conflator.clear();
+    statistics.clear();
+    correlation.clear();
+    alerts.resetPrices();
+    for (auto& profile : volumeProfiles) {
+        if (profile) profile->reset();
+    }
+    for (auto& indicators : symbolIndicators) {
+        if (indicators) indicators->reset();
+    }
 
     if (mode == DataSourceMode::MockData) {
         addLogMessage("Switched to Mock Data Generator");
@@ -57,9 +84,11 @@ void LightningTradeMainWindow::switchDataSource(DataSourceMode mode) {
         // Clear and setup main chart
         mainChartManager->clearChart();
         mainChartManager->setSymbol(symbol);
+        backfillSymbol(currentSymbolId);
+        mainChartManager->showSymbol(currentSymbol, tickStore.buffer(currentSymbolId));
 
         realTimeTimer->start(updateIntervalSpinBox->value());
-        websocketClient->disconnectFromServer();
+        connectionSupervisor->stop();
     }
     else if (mode == DataSourceMode::LiveFeed) {
         addLogMessage("Switched to Live Feed (Kraken WebSocket)");
@@ -69,6 +98,8 @@ void LightningTradeMainWindow::switchDataSource(DataSourceMode mode) {
 
         // Clear main chart
         mainChartManager->clearChart();
+        backfillSymbol(currentSymbolId);
+        mainChartManager->showSymbol(currentSymbol, tickStore.buffer(currentSymbolId));
 
         startWebSocket();
     }
@@ -90,6 +121,7 @@ void LightningTradeMainWindow::setupUI() {
     setupControlPanel();
     setupDataDisplay();
     setupLogDisplay();
+    setupCorrelationDisplay();
     setupChartDisplay();
 	//initializeCharts();
 
@@ -99,11 +131,12 @@ void LightningTradeMainWindow::setupUI() {
 
     rightSplitter->addWidget(controlGroup);   // Controls at top
     rightSplitter->addWidget(dataGroup);      // Data in middle
+    rightSplitter->addWidget(correlationGroup);
     rightSplitter->addWidget(logGroup);       // Log at bottom
 
     // Set splitter proportions
     mainSplitter->setSizes({ 600, 300 });       // Chart gets more space
-    rightSplitter->setSizes({ 200, 150, 200 }); // Balanced right side
+    rightSplitter->setSizes({ 200, 150, 150, 200 }); // Balanced right side
 
     // Main layout
     QVBoxLayout* mainLayout = new QVBoxLayout(centralWidget);
@@ -180,6 +213,41 @@ void LightningTradeMainWindow::setupControlPanel() {
     controlLayout->addWidget(generateBatchButton, 7, 0, 1, 2);
     controlLayout->addWidget(clearChartButton, 8, 0, 1, 2);
 
+    // Additional watched symbols (comma separated), all streamed in the background
+    watchSymbolEdit = new QLineEdit();
+    watchSymbolEdit->setPlaceholderText("Watch symbols, e.g. SOLUSD,ADAUSD");
+    watchSymbolButton = new QPushButton("Watch");
+    controlLayout->addWidget(watchSymbolEdit, 9, 0);
+    controlLayout->addWidget(watchSymbolButton, 9, 1);
+
+    // Grid of live charts for every watched symbol
+    dashboardCheckBox = new QCheckBox("Dashboard (all watched symbols)");
+    controlLayout->addWidget(dashboardCheckBox, 10, 0, 1, 2);
+
+    // What the chart sheds when live trades outpace the frame rate.
+    // Blocking is not offered: the feed and the chart share the GUI thread.
+    controlLayout->addWidget(new QLabel("Backpressure:"), 11, 0);
+    backpressureSelector = new QComboBox(this);
+    backpressureSelector->addItem("Conflate");
+    backpressureSelector->addItem("Drop oldest");
+    controlLayout->addWidget(backpressureSelector, 11, 1);
+
+    indicatorsCheckBox = new QCheckBox("Indicators (EMA/SMA/VWAP/Bollinger)");
+    controlLayout->addWidget(indicatorsCheckBox, 12, 0, 1, 2);
+
+    // Price alert for the selected symbol; direction follows the last trade
+    alertPriceEdit = new QLineEdit(this);
+    alertPriceEdit->setPlaceholderText("Alert price, e.g. 65000");
+    addAlertButton = new QPushButton("Add Alert", this);
+    controlLayout->addWidget(alertPriceEdit, 13, 0);
+    controlLayout->addWidget(addAlertButton, 13, 1);
+
+    // Buffered ticks of the selected symbol, or just the plotted window
+    exportTicksButton = new QPushButton("Export Ticks...", this);
+    exportChartButton = new QPushButton("Export Chart...", this);
+    controlLayout->addWidget(exportTicksButton, 14, 0);
+    controlLayout->addWidget(exportChartButton, 14, 1);
+
     stopRealtimeButton->setEnabled(false);
 }
 
@@ -192,18 +260,42 @@ void LightningTradeMainWindow::setupDataDisplay() {
     bidAskSpreadLabel = new QLabel("Bid/Ask Spread: --");
     lastUpdateLabel = new QLabel("Last Update: --");
     performanceLabel = new QLabel("Avg Update Time: --");
+    conflationLabel = new QLabel("Conflated: 0  Dropped: 0");
+    indicatorLabel = new QLabel("RSI: --  Volatility: --");
+    profileLabel = new QLabel("POC: --  Value Area: --");
+    statisticsLabel = new QLabel("Trades: --");
+    alertLabel = new QLabel("Alerts: none fired");
 
     currentPriceLabel->setStyleSheet("font-size: 16px; font-weight: bold; color: #2196F3;");
     currentVolumeLabel->setStyleSheet("font-size: 14px; color: #4CAF50;");
     bidAskSpreadLabel->setStyleSheet("font-size: 14px; color: #FF9800;");
     lastUpdateLabel->setStyleSheet("font-size: 12px; color: #757575;");
     performanceLabel->setStyleSheet("font-size: 12px; color: #9C27B0;");
+    conflationLabel->setStyleSheet("font-size: 12px; color: #757575;");
+    indicatorLabel->setStyleSheet("font-size: 12px; color: #757575;");
+    profileLabel->setStyleSheet("font-size: 12px; color: #757575;");
+    statisticsLabel->setStyleSheet("font-size: 12px; color: #757575;");
+    statisticsLabel->setWordWrap(true);
+    alertLabel->setStyleSheet("font-size: 12px; font-weight: bold; color: #F44336;");
 
     dataLayout->addWidget(currentPriceLabel);
     dataLayout->addWidget(currentVolumeLabel);
     dataLayout->addWidget(bidAskSpreadLabel);
     dataLayout->addWidget(lastUpdateLabel);
     dataLayout->addWidget(performanceLabel);
+    dataLayout->addWidget(conflationLabel);
+    dataLayout->addWidget(indicatorLabel);
+    dataLayout->addWidget(profileLabel);
+    dataLayout->addWidget(statisticsLabel);
+    dataLayout->addWidget(alertLabel);
+}
+
+void LightningTradeMainWindow::setupCorrelationDisplay() {
+    correlationGroup = new QGroupBox("Return Correlation (1s bars)");
+    QVBoxLayout* correlationLayout = new QVBoxLayout(correlationGroup);
+
+    correlationHeatmap = new CorrelationHeatmap(correlation, tickStore);
+    correlationLayout->addWidget(correlationHeatmap);
 }
 
 void LightningTradeMainWindow::setupLogDisplay() {
@@ -239,7 +331,17 @@ void LightningTradeMainWindow::initializeComponents() {
 
     // Create SINGLE main chart manager
     mainChartManager = std::make_unique<ChartManager>(this);
-    chartStack->addWidget(mainChartManager->getChartView());
+    mainChartManager->setFeedGaps(&tickStore.gaps());
+    depthHeatmap = new DepthHeatmap(this);
+    priceSplitter = new QSplitter(Qt::Horizontal, this);
+    priceSplitter->addWidget(mainChartManager->getChartView());
+    priceSplitter->addWidget(depthHeatmap);
+    priceSplitter->setSizes({ 450, 150 });
+    chartStack->addWidget(priceSplitter);
+
+    const QString exchangeName = qEnvironmentVariable("LIGHTNINGTRADE_EXCHANGE");
+    if (!exchangeName.isEmpty() && !Exchanges::fromName(exchangeName, exchange))
+        qWarning() << "Unknown LIGHTNINGTRADE_EXCHANGE" << exchangeName << "- using" << Exchanges::name(exchange);
 
     websocketClient = new WebSocketClient(this);
 
@@ -248,13 +350,102 @@ void LightningTradeMainWindow::initializeComponents() {
     connect(websocketClient, &WebSocketClient::errorOccurred, this, &LightningTradeMainWindow::onWebSocketError);
     connect(websocketClient, &WebSocketClient::messageReceived, this, &LightningTradeMainWindow::handleWebSocketMessage);
 
+    connectionSupervisor = std::make_unique<ConnectionSupervisor>(*websocketClient);
+    ConnectionSupervisor::Callbacks supervisorCallbacks;
+    supervisorCallbacks.lost = [this](qint64 lastDataMs) { onFeedLost(lastDataMs); };
+    supervisorCallbacks.restored = [this](qint64 nowMs) { onFeedRestored(nowMs); };
+    supervisorCallbacks.retrying = [this](int attempt, int delayMs) {
+        addLogMessage(QString("Reconnecting in %1 ms (attempt %2)").arg(delayMs).arg(attempt));
+    };
+    supervisorCallbacks.stale = [this](qint64 silentMs) {
+        addLogMessage(QString("No data for %1 ms, dropping the connection").arg(silentMs));
+    };
+    supervisorCallbacks.resolved = [this](const QList<QHostAddress>& addresses) {
+        QStringList list;
+        for (const QHostAddress& address : addresses) {
+            list.append(address.toString());
+        }
+        addLogMessage(QString("Endpoint resolved: %1").arg(list.join(", ")));
+    };
+    connectionSupervisor->setCallbacks(supervisorCallbacks);
+
+    // Every symbol in the selector is watched; frames are routed per symbol by channelID (or pair)
+    subscriptionManager = std::make_unique<SubscriptionManager>(tickStore,
+        [this](const QString& message) { websocketClient->sendMessage(message); },
+        Exchanges::subscriptionFormat(exchange));
+    subscriptionManager->setDefaultTradeConsumer(
+        [this](int symbolId, const std::vector<TickRecord>& trades) { onLiveTrades(symbolId, trades); });
+
+    // L2 book (top 10, checksummed) alongside trades for every watched pair
+    subscriptionManager->addChannel(QJsonObject{ {"name", "book"}, {"depth", 10} });
+    subscriptionManager->setBookConsumer(
+        [this](int symbolId, const BookUpdate& update) { onBookUpdate(symbolId, update); });
+
+    // Exchange best bid/ask; the book only fills in while it is synced
+    subscriptionManager->addChannel(QJsonObject{ {"name", "spread"} });
+    subscriptionManager->setQuoteConsumer(
+        [this](int symbolId, const KrakenMessageParser::Quote& quote) { onQuote(symbolId, quote); });
+
+    // Rejections come back as acknowledgements in the venue's own format
+    subscriptionManager->setErrorConsumer([this](const SubscriptionStatus& status) {
+        addLogMessage(QString("Subscription rejected for %1: %2")
+            .arg(status.pair.isEmpty() ? QString("(unknown pair)") : status.pair, status.errorMessage));
+    });
+
+    alerts.setFiredCallback([this](const PriceAlertEngine::FiredAlert& fired) { onAlertFired(fired); });
+
+    // Closed bars update the correlation matrix in place
+    barAggregator.setBarClosedCallback(
+        [this](int symbolId, const Bar& bar) { correlation.onBarClosed(symbolId, bar); });
+
+    // Trades and bid/ask are drawn at frame rate, however fast the feed runs
+    frameTimer = new QTimer(this);
+    frameTimer->setInterval(33);
+
+    QStringList watchList;
+    for (int i = 0; i < symbolSelector->count(); ++i) {
+        watchList.append(symbolSelector->itemText(i));
+    }
+    subscriptionManager->watch(watchList);
+
+    // Multi-chart dashboard shares the tick store and renders on the main frame tick
+    dashboard = new ChartDashboard(tickStore, this);
+    dashboard->setMaxDataPoints(maxDataPointsSpinBox->value());
+    dashboard->setDarkTheme(darkThemeCheckBox->isChecked());
+    dashboard->setTopOfBook(&topOfBook);
+    dashboard->setSymbols(subscriptionManager->watchedSymbols());
+    chartStack->addWidget(dashboard);
+
+    QString busName = qEnvironmentVariable("LIGHTNINGTRADE_BUS");
+    if (!busName.isEmpty()) {
+        QString error;
+        if (tickBus.open(busName, 1 << 16, &error))
+            addLogMessage(QString("Publishing live trades on tick bus %1").arg(busName));
+        else
+            addLogMessage(QString("Tick bus unavailable: %1").arg(error));
+    }
+
+    // Resume from the last snapshot before the first symbol is shown
+    restoreState();
+    snapshotTimer = new QTimer(this);
+    snapshotTimer->setInterval(5000);
+
     // Set initial values
     currentSymbol = symbolSelector->currentText();
+    currentSymbolId = tickStore.symbolId(currentSymbol);
     mainChartManager->setSymbol(currentSymbol);
     mainChartManager->setMaxDataPoints(maxDataPointsSpinBox->value());
     mainChartManager->setDarkTheme(darkThemeCheckBox->isChecked());
+    depthHeatmap->setDarkTheme(darkThemeCheckBox->isChecked());
+    correlationHeatmap->setDarkTheme(darkThemeCheckBox->isChecked());
+    depthHeatmap->setBook(&orderBookFor(currentSymbolId));
+    mainChartManager->setVolumeProfile(&volumeProfileFor(currentSymbolId));
+    mainChartManager->setIndicatorSource(&indicatorsFor(currentSymbolId));
 
     addLogMessage("Lightning Trade Research Platform initialized successfully.");
+
+    backfillSymbol(currentSymbolId);
+    mainChartManager->showSymbol(currentSymbol, tickStore.buffer(currentSymbolId));
 }
 
 void LightningTradeMainWindow::connectSignals() {
@@ -262,6 +453,19 @@ void LightningTradeMainWindow::connectSignals() {
     connect(stopRealtimeButton, &QPushButton::clicked, this, &LightningTradeMainWindow::stopRealtimeFeed);
     connect(generateBatchButton, &QPushButton::clicked, this, &LightningTradeMainWindow::generateBatchData);
     connect(clearChartButton, &QPushButton::clicked, this, &LightningTradeMainWindow::clearChart);
+    connect(watchSymbolButton, &QPushButton::clicked, this, &LightningTradeMainWindow::watchSymbolsFromInput);
+    connect(watchSymbolEdit, &QLineEdit::returnPressed, this, &LightningTradeMainWindow::watchSymbolsFromInput);
+    connect(addAlertButton, &QPushButton::clicked, this, &LightningTradeMainWindow::addAlertFromInput);
+    connect(alertPriceEdit, &QLineEdit::returnPressed, this, &LightningTradeMainWindow::addAlertFromInput);
+    connect(exportTicksButton, &QPushButton::clicked, this, [this]() { exportData(false); });
+    connect(exportChartButton, &QPushButton::clicked, this, [this]() { exportData(true); });
+    connect(dashboardCheckBox, &QCheckBox::toggled, this, [this](bool enabled) {
+        if (enabled)
+            chartStack->setCurrentWidget(dashboard);
+        else
+            chartStack->setCurrentWidget(priceSplitter);
+        chartGroup->setTitle(enabled ? "Dashboard" : "Price Chart");
+    });
 
     connect(symbolSelector, QOverload<const QString&>::of(&QComboBox::currentTextChanged),
         this, &LightningTradeMainWindow::onSymbolChanged);
@@ -272,6 +476,30 @@ void LightningTradeMainWindow::connectSignals() {
     connect(darkThemeCheckBox, &QCheckBox::toggled, this, &LightningTradeMainWindow::onThemeChanged);
 
     connect(realTimeTimer, &QTimer::timeout, this, &LightningTradeMainWindow::generateRealtimeUpdate);
+    // The one render tick for the main chart and every dashboard panel
+    connect(frameTimer, &QTimer::timeout, this, [this]() {
+        renderFrame();
+        dashboard->renderFrame();
+
+        // Quiet symbols still close their bars on time
+        barAggregator.flush(QDateTime::currentMSecsSinceEpoch());
+        correlationHeatmap->refresh();
+        reportExportProgress();
+    });
+    frameTimer->start();
+    connect(snapshotTimer, &QTimer::timeout, this, &LightningTradeMainWindow::saveState);
+    snapshotTimer->start();
+    connect(indicatorsCheckBox, &QCheckBox::toggled, this, [this](bool enabled) {
+        // The symbol's indicators are always current; the chart only redraws them
+        mainChartManager->setIndicatorsEnabled(enabled);
+        if (!enabled)
+            indicatorLabel->setText("RSI: --  Volatility: --");
+    });
+    connect(backpressureSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
+        this, [this](int index) {
+            conflator.setPolicy(index == 1 ? BackpressurePolicy::DropOldest : BackpressurePolicy::Conflate);
+            addLogMessage(QString("Backpressure policy: %1").arg(backpressureSelector->currentText()));
+        });
     connect(dataSourceSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
         this, [this](int index) {
             if (index == 0)
@@ -308,8 +536,10 @@ void LightningTradeMainWindow::generateBatchData() {
 
     QString currentSymbol = symbolSelector->currentText();
 
+    MockDataGenerator* symbolGenerator = generatorFor(currentSymbolId);
+
     for (int i = 0; i < 20; ++i) {
-        MarketTick tick = generator->generateTick(currentSymbol);
+        MarketTick tick = symbolGenerator->generateTick(currentSymbol);
         tick.timestamp = QDateTime::currentDateTime().addSecs(-20 + i).toMSecsSinceEpoch();
 
         // Use main chart manager
@@ -326,6 +556,9 @@ void LightningTradeMainWindow::generateBatchData() {
 
 void LightningTradeMainWindow::clearChart() {
     mainChartManager->clearChart();
+    tickStore.buffer(currentSymbolId).clear();
+    indicatorsFor(currentSymbolId).reset();
+    ++backfillGeneration;
     currentPriceLabel->setText("Price: --");
     currentVolumeLabel->setText("Volume: --");
     bidAskSpreadLabel->setText("Bid/Ask Spread: --");
@@ -341,12 +574,32 @@ void LightningTradeMainWindow::generateRealtimeUpdate() {
 
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    QString currentSymbol = symbolSelector->currentText();
-    MarketTick tick = generator->generateTick(currentSymbol);
-
-    // Use main chart manager
-    mainChartManager->addMarketTick(tick);
-    updateDataDisplay(tick);
+    // Every watched symbol ticks in the background so switching is instant
+    for (const QString& symbol : subscriptionManager->watchedSymbols()) {
+        int symbolId = tickStore.symbolId(symbol);
+        MarketTick tick = generatorFor(symbolId)->generateTick(symbol);
+
+        TickRecord record;
+        record.timestamp = tick.timestamp;
+        record.price = tick.price;
+        record.volume = tick.volume;
+        record.bid = tick.bid;
+        record.ask = tick.ask;
+        tickStore.append(symbolId, record);
+        // Mock quotes go through top-of-book like live ones, for the dashboard's bid/ask lines
+        topOfBook.updateQuote(symbolId, tick.bid, tick.ask, 0.0, 0.0, tick.timestamp);
+        indicatorsFor(symbolId).update(record);
+        volumeProfileFor(symbolId).addTrade(record);
+        statistics.add(symbolId, record);
+        barAggregator.addTrade(symbolId, record);
+        alerts.onTrade(symbolId, record);
+
+        if (symbolId == currentSymbolId) {
+            // Use main chart manager
+            mainChartManager->addMarketTick(tick);
+            updateDataDisplay(tick);
+        }
+    }
 
     auto endTime = std::chrono::high_resolution_clock::now();
     double updateTimeMicros = std::chrono::duration<double, std::micro>(endTime - startTime).count();
@@ -363,17 +616,22 @@ void LightningTradeMainWindow::onSymbolChanged(const QString& symbol) {
         return;
 
     currentSymbol = newSymbol;
+    conflator.reset(currentSymbolId);
+    currentSymbolId = tickStore.symbolId(currentSymbol);
+    renderedQuoteVersion = 0;
 
-    // Update the main chart manager
-    mainChartManager->setSymbol(currentSymbol);
-    mainChartManager->clearChart();
+    // Re-point the chart at the symbol's background buffer in one bulk load
+    backfillSymbol(currentSymbolId);
+    mainChartManager->setIndicatorSource(&indicatorsFor(currentSymbolId));
+    mainChartManager->showSymbol(currentSymbol, tickStore.buffer(currentSymbolId));
+    depthHeatmap->setBook(&orderBookFor(currentSymbolId));
+    mainChartManager->setVolumeProfile(&volumeProfileFor(currentSymbolId));
 
     updateStatusBar(QString("Symbol changed to %1").arg(symbol));
     addLogMessage(QString("Switched to symbol: %1").arg(symbol));
 
-    if (currentDataSource == DataSourceMode::LiveFeed && websocketClient->isConnected()) {
-        subscribeToSymbol(currentSymbol);
-    }
+    // Already-watched symbols keep their subscription; this only adds new ones
+    subscribeToSymbol(currentSymbol);
 }
 
 
@@ -388,88 +646,409 @@ void LightningTradeMainWindow::onUpdateIntervalChanged(int interval) {
 
 void LightningTradeMainWindow::onMaxDataPointsChanged(int points) {
     mainChartManager->setMaxDataPoints(points);
+    mainChartManager->showSymbol(currentSymbol, tickStore.buffer(currentSymbolId));
+    dashboard->setMaxDataPoints(points);
     addLogMessage(QString("Max data points changed to %1").arg(points));
 }
 
 void LightningTradeMainWindow::onThemeChanged(bool darkTheme) {
     mainChartManager->setDarkTheme(darkTheme);
+    depthHeatmap->setDarkTheme(darkTheme);
+    correlationHeatmap->setDarkTheme(darkTheme);
+    dashboard->setDarkTheme(darkTheme);
     addLogMessage(QString("Theme changed to %1").arg(darkTheme ? "Dark" : "Light"));
 }
 
 
 void LightningTradeMainWindow::handleWebSocketMessage(const QString& message) {
+    // The venue is picked once per frame; everything below is compiled per adapter
+    withExchange(exchange, [&]<ExchangeAdapter Adapter>() { handleFeedMessage<Adapter>(message); });
+}
+
+template <ExchangeAdapter Adapter>
+void LightningTradeMainWindow::handleFeedMessage(const QString& message) {
+    if (!Adapter::parse(message.toUtf8(), parsedMessage))
+        return;
+
+    if (parsedMessage.type == FeedMessageType::Heartbeat)
+        return;
+
+    // Subscription events keep the channel map current even while showing mock data
+    if (parsedMessage.type == FeedMessageType::Event) {
+        subscriptionManager->handleEvent(parsedMessage.eventData);
+        addLogMessage("Event: " + parsedMessage.event);
+        return;
+    }
+
     if (currentDataSource != DataSourceMode::LiveFeed)
         return;
 
-    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    // Routed by channelID to the per-symbol consumer (onLiveTrades)
+    subscriptionManager->dispatch(parsedMessage);
+}
 
-    if (doc.isObject()) {
-        QString eventType = doc.object().value("event").toString();
-        if (eventType == "heartbeat") return;
-        addLogMessage("Event: " + eventType);
+void LightningTradeMainWindow::onLiveTrades(int symbolId, const std::vector<TickRecord>& trades) {
+    // Stamp each trade with the prevailing quote so stored ticks carry real bid/ask
+    const TopOfBook& top = topOfBook.entry(symbolId);
+    VolumeProfile& profile = volumeProfileFor(symbolId);
+    SymbolIndicators& indicators = indicatorsFor(symbolId);
+    const int busId = tickBus.isOpen() ? tickBus.symbolId(tickStore.symbolName(symbolId)) : -1;
+    for (TickRecord trade : trades) {
+        trade.bid = top.bid;
+        trade.ask = top.ask;
+        tickStore.append(symbolId, trade);
+        topOfBook.updateTrade(symbolId, trade);
+        profile.addTrade(trade);
+        indicators.update(trade);
+        statistics.add(symbolId, trade);
+        barAggregator.addTrade(symbolId, trade);
+        alerts.onTrade(symbolId, trade);
+        if (busId >= 0) tickBus.publish(busId, trade);
     }
-    else if (doc.isArray()) {
-        QJsonArray arr = doc.array();
-        if (arr.size() >= 4) {
-            QString krakenPair = arr.at(3).toString(); // e.g., "XBT/USD"
-            QString uiSymbol = fromKrakenSymbol(krakenPair);
 
-            addLogMessage(QString("Received data for %1 (Kraken: %2)").arg(uiSymbol).arg(krakenPair));
+    // Background symbols are only buffered; the selected one also feeds the
+    // chart, which drains it once per frame (bid/ask are drawn from topOfBook)
+    if (symbolId != currentSymbolId)
+        return;
 
-            // Only process if this matches our current symbol
-            if (uiSymbol != currentSymbol) {
-                return;
-            }
+    for (const TickRecord& trade : trades) {
+        conflator.push(symbolId, trade);
+    }
+}
+
+void LightningTradeMainWindow::backfillSymbol(int symbolId) {
+    // Only a symbol with nothing buffered yet; the files are read off the GUI thread
+    const TickBuffer& buffer = tickStore.buffer(symbolId);
+    if (!buffer.empty())
+        return;
+    auto pending = backfillRequests.constFind(symbolId);
+    if (pending != backfillRequests.constEnd() && pending.value() == backfillGeneration)
+        return;
+
+    const quint64 generation = backfillGeneration;
+    backfillRequests.insert(symbolId, generation);
+    history.loadAsync(tickStore.symbolName(symbolId), buffer.capacity(), this,
+        [this, symbolId, generation](bool found, const HistoryLoader::Result& result) {
+            if (backfillRequests.value(symbolId) == generation)
+                backfillRequests.remove(symbolId);
+            if (found)
+                applyBackfill(symbolId, generation, result);
+        });
+}
+
+void LightningTradeMainWindow::applyBackfill(int symbolId, quint64 generation, const HistoryLoader::Result& result) {
+    // Stale after a data source switch or clear
+    if (generation != backfillGeneration)
+        return;
+
+    // Ticks that arrived while loading stay; history only goes in front of them,
+    // so live or mock ticks are never mixed back in time
+    TickBuffer& buffer = tickStore.buffer(symbolId);
+    std::vector<TickRecord> arrived;
+    buffer.copyTail(buffer.size(), arrived);
+    const qint64 firstArrived = arrived.empty() ? std::numeric_limits<qint64>::max() : arrived.front().timestamp;
+
+    std::vector<TickRecord> merged;
+    merged.reserve(result.ticks.size() + arrived.size());
+    for (const TickRecord& tick : result.ticks) {
+        if (tick.timestamp >= firstArrived) break;
+        merged.push_back(tick);
+    }
+    const size_t backfilled = merged.size();
+    merged.insert(merged.end(), arrived.begin(), arrived.end());
 
-            QJsonArray trades = arr.at(1).toArray();
+    buffer.clear();
+    for (const TickRecord& tick : merged) {
+        buffer.append(tick);
+    }
+    indicatorsFor(symbolId).backfill(merged);
 
-            for (const auto& tradeVal : trades) {
-                QJsonArray trade = tradeVal.toArray();
+    if (symbolId == currentSymbolId) {
+        // The reload already holds whatever the conflator was about to draw
+        conflator.reset(symbolId);
+        mainChartManager->showSymbol(currentSymbol, buffer);
+    }
 
-                bool priceOk = false;
-                double price = trade.at(0).toString().toDouble(&priceOk);
-                if (!priceOk) continue;
+    addLogMessage(QString("Backfilled %1 %2 ticks from %3 (%4) in %5 ms")
+        .arg(backfilled)
+        .arg(tickStore.symbolName(symbolId))
+        .arg(HistoryLoader::sourceName(result.source))
+        .arg(QFileInfo(result.path).fileName())
+        .arg(result.elapsedMs, 0, 'f', 1));
+}
 
-                bool tsOk = false;
-                double timestamp = trade.at(2).toString().toDouble(&tsOk);
-                if (!tsOk) continue;
+void LightningTradeMainWindow::restoreState() {
+    QString error;
+    if (!stateSnapshot.open(&error)) {
+        addLogMessage(QString("State snapshots disabled: %1").arg(error));
+        return;
+    }
 
-                qint64 ts = static_cast<qint64>(timestamp * 1000);
+    QElapsedTimer timer;
+    timer.start();
+    StateSnapshot::View view;
+    if (!stateSnapshot.load(view))
+        return;
 
-                // Add to main chart
-                mainChartManager->addPricePoint(price, ts);
+    // Signals are not connected yet, so this does not clear the store
+    bool live = view.mode == static_cast<quint32>(DataSourceMode::LiveFeed);
+    if (live) {
+        currentDataSource = DataSourceMode::LiveFeed;
+        dataSourceSelector->setCurrentIndex(1);
+    }
 
-                // Create a MarketTick for display update
-                MarketTick displayTick;
-                displayTick.symbol = currentSymbol;
-                displayTick.price = price;
-                displayTick.timestamp = ts;
-                displayTick.volume = trade.at(1).toString().toDouble(); // volume
-                displayTick.bid = price - 1.0; // Approximate
-                displayTick.ask = price + 1.0; // Approximate
+    for (const QString& symbol : view.watched) {
+        if (symbolSelector->findText(symbol) < 0)
+            symbolSelector->addItem(symbol);
+    }
+    subscriptionManager->watch(view.watched);
+    dashboard->setSymbols(subscriptionManager->watchedSymbols());
+
+    size_t restored = 0;
+    size_t caughtUp = 0;
+    for (const StateSnapshot::SymbolState& symbol : view.symbols) {
+        int symbolId = tickStore.symbolId(symbol.symbol);
+        TickBuffer& buffer = tickStore.buffer(symbolId);
+        VolumeProfile& profile = volumeProfileFor(symbolId);
+        // Indicators are computed once over everything replayed, in one batch
+        std::vector<TickRecord> replayed;
+        replayed.reserve(symbol.tickCount);
+        auto replay = [&](const TickRecord& tick) {
+            buffer.append(tick);
+            topOfBook.updateTrade(symbolId, tick);
+            profile.addTrade(tick);
+            statistics.add(symbolId, tick);
+            replayed.push_back(tick);
+        };
 
-                updateDataDisplay(displayTick);
+        // Ticks are appended straight out of the mapping
+        for (size_t i = 0; i < symbol.tickCount; ++i) {
+            replay(symbol.ticks[i]);
+        }
+        restored += symbol.tickCount;
+        if (symbol.hasOpenBar && view.barIntervalMs == barAggregator.interval())
+            barAggregator.restoreOpenBar(symbolId, symbol.openBar);
+
+        // Trades the collector journaled while this instance was down
+        HistoryLoader::Result missed;
+        if (live && history.load(symbol.symbol, buffer.capacity(), missed)) {
+            qint64 last = buffer.empty() ? 0 : buffer.back().timestamp;
+            // The catch-up is capped at the buffer's capacity: if even its oldest tick
+            // is newer than the snapshot, the trades in between are missing
+            if (last > 0 && missed.ticks.size() >= buffer.capacity() && missed.ticks.front().timestamp > last)
+                tickStore.addGap(last, missed.ticks.front().timestamp);
+            for (const TickRecord& tick : missed.ticks) {
+                if (tick.timestamp <= last) continue;
+                replay(tick);
+                barAggregator.addTrade(symbolId, tick);
+                ++caughtUp;
             }
         }
+        indicatorsFor(symbolId).backfill(replayed);
     }
+
+    addLogMessage(QString("Resumed %1 ticks for %2 symbols from a %3 s old snapshot, %4 caught up from history, in %5 ms")
+        .arg(restored)
+        .arg(view.symbols.size())
+        .arg((QDateTime::currentMSecsSinceEpoch() - view.savedAtMs) / 1000)
+        .arg(caughtUp)
+        .arg(timer.nsecsElapsed() / 1e6, 0, 'f', 1));
 }
 
+void LightningTradeMainWindow::saveState() {
+    if (!stateSnapshot.isOpen())
+        return;
+    if (!stateSnapshot.save(tickStore, barAggregator, subscriptionManager->watchedSymbols(),
+            static_cast<quint32>(currentDataSource), QDateTime::currentMSecsSinceEpoch()))
+        addLogMessage("State snapshot failed; the previous one is kept");
+}
 
+void LightningTradeMainWindow::exportData(bool chartWindowOnly) {
+    if (exporter.isRunning()) {
+        addLogMessage(QString("Export to %1 still running").arg(exporter.fileName()));
+        return;
+    }
+
+    QString filename = QFileDialog::getSaveFileName(this,
+        chartWindowOnly ? "Export Chart Window" : "Export Ticks",
+        QString("%1_%2.csv").arg(currentSymbol, QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "CSV (*.csv);;Columnar ticks (*.ltc)");
+    if (filename.isEmpty())
+        return;
+
+    // The snapshot is a flat copy; formatting and disk writes happen off the GUI thread
+    bool started;
+    if (chartWindowOnly) {
+        started = mainChartManager->exportChartData(filename, exporter);
+    }
+    else {
+        const TickBuffer& buffer = tickStore.buffer(currentSymbolId);
+        std::vector<TickRecord> ticks;
+        buffer.copyTail(buffer.size(), ticks);
+        started = exporter.start(filename, currentSymbol, std::move(ticks));
+    }
+
+    if (started) {
+        exportInProgress = true;
+        exportTicksButton->setEnabled(false);
+        exportChartButton->setEnabled(false);
+        addLogMessage(QString("Exporting %1 to %2").arg(currentSymbol, filename));
+    }
+}
+
+void LightningTradeMainWindow::reportExportProgress() {
+    if (!exportInProgress)
+        return;
+
+    TickExporter::Progress progress = exporter.progress();
+    if (progress.state == TickExporter::State::Running) {
+        updateStatusBar(QString("Exporting... %1%").arg(qRound(progress.fraction() * 100)));
+        return;
+    }
+
+    exportInProgress = false;
+    exportTicksButton->setEnabled(true);
+    exportChartButton->setEnabled(true);
+    if (progress.state == TickExporter::State::Finished) {
+        addLogMessage(QString("Exported to %1 in %2 ms")
+            .arg(exporter.fileName())
+            .arg(progress.elapsedMs, 0, 'f', 1));
+        updateStatusBar("Export finished");
+    }
+    else {
+        addLogMessage(QString("Export to %1 failed: %2").arg(exporter.fileName(), exporter.errorString()));
+        updateStatusBar("Export failed");
+    }
+}
+
+SymbolIndicators& LightningTradeMainWindow::indicatorsFor(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= symbolIndicators.size())
+        symbolIndicators.resize(symbolId + 1);
+    if (!symbolIndicators[symbolId])
+        symbolIndicators[symbolId] = std::make_unique<SymbolIndicators>();
+    return *symbolIndicators[symbolId];
+}
+
+VolumeProfile& LightningTradeMainWindow::volumeProfileFor(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= volumeProfiles.size())
+        volumeProfiles.resize(symbolId + 1);
+    if (!volumeProfiles[symbolId])
+        volumeProfiles[symbolId] = std::make_unique<VolumeProfile>();
+    return *volumeProfiles[symbolId];
+}
+
+OrderBook& LightningTradeMainWindow::orderBookFor(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= orderBooks.size())
+        orderBooks.resize(symbolId + 1);
+    if (!orderBooks[symbolId])
+        orderBooks[symbolId] = std::make_unique<OrderBook>(10);
+    return *orderBooks[symbolId];
+}
+
+void LightningTradeMainWindow::onBookUpdate(int symbolId, const BookUpdate& update) {
+    OrderBook& book = orderBookFor(symbolId);
+    if (book.apply(update)) {
+        if (book.isSynced() && book.hasTopOfBook()) {
+            topOfBook.updateQuote(symbolId, book.bestBid(), book.bestAsk(),
+                book.toVolume(book.bid(0).volume), book.toVolume(book.ask(0).volume),
+                QDateTime::currentMSecsSinceEpoch());
+        }
+        return;
+    }
+
+    // Checksum mismatch: the local book has diverged, fetch a fresh snapshot
+    const QString& symbol = tickStore.symbolName(symbolId);
+    addLogMessage(QString("Order book checksum mismatch for %1 (%2 total), resyncing")
+        .arg(symbol).arg(book.checksumFailureCount()));
+    subscriptionManager->resync(symbol, "book");
+}
+
+void LightningTradeMainWindow::onQuote(int symbolId, const KrakenMessageParser::Quote& quote) {
+    // Stamped on receipt like book quotes: the bid/ask series takes points from
+    // both sources and needs one monotonic clock (book frames carry no time of their own)
+    topOfBook.updateQuote(symbolId, quote.bid, quote.ask, quote.bidSize, quote.askSize,
+        QDateTime::currentMSecsSinceEpoch());
+}
+
+void LightningTradeMainWindow::renderFrame() {
+    // Mock ticks are drawn directly by generateRealtimeUpdate at timer rate
+    if (currentDataSource != DataSourceMode::LiveFeed)
+        return;
+
+    TickDelta delta;
+    if (conflator.drain(currentSymbolId, frameScratch, delta)) {
+        mainChartManager->appendTicks(frameScratch);
+
+        const TickRecord& last = frameScratch.back();
+        const TopOfBook* top = topOfBook.find(currentSymbolId);
+
+        MarketTick displayTick;
+        displayTick.symbol = currentSymbol;
+        displayTick.price = last.price;
+        displayTick.timestamp = delta.lastTimestamp;
+        displayTick.volume = delta.volume;
+        displayTick.bid = top ? top->bid : 0.0;   // 0 until the first quote arrives
+        displayTick.ask = top ? top->ask : 0.0;
+        updateDataDisplay(displayTick);
+
+        TickConflator::Counters counters = conflator.totalCounters();
+        conflationLabel->setText(QString("Conflated: %1  Dropped: %2")
+            .arg(counters.conflated).arg(counters.dropped));
+    }
+
+    // Any number of quotes since the last frame collapse into one point
+    const TopOfBook* top = topOfBook.find(currentSymbolId);
+    if (!top || !top->hasQuote() || top->quoteVersion == renderedQuoteVersion)
+        return;
+
+    renderedQuoteVersion = top->quoteVersion;
+    mainChartManager->addBidAskPoints(top->bid, top->ask, top->quoteTime);
+}
 
 
 void LightningTradeMainWindow::onWebSocketDisconnected(){
+    subscriptionManager->setConnected(false);
     addLogMessage("WebSocket disconnected.");
     updateStatusBar("WebSocket connection closed.");
 }
 
 void LightningTradeMainWindow::onWebSocketError(const QString& errorString) {
     qWarning() << "WebSocket error received in MainWindow:" << errorString;
+    addLogMessage("WebSocket error: " + errorString);
 }
 
 void LightningTradeMainWindow::startWebSocket() {
-    QUrl url("wss://ws.kraken.com/");
-    websocketClient->connectToServer(url);
-    addLogMessage("Connecting to Kraken WebSocket via custom client...");
+    // The supervisor owns the connection from here: it retries, and resubscribes via onWebSocketConnected
+    connectionSupervisor->start(QUrl(Exchanges::defaultUrl(exchange)));
+    addLogMessage(QString("Connecting to %1 via custom client...").arg(Exchanges::defaultUrl(exchange)));
+}
+
+void LightningTradeMainWindow::onFeedLost(qint64 lastDataMs) {
+    // Mock ticks keep flowing; an outage must not split their statistics or shade the chart
+    if (currentDataSource != DataSourceMode::LiveFeed)
+        return;
+    tickStore.beginGap(lastDataMs);
+    statistics.breakReturns();
+    addLogMessage(QString("Feed lost; last data at %1")
+        .arg(QDateTime::fromMSecsSinceEpoch(lastDataMs).toString("hh:mm:ss.zzz")));
+    updateStatusBar("Feed down - reconnecting");
+    if (mainChartManager)
+        mainChartManager->refreshFeedGaps();
+}
+
+void LightningTradeMainWindow::onFeedRestored(qint64 nowMs) {
+    if (currentDataSource != DataSourceMode::LiveFeed)
+        return;
+    tickStore.endGap(nowMs);
+    if (!tickStore.gaps().empty()) {
+        const FeedGap& gap = tickStore.gaps().back();
+        addLogMessage(QString("Feed restored after %1 s gap (%2 - %3)")
+            .arg((gap.toTimestamp - gap.fromTimestamp) / 1000.0, 0, 'f', 1)
+            .arg(QDateTime::fromMSecsSinceEpoch(gap.fromTimestamp).toString("hh:mm:ss"))
+            .arg(QDateTime::fromMSecsSinceEpoch(gap.toTimestamp).toString("hh:mm:ss")));
+    }
+    if (mainChartManager)
+        mainChartManager->refreshFeedGaps();
 }
 
 void LightningTradeMainWindow::onWebSocketConnected() {
@@ -477,30 +1056,75 @@ void LightningTradeMainWindow::onWebSocketConnected() {
 
     addLogMessage("WebSocket connected.");
 
-    subscribeToSymbol(currentSymbol);
-    previousSymbol = currentSymbol;
+    // One batched subscribe per channel for the whole watch list
+    subscriptionManager->setConnected(true);
+    addLogMessage(QString("Subscribed to %1").arg(subscriptionManager->watchedSymbols().join(", ")));
 }
 
 
 
 
+MockDataGenerator* LightningTradeMainWindow::generatorFor(int symbolId) {
+    // One generator per symbol: MockDataGenerator restarts its walk on symbol changes
+    if (static_cast<size_t>(symbolId) >= symbolGenerators.size())
+        symbolGenerators.resize(symbolId + 1, nullptr);
+    if (!symbolGenerators[symbolId])
+        symbolGenerators[symbolId] = new MockDataGenerator(this);
+    return symbolGenerators[symbolId];
+}
+
 void LightningTradeMainWindow::updateDataDisplay(const MarketTick& tick) {
     currentPriceLabel->setText(QString("Price: $%1").arg(tick.price, 0, 'f', 2));
-    currentVolumeLabel->setText(QString("Volume: %1").arg(tick.volume));
+    currentVolumeLabel->setText(QString("Volume: %1").arg(tick.volume, 0, 'g', 8));
 
     double bidValue = tick.bid;
     double askValue = tick.ask;
     double spread = askValue - bidValue;
 
-    bidAskSpreadLabel->setText(QString("Bid/Ask: $%1 / $%2 (?%3)")
-        .arg(bidValue, 0, 'f', 2)
-        .arg(askValue, 0, 'f', 2)
-        .arg(spread, 0, 'f', 4));
+    if (bidValue <= 0.0 || askValue <= 0.0) {
+        bidAskSpreadLabel->setText("Bid/Ask: --");
+    }
+    else {
+        bidAskSpreadLabel->setText(QString("Bid/Ask: $%1 / $%2 (?%3)")
+            .arg(bidValue, 0, 'f', 2)
+            .arg(askValue, 0, 'f', 2)
+            .arg(spread, 0, 'f', 4));
+    }
 
     lastUpdateLabel->setText(
         QString("Last Update: %1")
         .arg(QDateTime::fromMSecsSinceEpoch(tick.timestamp).toString("hh:mm:ss.zzz"))
     );
+
+    const VolumeProfile& profile = volumeProfileFor(currentSymbolId);
+    if (!profile.empty()) {
+        profileLabel->setText(QString("POC: $%1  Value Area: $%2 - $%3")
+            .arg(profile.pointOfControl(), 0, 'f', 2)
+            .arg(profile.valueAreaLow(), 0, 'f', 2)
+            .arg(profile.valueAreaHigh(), 0, 'f', 2));
+    }
+    else {
+        profileLabel->setText("POC: --  Value Area: --");
+    }
+
+    StatisticsSnapshot stats = statistics.snapshot(currentSymbolId);
+    statisticsLabel->setText(QString("Trades: %1  Notional: $%2  Return sd: %3 bp\n"
+        "Price p5/p50/p95: %4 / %5 / %6  Size p50/p99: %7 / %8")
+        .arg(stats.trades)
+        .arg(stats.notional, 0, 'f', 0)
+        .arg(stats.returnStdev * 1e4, 0, 'f', 2)
+        .arg(stats.priceQuantiles[0], 0, 'f', 2)
+        .arg(stats.priceQuantiles[2], 0, 'f', 2)
+        .arg(stats.priceQuantiles[4], 0, 'f', 2)
+        .arg(stats.sizeQuantiles[0], 0, 'g', 6)
+        .arg(stats.sizeQuantiles[2], 0, 'g', 6));
+
+    if (mainChartManager->areIndicatorsEnabled()) {
+        const IndicatorValues& values = mainChartManager->latestIndicators();
+        indicatorLabel->setText(QString("RSI: %1  Volatility: %2")
+            .arg(Indicators::ready(values.rsi) ? QString::number(values.rsi, 'f', 1) : QString("--"))
+            .arg(Indicators::ready(values.volatility) ? QString::number(values.volatility * 1e4, 'f', 2) + " bp" : QString("--")));
+    }
 }
 
 void LightningTradeMainWindow::updatePerformanceMetrics(double updateTimeMicros) {
@@ -536,49 +1160,65 @@ void LightningTradeMainWindow::updateStatusBar(const QString& message) {
 
 
 void LightningTradeMainWindow::subscribeToSymbol(const QString& symbol) {
-    if (!websocketClient || !websocketClient->isConnected())
+    if (subscriptionManager->isWatched(normalizeSymbol(symbol)))
         return;
 
-    if (!previousSymbol.isEmpty() && previousSymbol != symbol) {
-        // Unsubscribe previous symbol
-        QString prevKrakenSymbol = toKrakenSymbol(previousSymbol);
+    subscriptionManager->watch({ symbol });
+    addLogMessage(QString("Subscribed to %1 (%2: %3)").arg(symbol).arg(Exchanges::name(exchange)).arg(subscriptionManager->venueSymbol(symbol)));
+}
 
-        QJsonObject unsubscribeMsg{
-            {"event", "unsubscribe"},
-            {"pair", QJsonArray{prevKrakenSymbol}},
-            {"subscription", QJsonObject{{"name", "trade"}}}
-        };
-        websocketClient->sendMessage(QJsonDocument(unsubscribeMsg).toJson(QJsonDocument::Compact));
-        addLogMessage(QString("Unsubscribed from %1").arg(prevKrakenSymbol));
-    }
 
-    QString krakenSymbol = toKrakenSymbol(symbol);
+void LightningTradeMainWindow::unsubscribeFromSymbol(const QString& symbol) {
+    subscriptionManager->unwatch({ symbol });
+    addLogMessage(QString("Unsubscribed from live feed for %1").arg(subscriptionManager->venueSymbol(symbol)));
+}
 
-    QJsonObject subscribeMsg{
-        {"event", "subscribe"},
-        {"pair", QJsonArray{krakenSymbol}},
-        {"subscription", QJsonObject{{"name", "trade"}}}
-    };
+void LightningTradeMainWindow::watchSymbolsFromInput() {
+    QStringList symbols = watchSymbolEdit->text().split(',', Qt::SkipEmptyParts);
+    for (const QString& entry : symbols) {
+        QString symbol = normalizeSymbol(entry.trimmed());
+        if (symbol.isEmpty()) continue;
 
-    websocketClient->sendMessage(QJsonDocument(subscribeMsg).toJson(QJsonDocument::Compact));
-    addLogMessage(QString("Subscribed to %1 (Kraken: %2)").arg(symbol).arg(krakenSymbol));
-    previousSymbol = symbol;
+        if (symbolSelector->findText(symbol) < 0)
+            symbolSelector->addItem(symbol);
+        subscribeToSymbol(symbol);
+    }
+    watchSymbolEdit->clear();
+    dashboard->setSymbols(subscriptionManager->watchedSymbols());
 }
 
+void LightningTradeMainWindow::addAlertFromInput() {
+    bool ok = false;
+    double level = alertPriceEdit->text().trimmed().toDouble(&ok);
+    if (!ok || level <= 0.0) {
+        addLogMessage(QString("Invalid alert price: %1").arg(alertPriceEdit->text()));
+        return;
+    }
 
-void LightningTradeMainWindow::unsubscribeFromSymbol(const QString& symbol) {
-    QString pairToUnsubscribe = symbol;
-    if (pairToUnsubscribe.length() > 3)
-        pairToUnsubscribe.insert(3, "/"); // e.g. "XBTUSD" ? "XBT/USD"
-
-    QJsonObject unsubscribeMessage{
-        {"event", "unsubscribe"},
-        {"pair", QJsonArray{pairToUnsubscribe}},
-        {"subscription", QJsonObject{{"name", "trade"}}}
-    };
-    QJsonDocument doc(unsubscribeMessage);
-    websocketClient->sendMessage(doc.toJson(QJsonDocument::Compact));
-    addLogMessage(QString("Unsubscribed from live feed for %1").arg(pairToUnsubscribe));
+    double last = alerts.lastPrice(currentSymbolId);
+    PriceAlertEngine::Direction direction = last <= 0.0 ? PriceAlertEngine::Direction::Cross
+        : (level > last ? PriceAlertEngine::Direction::Above : PriceAlertEngine::Direction::Below);
+    const char* directionName = direction == PriceAlertEngine::Direction::Above ? "rises to"
+        : (direction == PriceAlertEngine::Direction::Below ? "falls to" : "crosses");
+
+    int id = alerts.add(currentSymbolId, level, direction);
+    alertPriceEdit->clear();
+    addLogMessage(QString("Alert #%1 set: %2 %3 $%4 (%5 active)")
+        .arg(id).arg(currentSymbol).arg(directionName).arg(level, 0, 'f', 2).arg(alerts.alertCount()));
+}
+
+void LightningTradeMainWindow::onAlertFired(const PriceAlertEngine::FiredAlert& fired) {
+    QString message = QString("ALERT #%1: %2 traded $%3 through $%4")
+        .arg(fired.alert.id)
+        .arg(tickStore.symbolName(fired.alert.symbolId))
+        .arg(fired.price, 0, 'f', 2)
+        .arg(fired.alert.level, 0, 'f', 2);
+
+    addLogMessage(message);
+    statusBar()->showMessage(message, 10000);
+    alertLabel->setText(QString("%1 at %2")
+        .arg(message)
+        .arg(QDateTime::fromMSecsSinceEpoch(fired.timestamp).toString("hh:mm:ss")));
 }
 
 void LightningTradeMainWindow::onDataSourceChanged(DataSourceMode newMode) {
@@ -609,9 +1249,8 @@ void LightningTradeMainWindow::onDataSourceChanged(DataSourceMode newMode) {
         chartStack->setCurrentWidget(mainChartManager->getChartView());
     }
     else if (currentDataSource == DataSourceMode::LiveFeed) {
-        if (websocketClient && !websocketClient->isConnected()) {
-            websocketClient->connectToServer(currentSymbol);
-        }
+        if (!connectionSupervisor->isRunning())
+            startWebSocket();
         subscribeToSymbol(currentSymbol);
     }
 
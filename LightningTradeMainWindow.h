@@ -11,14 +11,35 @@
 #include <QPushButton>
 #include <QSpinBox>
 #include <QCheckBox>
+#include <QLineEdit>
 #include <QTextEdit>
 #include <QSplitter>
 #include <QVBoxLayout>
 #include <QStackedWidget>
+#include <QHash>
 #include <chrono>
 #include "MockDataGenerator.h"
 #include "ChartManager.h"
 #include "WebSocketClient.h"
+#include "ConnectionSupervisor.h"
+#include "Exchanges.h"
+#include "TickStore.h"
+#include "SubscriptionManager.h"
+#include "OrderBook.h"
+#include "TopOfBookCache.h"
+#include "TickConflator.h"
+#include "VolumeProfile.h"
+#include "SessionStatistics.h"
+#include "BarAggregator.h"
+#include "CorrelationMatrix.h"
+#include "CorrelationHeatmap.h"
+#include "PriceAlerts.h"
+#include "ChartDashboard.h"
+#include "DepthHeatmap.h"
+#include "HistoryLoader.h"
+#include "StateSnapshot.h"
+#include "TickBus.h"
+#include "TickExporter.h"
 
 namespace Ui {
     class LightningTradeMainWindow;
@@ -50,6 +71,7 @@ private slots:
 private:
     // Core components - REMOVED duplicate chartManager pointer
     MockDataGenerator* generator;
+    std::vector<MockDataGenerator*> symbolGenerators;   // per symbol id, Qt-owned
     QTimer* realTimeTimer;
 
     // UI Components
@@ -68,6 +90,9 @@ private:
     QSpinBox* maxDataPointsSpinBox;
     QCheckBox* darkThemeCheckBox;
     QCheckBox* performanceLoggingCheckBox;
+    QLineEdit* watchSymbolEdit;
+    QPushButton* watchSymbolButton;
+    QCheckBox* dashboardCheckBox;
 
     // Data Display
     QGroupBox* dataGroup;
@@ -88,6 +113,13 @@ private:
     // SINGLE chart manager - no map needed for single main chart
     std::unique_ptr<ChartManager> mainChartManager;
 
+    // Grid of charts for all watched symbols (Qt-owned, lives in chartStack)
+    ChartDashboard* dashboard = nullptr;
+
+    // Price chart with the current symbol's depth heatmap beside it
+    QSplitter* priceSplitter = nullptr;
+    DepthHeatmap* depthHeatmap = nullptr;
+
     enum class DataSourceMode {
         MockData,
         LiveFeed
@@ -96,8 +128,8 @@ private:
     DataSourceMode currentDataSource = DataSourceMode::MockData;
     QComboBox* dataSourceSelector;
 
-    QString previousSymbol;
     QString currentSymbol;
+    int currentSymbolId = -1;
 
     // New helper method
     void switchDataSource(DataSourceMode mode);
@@ -108,12 +140,78 @@ private:
     double totalUpdateTime; // in microseconds
 
     WebSocketClient* websocketClient;
+    // Reconnects with backoff and records outages as tick store gaps
+    std::unique_ptr<ConnectionSupervisor> connectionSupervisor;
+
+    // Live ingest: parsed frames land in per-symbol tick buffers
+    Exchange exchange = Exchange::KrakenV1;   // LIGHTNINGTRADE_EXCHANGE, fixed for the session
+    FeedMessage parsedMessage;
+    TickStore tickStore;
+    std::unique_ptr<SubscriptionManager> subscriptionManager;
+    std::vector<std::unique_ptr<OrderBook>> orderBooks;   // per symbol id
+
+    // Latest bid/ask per symbol; the chart picks it up once per frame
+    TopOfBookCache topOfBook;
+    quint64 renderedQuoteVersion = 0;
+
+    // Live trades for the selected symbol queue here and are drawn once per frame
+    TickConflator conflator;
+    QTimer* frameTimer = nullptr;
+    std::vector<TickRecord> frameScratch;
+    QComboBox* backpressureSelector;
+    QLabel* conflationLabel;
+
+    QCheckBox* indicatorsCheckBox;
+    QLabel* indicatorLabel;
+    // Indicators per symbol id, fed with every raw trade; the main chart reads the current one
+    std::vector<std::unique_ptr<SymbolIndicators>> symbolIndicators;
+
+    // Session volume-at-price per symbol id; the main chart draws the current one
+    std::vector<std::unique_ptr<VolumeProfile>> volumeProfiles;
+    QLabel* profileLabel;
+
+    // Per-symbol trade statistics with quantile sketches
+    StatisticsEngine statistics;
+    QLabel* statisticsLabel;
+
+    // 1s bars for every symbol drive the rolling cross-symbol correlation
+    BarAggregator barAggregator;
+    CorrelationMatrix correlation;
+    QGroupBox* correlationGroup;
+    CorrelationHeatmap* correlationHeatmap;
+
+    // Price level alerts checked on every trade of every symbol
+    PriceAlertEngine alerts;
+    QLineEdit* alertPriceEdit;
+    QPushButton* addAlertButton;
+    QLabel* alertLabel;
+
+    // Local history files seed empty symbol buffers before the feed catches up.
+    // Loads run on the loader's thread; a result from before the last data source
+    // switch or clear (an older generation) is dropped.
+    HistoryLoader history;
+    QHash<int, quint64> backfillRequests;   // symbol id -> generation of its pending load
+    quint64 backfillGeneration = 0;
+
+    // Buffers, open bars and the watch list, mapped to disk every few seconds for warm restarts
+    StateSnapshot stateSnapshot;
+    QTimer* snapshotTimer = nullptr;
+
+    // Live trades re-published to local processes when $LIGHTNINGTRADE_BUS names a bus
+    TickBusPublisher tickBus;
+
+    // Tick and chart exports run on the exporter's thread; the frame timer reports progress
+    TickExporter exporter;
+    bool exportInProgress = false;
+    QPushButton* exportTicksButton;
+    QPushButton* exportChartButton;
 
     // Private methods
     void setupUI();
     void setupControlPanel();
     void setupDataDisplay();
     void setupLogDisplay();
+    void setupCorrelationDisplay();
     void setupChartDisplay();
     void initializeComponents();
     void connectSignals();
@@ -124,30 +222,31 @@ private:
     void subscribeToSymbol(const QString& symbol);
     void unsubscribeFromSymbol(const QString& symbol);
     void onDataSourceChanged(DataSourceMode newMode);
+    void onLiveTrades(int symbolId, const std::vector<TickRecord>& trades);
+    void watchSymbolsFromInput();
+    void addAlertFromInput();
+    void onAlertFired(const PriceAlertEngine::FiredAlert& fired);
+    void backfillSymbol(int symbolId);
+    void applyBackfill(int symbolId, quint64 generation, const HistoryLoader::Result& result);
+    void restoreState();
+    void saveState();
+    void exportData(bool chartWindowOnly);
+    void reportExportProgress();
+    MockDataGenerator* generatorFor(int symbolId);
+    OrderBook& orderBookFor(int symbolId);
+    VolumeProfile& volumeProfileFor(int symbolId);
+    SymbolIndicators& indicatorsFor(int symbolId);
+    void onBookUpdate(int symbolId, const BookUpdate& update);
+    void onQuote(int symbolId, const KrakenMessageParser::Quote& quote);
+    template <ExchangeAdapter Adapter>
+    void handleFeedMessage(const QString& message);
+    void renderFrame();
+    void onFeedLost(qint64 lastDataMs);
+    void onFeedRestored(qint64 nowMs);
 
     // Helper functions for symbol mapping
     QString normalizeSymbol(const QString& symbol) {
-        QString sym = symbol.toUpper();
-        sym.remove('/');
-        return sym;
-    }
-
-    // Convert UI symbol to Kraken format
-    QString toKrakenSymbol(const QString& uiSymbol) {
-        QString normalized = normalizeSymbol(uiSymbol);
-        if (normalized == "BTCUSD") return "XBT/USD";
-        if (normalized == "ETHUSD") return "ETH/USD";
-        // Add more mappings as needed
-        return normalized;
-    }
-
-    // Convert Kraken symbol to UI format
-    QString fromKrakenSymbol(const QString& krakenSymbol) {
-        QString normalized = normalizeSymbol(krakenSymbol);
-        if (normalized == "XBTUSD") return "BTCUSD";
-        if (normalized == "ETHUSD") return "ETHUSD";
-        // Add more mappings as needed
-        return normalized;
+        return KrakenMessageParser::normalizeSymbol(symbol);
     }
 };
 
@@ -0,0 +1,205 @@
+#include "LocalFeedServer.h"
+#include "NativeWebSocketClient.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+using SocketHandle = SOCKET;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SocketHandle = int;
+#endif
+
+namespace {
+#ifdef MSG_NOSIGNAL
+    constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int SendFlags = 0;
+#endif
+    constexpr int PollStepMs = 100;
+    constexpr qint64 SpinBelowNs = 200000;   // closer than this to a send slot: spin, don't sleep
+
+    SocketHandle handleOf(qintptr fd) {
+        return static_cast<SocketHandle>(fd);
+    }
+
+    void closeHandle(qintptr fd) {
+        if (fd < 0) return;
+#ifdef _WIN32
+        closesocket(handleOf(fd));
+#else
+        ::close(handleOf(fd));
+#endif
+    }
+
+    // Waits until 'fd' is readable, in steps so a stop request is noticed
+    bool waitReadable(qintptr fd, const std::atomic<bool>& stop) {
+        while (!stop.load()) {
+#ifdef _WIN32
+            WSAPOLLFD entry{ handleOf(fd), POLLRDNORM, 0 };
+            if (WSAPoll(&entry, 1, PollStepMs) > 0) return true;
+#else
+            pollfd entry{ handleOf(fd), POLLIN, 0 };
+            if (::poll(&entry, 1, PollStepMs) > 0) return true;
+#endif
+        }
+        return false;
+    }
+
+    bool sendAll(qintptr fd, const char* data, size_t size) {
+        while (size > 0) {
+            const int n = ::send(handleOf(fd), data, static_cast<int>(std::min<size_t>(size, 1 << 30)), SendFlags);
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+LocalFeedServer::LocalFeedServer(const std::vector<QByteArray>& messages, double messagesPerSecond)
+    : rate(messagesPerSecond) {
+    size_t bytes = 0;
+    for (const QByteArray& message : messages) {
+        bytes += static_cast<size_t>(message.size()) + 10;
+    }
+    wire.reserve(static_cast<qsizetype>(bytes));
+    offsets.reserve(messages.size() + 1);
+    for (const QByteArray& message : messages) {
+        offsets.push_back(static_cast<size_t>(wire.size()));
+        WebSocketFrame::append(wire, WebSocketFrame::Text, message.constData(), static_cast<size_t>(message.size()), false);
+    }
+    offsets.push_back(static_cast<size_t>(wire.size()));
+
+    sendTimes = std::make_unique<std::atomic<qint64>[]>(messages.size() + 1);
+    for (size_t i = 0; i <= messages.size(); ++i) {
+        sendTimes[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+LocalFeedServer::~LocalFeedServer() {
+    stop();
+}
+
+qint64 LocalFeedServer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool LocalFeedServer::start(QString* error) {
+    stop();
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+
+    SocketHandle handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    if (::bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(handle, 1) != 0
+        || ::getsockname(handle, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        if (error) *error = "Cannot listen on a loopback port";
+        closeHandle(static_cast<qintptr>(handle));
+        return false;
+    }
+
+    listener = static_cast<qintptr>(handle);
+    listenPort = ntohs(address.sin_port);
+    stopRequested.store(false);
+    sentCount.store(0);
+    thread = std::thread(&LocalFeedServer::run, this);
+    return true;
+}
+
+void LocalFeedServer::stop() {
+    stopRequested.store(true);
+    if (thread.joinable())
+        thread.join();
+    closeHandle(listener);
+    listener = -1;
+}
+
+void LocalFeedServer::run() {
+    if (!waitReadable(listener, stopRequested))
+        return;
+    const SocketHandle client = ::accept(handleOf(listener), nullptr, nullptr);
+#ifdef _WIN32
+    if (client == INVALID_SOCKET) return;
+#else
+    if (client < 0) return;
+#endif
+    int one = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+    serveClient(static_cast<qintptr>(client));
+    closeHandle(static_cast<qintptr>(client));
+}
+
+bool LocalFeedServer::serveClient(qintptr client) {
+    // Upgrade request: only the key matters
+    QByteArray request;
+    char buffer[4096];
+    while (!request.contains("\r\n\r\n")) {
+        if (!waitReadable(client, stopRequested))
+            return false;
+        const int n = ::recv(handleOf(client), buffer, sizeof(buffer), 0);
+        if (n <= 0 || request.size() > 16 * 1024)
+            return false;
+        request.append(buffer, n);
+    }
+    const int headerEnd = static_cast<int>(request.indexOf("\r\n\r\n")) + 4;
+    const QByteArray lower = request.left(headerEnd).toLower();
+    const qsizetype keyAt = lower.indexOf("sec-websocket-key:");
+    if (keyAt < 0)
+        return false;
+    const qsizetype valueAt = keyAt + static_cast<qsizetype>(std::strlen("sec-websocket-key:"));
+    const QByteArray key = request.mid(valueAt, request.indexOf("\r\n", valueAt) - valueAt).trimmed();
+    const QByteArray response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: " + WebSocketFrame::acceptKey(key) + "\r\n\r\n";
+    if (!sendAll(client, response.constData(), static_cast<size_t>(response.size())))
+        return false;
+
+    // The client's first message (e.g. its subscription) starts the stream
+    if (request.size() == headerEnd) {
+        if (!waitReadable(client, stopRequested))
+            return false;
+        if (::recv(handleOf(client), buffer, sizeof(buffer), 0) <= 0)
+            return false;
+    }
+
+    const size_t count = messageCount();
+    const qint64 started = nowNs();
+    for (size_t i = 0; i < count && !stopRequested.load(std::memory_order_relaxed); ++i) {
+        if (rate > 0.0) {
+            const qint64 due = started + static_cast<qint64>(static_cast<double>(i) * 1e9 / rate);
+            for (qint64 now = nowNs(); now < due; now = nowNs()) {
+                if (due - now > SpinBelowNs)
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - SpinBelowNs));
+            }
+        }
+        sendTimes[i].store(nowNs(), std::memory_order_release);
+        if (!sendAll(client, wire.constData() + offsets[i], offsets[i + 1] - offsets[i]))
+            return false;
+        sentCount.store(i + 1, std::memory_order_release);
+    }
+
+    // Hold the connection until the benchmark is done with it, discarding what the client sends
+    while (waitReadable(client, stopRequested)) {
+        if (::recv(handleOf(client), buffer, sizeof(buffer), 0) <= 0)
+            break;
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Stand-in for the exchange in transport benchmarks: accepts one WebSocket
+// client on 127.0.0.1 and, once the client sends its first message, streams
+// the prepared frames at a fixed rate (or as fast as the socket takes them).
+// Every frame is pre-encoded, and its steady-clock send time is recorded by
+// index, so a receiver in the same process can measure wire-to-handler latency
+// without anything added to the payload.
+class LocalFeedServer {
+private:
+    QByteArray wire;                          // all messages as unmasked text frames, back to back
+    std::vector<size_t> offsets;              // frame i is wire[offsets[i], offsets[i + 1])
+    std::unique_ptr<std::atomic<qint64>[]> sendTimes;
+    double rate = 0.0;
+    qintptr listener = -1;
+    quint16 listenPort = 0;
+    std::thread thread;
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<size_t> sentCount{ 0 };
+
+    void run();
+    bool serveClient(qintptr client);
+
+public:
+    // 'messagesPerSecond' 0 = flood
+    LocalFeedServer(const std::vector<QByteArray>& messages, double messagesPerSecond);
+    ~LocalFeedServer();
+
+    LocalFeedServer(const LocalFeedServer&) = delete;
+    LocalFeedServer& operator=(const LocalFeedServer&) = delete;
+
+    // Listens on an ephemeral loopback port and waits for one client in the background
+    bool start(QString* error = nullptr);
+    void stop();
+
+    QUrl url() const { return QUrl(QString("ws://127.0.0.1:%1/").arg(listenPort)); }
+    size_t messageCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t sent() const { return sentCount.load(std::memory_order_acquire); }
+    // Steady-clock nanoseconds when message 'index' was handed to the socket, 0 if not yet
+    qint64 sendTimeNs(size_t index) const { return sendTimes[index].load(std::memory_order_acquire); }
+
+    static qint64 nowNs();
+};
@@ -0,0 +1,50 @@
+#ifndef MARKETTICK_H
+#define MARKETTICK_H
+
+#include <QString>
+#include <QtGlobal>
+
+struct MarketTick {
+    QString symbol;
+    double price;
+    double volume;
+    qint64 timestamp;
+    double bid;
+    double ask;
+    double high;
+    double low;
+    double open;
+
+    MarketTick()
+        : symbol(""), price(0.0), volume(0), timestamp(0),
+        bid(0.0), ask(0.0), high(0.0), low(0.0), open(0.0) {
+    }
+
+    MarketTick(const QString& sym, double p, double v, qint64 ts,
+        double b, double a, double h, double l, double o)
+        : symbol(sym), price(p), volume(v), timestamp(ts),
+        bid(b), ask(a), high(h), low(l), open(o) {
+    }
+};
+
+// Compact, symbol-less trade record used on the ingest path and in tick buffers.
+// The owning symbol is implied by the buffer (or symbol id) it is stored under.
+struct TickRecord {
+    qint64 timestamp = 0;   // ms since epoch
+    double price = 0.0;
+    double volume = 0.0;
+    double bid = 0.0;
+    double ask = 0.0;
+    char side = 0;          // 'b' buy, 's' sell, 0 unknown
+};
+
+// Interval in which the live feed delivered nothing (disconnect or stale
+// connection). Times are local wall clock, ms since epoch.
+struct FeedGap {
+    qint64 fromTimestamp = 0;   // last data before the outage
+    qint64 toTimestamp = 0;     // data flowing again; 0 while the gap is open
+
+    bool isOpen() const { return toTimestamp == 0; }
+};
+
+#endif // MARKETTICK_H
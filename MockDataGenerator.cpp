@@ -188,7 +188,7 @@ MarketTick parseMarketTickFromJson(const QString& jsonString){
     return MarketTick{
         obj.value("symbol").toString("BTCUSD"),
         obj.value("price").toDouble(0.0),
-        obj.value("volume").toInt(0),
+        obj.value("volume").toDouble(0.0),
         obj.value("timestamp").toVariant().toLongLong(),
         obj.value("bid").toDouble(0.0),
         obj.value("ask").toDouble(0.0),
@@ -8,36 +8,13 @@
 #include <string>
 #include <QObject>
 #include <QString>
+#include "MarketTick.h"
 
 
 // Forward declarations 
 class LightningTradeMainWindow;
 
 
-struct MarketTick {
-    QString symbol;
-    double price;
-    int volume;
-    qint64 timestamp;
-    double bid;
-    double ask;
-    double high;
-    double low;
-    double open;
-
-    MarketTick()  
-        : symbol(""), price(0.0), volume(0), timestamp(0),
-        bid(0.0), ask(0.0), high(0.0), low(0.0), open(0.0) {
-    }
-
-    MarketTick(const QString& sym, double p, int v, qint64 ts,
-        double b, double a, double h, double l, double o)
-        : symbol(sym), price(p), volume(v), timestamp(ts),
-        bid(b), ask(a), high(h), low(l), open(o) {
-    }
-};
-
-
 class MockDataGenerator : public QObject { // Inherit from QObject if you need Qt functionality
     Q_OBJECT 
 
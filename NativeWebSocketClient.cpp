@@ -0,0 +1,665 @@
+#include "NativeWebSocketClient.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QMetaObject>
+#include <QObject>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+using SocketHandle = SOCKET;
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+using SocketHandle = int;
+#endif
+
+namespace {
+    const char WebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    constexpr size_t MaxHandshakeBytes = 16 * 1024;
+    constexpr int ConnectTimeoutMs = 10000;
+    constexpr size_t MaxFrameHeader = 14;   // 2 + 64-bit length + mask key
+#ifdef MSG_NOSIGNAL
+    constexpr int SendFlags = MSG_NOSIGNAL;   // a dead peer is an error code, not SIGPIPE
+#else
+    constexpr int SendFlags = 0;
+#endif
+
+    SocketHandle handleOf(qintptr fd) {
+        return static_cast<SocketHandle>(fd);
+    }
+
+    bool wouldBlock() {
+#ifdef _WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS;
+#endif
+    }
+
+    bool interrupted() {
+#ifdef _WIN32
+        return false;
+#else
+        return errno == EINTR;
+#endif
+    }
+
+    QString socketError(const char* what) {
+#ifdef _WIN32
+        return QString("%1 failed (error %2)").arg(what).arg(WSAGetLastError());
+#else
+        return QString("%1 failed: %2").arg(what, QString::fromLocal8Bit(std::strerror(errno)));
+#endif
+    }
+
+    bool initializeSockets() {
+#ifdef _WIN32
+        static const bool ready = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return ready;
+#else
+        return true;
+#endif
+    }
+
+    quint32 randomMask() {
+        return QRandomGenerator::global()->generate();
+    }
+}
+
+void WebSocketFrame::append(QByteArray& out, Opcode opcode, const char* payload, size_t size, bool masked, quint32 maskKey) {
+    char header[14];
+    size_t length = 0;
+    header[length++] = static_cast<char>(0x80 | opcode);
+    const char maskBit = masked ? static_cast<char>(0x80) : 0;
+    if (size < 126) {
+        header[length++] = static_cast<char>(maskBit | size);
+    } else if (size <= 0xFFFF) {
+        header[length++] = static_cast<char>(maskBit | 126);
+        header[length++] = static_cast<char>(size >> 8);
+        header[length++] = static_cast<char>(size);
+    } else {
+        header[length++] = static_cast<char>(maskBit | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            header[length++] = static_cast<char>(static_cast<quint64>(size) >> shift);
+        }
+    }
+    if (masked) {
+        std::memcpy(header + length, &maskKey, 4);
+        length += 4;
+    }
+
+    const qsizetype start = out.size();
+    out.append(header, static_cast<qsizetype>(length));
+    out.append(payload, static_cast<qsizetype>(size));
+    if (masked)
+        unmask(out.data() + start + length, size, maskKey);   // XOR is its own inverse
+}
+
+void WebSocketFrame::unmask(char* payload, size_t size, quint32 maskKey) {
+    // The key repeats every four bytes; memcpy keeps byte order and alignment out of it
+    const quint64 wide = static_cast<quint64>(maskKey) | (static_cast<quint64>(maskKey) << 32);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, payload + i, 8);
+        word ^= wide;
+        std::memcpy(payload + i, &word, 8);
+    }
+    const unsigned char* key = reinterpret_cast<const unsigned char*>(&maskKey);
+    for (; i < size; ++i) {
+        payload[i] = static_cast<char>(payload[i] ^ key[i & 3]);
+    }
+}
+
+QByteArray WebSocketFrame::acceptKey(const QByteArray& clientKey) {
+    return QCryptographicHash::hash(clientKey + WebSocketGuid, QCryptographicHash::Sha1).toBase64();
+}
+
+bool WebSocketFrame::pinCurrentThread(int cpu) {
+    if (cpu < 0)
+        return false;
+#ifdef _WIN32
+    return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+NativeWebSocketClient::NativeWebSocketClient()
+    : NativeWebSocketClient(Options()) {
+}
+
+NativeWebSocketClient::NativeWebSocketClient(const Options& options)
+    : options(options) {
+#ifdef __linux__
+    // Lives as long as the client so sendMessage() can always wake the network thread
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+NativeWebSocketClient::~NativeWebSocketClient() {
+    disconnectFromServer();
+#ifdef __linux__
+    if (wakeFd >= 0) ::close(wakeFd);
+#endif
+}
+
+void NativeWebSocketClient::setCallbacks(const Callbacks& newCallbacks, QObject* newContext) {
+    callbacks = newCallbacks;
+    context = newContext;
+}
+
+void NativeWebSocketClient::connectToServer(const QUrl& url) {
+    disconnectFromServer();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error.clear();
+        outgoing.clear();
+    }
+    stopRequested.store(false);
+    thread = std::thread(&NativeWebSocketClient::run, this, url);
+}
+
+void NativeWebSocketClient::disconnectFromServer() {
+    if (!thread.joinable())
+        return;
+    stopRequested.store(true);
+    wake();
+    if (thread.get_id() == std::this_thread::get_id())
+        thread.detach();   // called from a network thread callback: it exits on its own
+    else
+        thread.join();
+}
+
+QString NativeWebSocketClient::errorString() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void NativeWebSocketClient::sendMessage(const QString& message) {
+    QByteArray utf8 = message.toUtf8();
+    queueFrame(WebSocketFrame::Text, utf8.constData(), static_cast<size_t>(utf8.size()));
+}
+
+void NativeWebSocketClient::queueFrame(WebSocketFrame::Opcode opcode, const char* payload, size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        WebSocketFrame::append(outgoing, opcode, payload, size, true, randomMask());
+    }
+    wake();
+}
+
+void NativeWebSocketClient::post(const std::function<void()>& event) {
+    if (!event)
+        return;
+    if (context)
+        QMetaObject::invokeMethod(context, event, Qt::QueuedConnection);
+    else
+        event();
+}
+
+void NativeWebSocketClient::wake() {
+#ifdef __linux__
+    if (wakeFd >= 0) {
+        const quint64 one = 1;
+        ssize_t written = ::write(wakeFd, &one, sizeof(one));
+        Q_UNUSED(written);
+    }
+#endif
+}
+
+void NativeWebSocketClient::fail(const QString& message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = message;
+    }
+    qWarning() << "Native WebSocket error:" << message;
+    if (callbacks.errorOccurred) {
+        auto callback = callbacks.errorOccurred;
+        post([callback, message]() { callback(message); });
+    }
+}
+
+void NativeWebSocketClient::run(QUrl url) {
+    if (options.cpu >= 0 && !WebSocketFrame::pinCurrentThread(options.cpu))
+        qWarning() << "Cannot pin the WebSocket thread to core" << options.cpu;
+
+    receiveBuffer.resize(std::max<size_t>(options.receiveBufferBytes, 4096));
+    received = 0;
+    fragments.clear();
+    unsent.clear();
+
+    if (!openConnection(url) || !handshake(url)) {
+        closeSocket();
+        return;
+    }
+
+    connectedFlag.store(true);
+    post(callbacks.connected);
+
+    // Frames that arrived together with the upgrade response
+    bool open = consumeFrames();
+    while (open && !stopRequested.load(std::memory_order_relaxed)) {
+        if (!flushOutgoing())
+            break;
+        if (!options.busyPoll)
+            waitReadable(unsent.isEmpty() ? 100 : 1);
+        open = readAvailable();
+    }
+
+    if (open && stopRequested.load()) {
+        // Polite close; the peer's reply is not waited for
+        QByteArray close;
+        const char status[2] = { 0x03, static_cast<char>(0xE8) };   // 1000, normal closure
+        WebSocketFrame::append(close, WebSocketFrame::Close, status, sizeof(status), true, randomMask());
+        ::send(handleOf(fd), close.constData(), static_cast<int>(close.size()), SendFlags);
+    }
+
+    closeSocket();
+    connectedFlag.store(false);
+    post(callbacks.disconnected);
+}
+
+bool NativeWebSocketClient::openConnection(const QUrl& url) {
+    if (url.scheme() != "ws") {
+        fail(QString("Unsupported scheme '%1': the native client speaks plain ws:// only").arg(url.scheme()));
+        return false;
+    }
+    if (!initializeSockets()) {
+        fail("Socket library unavailable");
+        return false;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const QByteArray host = url.host().toUtf8();
+    const QByteArray port = QByteArray::number(url.port(80));
+    if (getaddrinfo(host.constData(), port.constData(), &hints, &addresses) != 0 || !addresses) {
+        fail(QString("Cannot resolve %1").arg(url.host()));
+        return false;
+    }
+
+    SocketHandle handle = ::socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol);
+#ifdef _WIN32
+    if (handle == INVALID_SOCKET) {
+#else
+    if (handle < 0) {
+#endif
+        freeaddrinfo(addresses);
+        fail(socketError("socket"));
+        return false;
+    }
+    fd = static_cast<qintptr>(handle);
+
+    // Non-blocking, no Nagle: frames go out (and are read) the moment they exist
+    int one = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+    int bufferBytes = static_cast<int>(std::min<size_t>(receiveBuffer.size(), 8 << 20));
+    setsockopt(handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferBytes), sizeof(bufferBytes));
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    const int result = ::connect(handle, addresses->ai_addr, static_cast<int>(addresses->ai_addrlen));
+    freeaddrinfo(addresses);
+    if (result != 0 && !wouldBlock()) {
+        fail(socketError("connect"));
+        return false;
+    }
+    bool writable = false;
+    for (int waited = 0; !writable && waited < ConnectTimeoutMs && !stopRequested.load(); waited += 100) {
+        writable = waitFor(true, 100);
+    }
+    if (!writable) {
+        fail(QString("Connection to %1 timed out").arg(url.toString()));
+        return false;
+    }
+    int socketError = 0;
+    socklen_t length = sizeof(socketError);
+    getsockopt(handle, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&socketError), &length);
+    if (socketError != 0) {
+        fail(QString("Cannot connect to %1 (error %2)").arg(url.toString()).arg(socketError));
+        return false;
+    }
+
+#ifdef __linux__
+    pollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = handle;
+    epoll_ctl(pollFd, EPOLL_CTL_ADD, handle, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(pollFd, EPOLL_CTL_ADD, wakeFd, &event);
+#endif
+    return true;
+}
+
+bool NativeWebSocketClient::handshake(const QUrl& url) {
+    QByteArray nonce(16, Qt::Uninitialized);
+    for (int i = 0; i < nonce.size(); i += 4) {
+        const quint32 value = randomMask();
+        std::memcpy(nonce.data() + i, &value, 4);
+    }
+    const QByteArray key = nonce.toBase64();
+
+    QByteArray path = url.path(QUrl::FullyEncoded).toUtf8();
+    if (path.isEmpty()) path = "/";
+    if (url.hasQuery()) path += "?" + url.query(QUrl::FullyEncoded).toUtf8();
+    QByteArray host = url.host().toUtf8();
+    if (url.port() > 0) host += ":" + QByteArray::number(url.port());
+
+    // Sent directly: messages queued before the upgrade must wait for the 101
+    const QByteArray request = "GET " + path + " HTTP/1.1\r\nHost: " + host
+        + "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key
+        + "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    qsizetype sent = 0;
+    while (sent < request.size()) {
+        const int n = ::send(handleOf(fd), request.constData() + sent, static_cast<int>(request.size() - sent), SendFlags);
+        if (n > 0) {
+            sent += n;
+        } else if (!(wouldBlock() || interrupted()) || !waitFor(true, ConnectTimeoutMs)) {
+            fail(socketError("Handshake send"));
+            return false;
+        }
+    }
+
+    // Read the response header; anything after it is already frame data
+    const char* end = nullptr;
+    while (!end) {
+        if (stopRequested.load() || !waitFor(false, ConnectTimeoutMs)) {
+            fail("Handshake timed out");
+            return false;
+        }
+        const int n = ::recv(handleOf(fd), receiveBuffer.data() + received,
+            static_cast<int>(std::min(receiveBuffer.size(), MaxHandshakeBytes) - received), 0);
+        if (n <= 0) {
+            if (n < 0 && (wouldBlock() || interrupted()))
+                continue;
+            fail("Connection closed during handshake");
+            return false;
+        }
+        received += static_cast<size_t>(n);
+        end = std::search(receiveBuffer.data(), receiveBuffer.data() + received, "\r\n\r\n", "\r\n\r\n" + 4);
+        if (end == receiveBuffer.data() + received) {
+            end = nullptr;
+            if (received >= std::min(receiveBuffer.size(), MaxHandshakeBytes)) {
+                fail("Handshake response too large");
+                return false;
+            }
+        }
+    }
+
+    const QByteArray response = QByteArray(receiveBuffer.data(), static_cast<qsizetype>(end - receiveBuffer.data())).toLower();
+    const QByteArray expected = "sec-websocket-accept: " + WebSocketFrame::acceptKey(key).toLower();
+    if (!response.startsWith("http/1.1 101") || !response.contains(expected)) {
+        fail(QString("WebSocket upgrade refused: %1").arg(QString::fromUtf8(response.left(response.indexOf('\r')))));
+        return false;
+    }
+
+    const size_t headerBytes = static_cast<size_t>(end - receiveBuffer.data()) + 4;
+    received -= headerBytes;
+    std::memmove(receiveBuffer.data(), receiveBuffer.data() + headerBytes, received);
+    return true;
+}
+
+bool NativeWebSocketClient::waitFor(bool writable, int timeoutMs) {
+#ifdef _WIN32
+    WSAPOLLFD entry{ handleOf(fd), static_cast<SHORT>(writable ? POLLWRNORM : POLLRDNORM), 0 };
+    return WSAPoll(&entry, 1, timeoutMs) > 0;
+#else
+    pollfd entry{ handleOf(fd), static_cast<short>(writable ? POLLOUT : POLLIN), 0 };
+    int result;
+    do {
+        result = ::poll(&entry, 1, timeoutMs);
+    } while (result < 0 && errno == EINTR);
+    return result > 0;
+#endif
+}
+
+void NativeWebSocketClient::waitReadable(int timeoutMs) {
+#ifdef __linux__
+    epoll_event events[2];
+    const int n = epoll_wait(pollFd, events, 2, timeoutMs);
+    for (int i = 0; i < n; ++i) {
+        if (events[i].data.fd == wakeFd) {
+            quint64 count;
+            ssize_t drained = ::read(wakeFd, &count, sizeof(count));
+            Q_UNUSED(drained);
+        }
+    }
+#else
+    // Without an eventfd to wake on, queued sends wait for at most one short timeout
+    waitFor(false, std::min(timeoutMs, 5));
+#endif
+}
+
+bool NativeWebSocketClient::readAvailable() {
+    // Drain the socket: every recv lands behind whatever partial frame is left
+    for (;;) {
+        if (received == receiveBuffer.size()) {
+            // A single frame larger than the whole buffer; the only time it grows, and
+            // never past the largest frame parseFrames() accepts
+            const size_t limit = options.maxMessageBytes + MaxFrameHeader;
+            if (receiveBuffer.size() >= limit) {
+                rejectOversized(received);
+                return false;
+            }
+            receiveBuffer.resize(std::min(receiveBuffer.size() * 2, limit));
+        }
+        const int n = ::recv(handleOf(fd), receiveBuffer.data() + received,
+            static_cast<int>(std::min<size_t>(receiveBuffer.size() - received, 1 << 30)), 0);
+        if (n < 0) {
+            if (wouldBlock() || interrupted())
+                return true;
+            fail(socketError("recv"));
+            return false;
+        }
+        if (n == 0) {
+            fail("Connection closed by peer");
+            return false;
+        }
+        received += static_cast<size_t>(n);
+        bytes.fetch_add(static_cast<quint64>(n), std::memory_order_relaxed);
+        if (!consumeFrames())
+            return false;
+    }
+}
+
+bool NativeWebSocketClient::consumeFrames() {
+    bool closed = false;
+    const size_t consumed = parseFrames(receiveBuffer.data(), received, closed);
+    if (closed)
+        return false;
+    if (consumed > 0) {
+        // Only a partial frame is ever left over, so this moves a few bytes at most
+        received -= consumed;
+        if (received > 0)
+            std::memmove(receiveBuffer.data(), receiveBuffer.data() + consumed, received);
+    }
+    return true;
+}
+
+size_t NativeWebSocketClient::parseFrames(char* data, size_t size, bool& closed) {
+    size_t position = 0;
+    while (size - position >= 2) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data + position);
+        const bool final = (p[0] & 0x80) != 0;
+        const auto opcode = static_cast<WebSocketFrame::Opcode>(p[0] & 0x0F);
+        const bool masked = (p[1] & 0x80) != 0;
+        quint64 length = p[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (size - position < 4) break;
+            length = (quint64(p[2]) << 8) | p[3];
+            header = 4;
+        } else if (length == 127) {
+            if (size - position < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | p[2 + i];
+            }
+            header = 10;
+        }
+        // A set top bit is invalid (RFC 6455 5.2) and would wrap the sums below
+        if ((length >> 63) != 0 || length > options.maxMessageBytes) {
+            rejectOversized(length);
+            closed = true;
+            break;
+        }
+        quint32 maskKey = 0;
+        if (masked) {
+            if (size - position < header + 4) break;
+            std::memcpy(&maskKey, p + header, 4);
+            header += 4;
+        }
+        if (length > size - position - header)
+            break;   // incomplete: wait for more bytes
+
+        char* payload = data + position + header;
+        if (masked)
+            WebSocketFrame::unmask(payload, static_cast<size_t>(length), maskKey);
+        position += header + static_cast<size_t>(length);
+        if (!handleFrame(opcode, final, payload, static_cast<size_t>(length))) {
+            closed = true;
+            break;
+        }
+    }
+    return position;
+}
+
+bool NativeWebSocketClient::handleFrame(WebSocketFrame::Opcode opcode, bool final, char* payload, size_t size) {
+    switch (opcode) {
+    case WebSocketFrame::Text:
+    case WebSocketFrame::Binary:
+        if (final) {
+            deliver(payload, size);
+        } else {
+            fragmentOpcode = opcode;
+            fragments.assign(payload, payload + size);
+        }
+        return true;
+    case WebSocketFrame::Continuation:
+        if (fragments.size() + size > options.maxMessageBytes) {
+            rejectOversized(fragments.size() + size);
+            fragments.clear();
+            return false;
+        }
+        fragments.insert(fragments.end(), payload, payload + size);
+        if (final) {
+            deliver(fragments.data(), fragments.size());
+            fragments.clear();
+        }
+        return true;
+    case WebSocketFrame::Ping:
+        queueFrame(WebSocketFrame::Pong, payload, size);
+        return true;
+    case WebSocketFrame::Pong:
+        return true;
+    case WebSocketFrame::Close: {
+        flushOutgoing();   // a pong queued just before still goes first
+        QByteArray reply;
+        WebSocketFrame::append(reply, WebSocketFrame::Close, payload, std::min<size_t>(size, 2), true, randomMask());
+        ::send(handleOf(fd), reply.constData(), static_cast<int>(reply.size()), SendFlags);
+        return false;
+    }
+    default:
+        fail(QString("Unknown WebSocket opcode %1").arg(static_cast<int>(opcode)));
+        return false;
+    }
+}
+
+void NativeWebSocketClient::rejectOversized(quint64 length) {
+    // Impolite close; the connection is dropped without waiting for the echo
+    const char status[2] = { 0x03, static_cast<char>(0xF1) };   // 1009, message too big
+    QByteArray reply;
+    WebSocketFrame::append(reply, WebSocketFrame::Close, status, sizeof(status), true, randomMask());
+    ::send(handleOf(fd), reply.constData(), static_cast<int>(reply.size()), SendFlags);
+    fail(QString("WebSocket message of %1 bytes exceeds the %2 byte limit").arg(length).arg(options.maxMessageBytes));
+}
+
+void NativeWebSocketClient::deliver(const char* data, size_t size) {
+    frames.fetch_add(1, std::memory_order_relaxed);
+    if (callbacks.frameReceived) {
+        callbacks.frameReceived(data, size);
+        return;
+    }
+    if (!callbacks.messageReceived)
+        return;
+
+    QString message = QString::fromUtf8(data, static_cast<qsizetype>(size));
+    if (logMessages)
+        qDebug() << "WebSocket message received:" << message;
+    if (context) {
+        auto callback = callbacks.messageReceived;
+        QMetaObject::invokeMethod(context, [callback, message]() { callback(message); }, Qt::QueuedConnection);
+    } else {
+        callbacks.messageReceived(message);
+    }
+}
+
+bool NativeWebSocketClient::flushOutgoing() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!outgoing.isEmpty()) {
+            unsent.append(outgoing);
+            outgoing.clear();
+        }
+    }
+    while (!unsent.isEmpty()) {
+        const int n = ::send(handleOf(fd), unsent.constData(), static_cast<int>(unsent.size()), SendFlags);
+        if (n < 0) {
+            if (wouldBlock() || interrupted())
+                return true;   // the rest goes on a later pass
+            fail(socketError("send"));
+            return false;
+        }
+        unsent.remove(0, n);
+    }
+    return true;
+}
+
+void NativeWebSocketClient::closeSocket() {
+#ifdef __linux__
+    if (pollFd >= 0) ::close(pollFd);
+    pollFd = -1;
+#endif
+    if (fd >= 0) {
+#ifdef _WIN32
+        closesocket(handleOf(fd));
+#else
+        ::close(handleOf(fd));
+#endif
+    }
+    fd = -1;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class QObject;
+
+// RFC 6455 framing shared by the native client and the benchmark's stand-in server
+namespace WebSocketFrame {
+    enum Opcode : quint8 { Continuation = 0x0, Text = 0x1, Binary = 0x2, Close = 0x8, Ping = 0x9, Pong = 0xA };
+
+    // Appends one final frame; client frames must be masked
+    void append(QByteArray& out, Opcode opcode, const char* payload, size_t size, bool masked, quint32 maskKey = 0);
+    // XORs the payload with the 4-byte key in place, eight bytes at a time
+    void unmask(char* payload, size_t size, quint32 maskKey);
+    // Sec-WebSocket-Accept for a Sec-WebSocket-Key
+    QByteArray acceptKey(const QByteArray& clientKey);
+
+    // Pins the calling thread to one core; false where unsupported
+    bool pinCurrentThread(int cpu);
+}
+
+// Low-level alternative to WebSocketClient for the hot path. QWebSocket
+// delivers every frame through the Qt event loop, a queued signal and a
+// QString conversion; this client owns a thread that waits on the socket with
+// epoll (WSAPoll on Windows), or spins on it when busy-polling, receives into
+// one preallocated buffer and parses and unmasks frames in place. Messages are
+// handed to the frame callback as a pointer into that buffer - no copy, no
+// allocation, no event loop.
+//
+// For drop-in use the same connect / send / message interface is offered:
+// given a context QObject, connected, disconnected, errors and text messages
+// (as QString) are queued to that object's thread just like WebSocketClient's
+// signals. Plain ws:// only: there is no TLS, so this talks to local relays
+// and the benchmark's stand-in server rather than wss://ws.kraken.com.
+class NativeWebSocketClient {
+public:
+    struct Options {
+        size_t receiveBufferBytes = 4 << 20;   // grows only for a single frame larger than this
+        size_t maxMessageBytes = 64 << 20;     // larger frames or reassembled messages close with 1009
+        bool busyPoll = false;                 // spin on non-blocking recv instead of sleeping
+        int cpu = -1;                          // pin the network thread to this core; -1 = not pinned
+    };
+
+    // Network thread; the payload lives in the receive buffer and is valid only during the call
+    using FrameCallback = std::function<void(const char* data, size_t size)>;
+
+    struct Callbacks {
+        std::function<void()> connected;
+        std::function<void()> disconnected;
+        std::function<void(const QString& errorString)> errorOccurred;
+        std::function<void(const QString& message)> messageReceived;   // ignored when frameReceived is set
+        FrameCallback frameReceived;
+    };
+
+private:
+    Options options;
+    Callbacks callbacks;
+    QObject* context = nullptr;
+    bool logMessages = false;
+
+    std::thread thread;
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> connectedFlag{ false };
+    qintptr fd = -1;
+    int pollFd = -1;        // epoll instance (Linux)
+    int wakeFd = -1;        // eventfd that interrupts epoll_wait when a message is queued (Linux)
+
+    std::vector<char> receiveBuffer;
+    size_t received = 0;
+    std::vector<char> fragments;          // a fragmented message being reassembled
+    WebSocketFrame::Opcode fragmentOpcode = WebSocketFrame::Text;
+
+    mutable std::mutex mutex;             // guards outgoing and error
+    QByteArray outgoing;                  // frames queued by sendMessage()
+    QByteArray unsent;                    // network thread: tail of a partial send
+    QString error;
+
+    std::atomic<quint64> frames{ 0 };
+    std::atomic<quint64> bytes{ 0 };
+
+    void run(QUrl url);
+    bool openConnection(const QUrl& url);
+    bool handshake(const QUrl& url);
+    bool waitFor(bool writable, int timeoutMs);
+    void waitReadable(int timeoutMs);
+    bool readAvailable();
+    bool consumeFrames();
+    size_t parseFrames(char* data, size_t size, bool& closed);
+    bool handleFrame(WebSocketFrame::Opcode opcode, bool final, char* payload, size_t size);
+    void deliver(const char* data, size_t size);
+    void rejectOversized(quint64 length);
+    void queueFrame(WebSocketFrame::Opcode opcode, const char* payload, size_t size);
+    bool flushOutgoing();
+    void fail(const QString& message);
+    void closeSocket();
+    void wake();
+    void post(const std::function<void()>& event);
+
+public:
+    NativeWebSocketClient();
+    explicit NativeWebSocketClient(const Options& options);
+    ~NativeWebSocketClient();
+
+    NativeWebSocketClient(const NativeWebSocketClient&) = delete;
+    NativeWebSocketClient& operator=(const NativeWebSocketClient&) = delete;
+
+    // Set before connecting. With a context, every callback but frameReceived
+    // runs on the context's thread; without one, all run on the network thread.
+    void setCallbacks(const Callbacks& callbacks, QObject* context = nullptr);
+
+    void connectToServer(const QUrl& url);
+    void disconnectFromServer();
+    QString errorString() const;
+    void sendMessage(const QString& message);
+    bool isConnected() const { return connectedFlag.load(std::memory_order_relaxed); }
+    void setMessageLogging(bool enable) { logMessages = enable; }
+
+    quint64 framesReceived() const { return frames.load(std::memory_order_relaxed); }
+    quint64 bytesReceived() const { return bytes.load(std::memory_order_relaxed); }
+};
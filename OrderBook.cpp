@@ -0,0 +1,183 @@
+#include "OrderBook.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+
+namespace {
+    constexpr int64_t Pow10[] = {
+        1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+        100000000LL, 1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL,
+        10000000000000LL, 100000000000000LL, 1000000000000000LL, 10000000000000000LL,
+        100000000000000000LL, 1000000000000000000LL
+    };
+    constexpr int MaxDecimals = 18;
+
+    std::array<uint32_t, 256> makeCrcTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }
+
+    const std::array<uint32_t, 256> CrcTable = makeCrcTable();
+}
+
+OrderBook::OrderBook(size_t depth)
+    : depth(std::max<size_t>(depth, 1)),
+    priceDecimals(0),
+    volumeDecimals(0),
+    precisionKnown(false),
+    synced(false),
+    checksumFailures(0) {
+    bids.reserve(this->depth + 1);
+    asks.reserve(this->depth + 1);
+}
+
+void OrderBook::clear() {
+    bids.clear();
+    asks.clear();
+    precisionKnown = false;
+    synced = false;
+}
+
+int64_t OrderBook::rescale(int64_t mantissa, int fromDecimals, int toDecimals) {
+    if (fromDecimals == toDecimals) return mantissa;
+    if (fromDecimals < toDecimals) return mantissa * Pow10[toDecimals - fromDecimals];
+    return mantissa / Pow10[fromDecimals - toDecimals];
+}
+
+void OrderBook::applyLevel(std::vector<BookLevel>& side, bool isBid, const BookLevelUpdate& update) {
+    int64_t price = rescale(update.price, update.priceDecimals, priceDecimals);
+    int64_t volume = rescale(update.volume, update.volumeDecimals, volumeDecimals);
+
+    // Sorted so that the best level is at the back
+    auto better = [isBid](int64_t a, int64_t b) { return isBid ? a > b : a < b; };
+
+    // Most updates touch the top of the book, so scan from the back
+    size_t i = side.size();
+    while (i > 0 && better(side[i - 1].price, price)) {
+        --i;
+    }
+
+    bool exists = i > 0 && side[i - 1].price == price;
+    if (volume == 0) {
+        if (exists) side.erase(side.begin() + (i - 1));
+        return;
+    }
+
+    if (exists)
+        side[i - 1].volume = volume;
+    else
+        side.insert(side.begin() + i, BookLevel{ price, volume });
+}
+
+void OrderBook::truncate(std::vector<BookLevel>& side) {
+    // Worst levels sit at the front
+    if (side.size() > depth)
+        side.erase(side.begin(), side.begin() + (side.size() - depth));
+}
+
+bool OrderBook::apply(const BookUpdate& update) {
+    if (update.snapshot) {
+        clear();
+        synced = true;
+    }
+    else if (!synced) {
+        return true; // waiting for a snapshot
+    }
+
+    // The first level seen fixes the precision; Kraken prints fixed decimals per pair
+    if (!precisionKnown) {
+        const BookLevelUpdate* first = !update.asks.empty() ? &update.asks.front()
+            : (!update.bids.empty() ? &update.bids.front() : nullptr);
+        if (first) {
+            priceDecimals = first->priceDecimals;
+            volumeDecimals = first->volumeDecimals;
+            precisionKnown = true;
+        }
+    }
+
+    for (const BookLevelUpdate& level : update.asks) {
+        applyLevel(asks, false, level);
+    }
+    for (const BookLevelUpdate& level : update.bids) {
+        applyLevel(bids, true, level);
+    }
+
+    truncate(asks);
+    truncate(bids);
+
+    if (update.hasChecksum && checksum() != update.checksum) {
+        ++checksumFailures;
+        synced = false;
+        return false;
+    }
+    return true;
+}
+
+uint32_t OrderBook::checksum() const {
+    // Concatenate price and volume of each level with the '.' and leading
+    // zeros removed, which is exactly the decimal mantissa.
+    char buffer[10 * 2 * 2 * 20];
+    char* out = buffer;
+    char* end = buffer + sizeof(buffer);
+
+    auto appendSide = [&out, end](const std::vector<BookLevel>& side) {
+        size_t count = std::min<size_t>(10, side.size());
+        for (size_t i = 0; i < count; ++i) {
+            const BookLevel& level = side[side.size() - 1 - i];
+            out = std::to_chars(out, end, level.price).ptr;
+            out = std::to_chars(out, end, level.volume).ptr;
+        }
+    };
+
+    appendSide(asks);
+    appendSide(bids);
+    return crc32(buffer, static_cast<size_t>(out - buffer));
+}
+
+double OrderBook::toPrice(int64_t mantissa) const {
+    return static_cast<double>(mantissa) / static_cast<double>(Pow10[priceDecimals]);
+}
+
+double OrderBook::toVolume(int64_t mantissa) const {
+    return static_cast<double>(mantissa) / static_cast<double>(Pow10[volumeDecimals]);
+}
+
+bool OrderBook::parseDecimal(const char* begin, const char* end, int64_t& mantissa, int8_t& decimals) {
+    int64_t value = 0;
+    int fraction = -1;   // digits seen after the '.', -1 before it
+    bool anyDigit = false;
+
+    for (const char* p = begin; p < end; ++p) {
+        char c = *p;
+        if (c == '.') {
+            if (fraction >= 0) return false;
+            fraction = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') return false;
+        if (value > (INT64_MAX - 9) / 10) return false;
+        value = value * 10 + (c - '0');
+        anyDigit = true;
+        if (fraction >= 0 && ++fraction > MaxDecimals) return false;
+    }
+
+    if (!anyDigit) return false;
+    mantissa = value;
+    decimals = static_cast<int8_t>(fraction < 0 ? 0 : fraction);
+    return true;
+}
+
+uint32_t OrderBook::crc32(const char* data, size_t length, uint32_t crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = CrcTable[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One price level. Prices and volumes are fixed-point mantissas at the
+// book's decimal precision, exactly as Kraken prints them without the '.'.
+struct BookLevel {
+    int64_t price;
+    int64_t volume;
+};
+
+// A level as parsed from the wire, before it is scaled to the book precision
+struct BookLevelUpdate {
+    int64_t price = 0;
+    int64_t volume = 0;
+    int8_t priceDecimals = 0;
+    int8_t volumeDecimals = 0;
+};
+
+// One Kraken book frame (snapshot or incremental update)
+struct BookUpdate {
+    bool snapshot = false;
+    bool hasChecksum = false;
+    uint32_t checksum = 0;
+    std::vector<BookLevelUpdate> asks;
+    std::vector<BookLevelUpdate> bids;
+
+    void clear() {
+        snapshot = false;
+        hasChecksum = false;
+        checksum = 0;
+        asks.clear();
+        bids.clear();
+    }
+};
+
+// L2 order book for the Kraken `book` channel.
+//
+// Each side is a flat, sorted std::vector with the best level at the back:
+// bids ascending, asks descending. Updates cluster at the top of the book,
+// so inserts and erases only move the few elements behind the touched level,
+// and best bid/ask and the i-th level are direct index lookups.
+class OrderBook {
+private:
+    std::vector<BookLevel> bids;   // ascending price, best = back()
+    std::vector<BookLevel> asks;   // descending price, best = back()
+    size_t depth;
+    int priceDecimals;
+    int volumeDecimals;
+    bool precisionKnown;
+    bool synced;        // a snapshot was applied and no checksum has failed since
+    uint64_t checksumFailures;
+
+    void applyLevel(std::vector<BookLevel>& side, bool isBid, const BookLevelUpdate& update);
+    void truncate(std::vector<BookLevel>& side);
+    static int64_t rescale(int64_t mantissa, int fromDecimals, int toDecimals);
+
+public:
+    explicit OrderBook(size_t depth = 10);
+
+    void clear();
+    size_t maxDepth() const { return depth; }
+
+    // Applies a snapshot or update. Returns false if the frame carried a
+    // checksum and the resulting book does not match it; the book then stays
+    // unsynced (updates are ignored) until the next snapshot.
+    bool apply(const BookUpdate& update);
+    bool isSynced() const { return synced; }
+
+    // Kraken CRC32 over the top 10 asks then top 10 bids
+    uint32_t checksum() const;
+    uint64_t checksumFailureCount() const { return checksumFailures; }
+
+    // Level i = 0 is the best on that side; callers check the counts first
+    size_t bidCount() const { return bids.size(); }
+    size_t askCount() const { return asks.size(); }
+    const BookLevel& bid(size_t i) const { return bids[bids.size() - 1 - i]; }
+    const BookLevel& ask(size_t i) const { return asks[asks.size() - 1 - i]; }
+    bool hasTopOfBook() const { return !bids.empty() && !asks.empty(); }
+
+    double bestBid() const { return bids.empty() ? 0.0 : toPrice(bids.back().price); }
+    double bestAsk() const { return asks.empty() ? 0.0 : toPrice(asks.back().price); }
+    double toPrice(int64_t mantissa) const;
+    double toVolume(int64_t mantissa) const;
+
+    // Parses a decimal string such as "0.05005" into mantissa 5005 with 5 decimals.
+    static bool parseDecimal(const char* begin, const char* end, int64_t& mantissa, int8_t& decimals);
+    static uint32_t crc32(const char* data, size_t length, uint32_t crc = 0);
+};
@@ -0,0 +1,136 @@
+#include "PriceAlerts.h"
+#include <algorithm>
+
+PriceAlertEngine::PriceAlertEngine()
+    : activeCount(0) {
+}
+
+PriceAlertEngine::SymbolAlerts& PriceAlertEngine::symbolFor(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= symbols.size())
+        symbols.resize(symbolId + 1);
+    return symbols[symbolId];
+}
+
+void PriceAlertEngine::insertSorted(std::vector<Threshold>& side, const Threshold& threshold) {
+    auto it = std::upper_bound(side.begin(), side.end(), threshold.level,
+        [](double level, const Threshold& t) { return level < t.level; });
+    side.insert(it, threshold);
+}
+
+void PriceAlertEngine::eraseId(std::vector<Threshold>& side, double level, int alertId) {
+    auto it = std::lower_bound(side.begin(), side.end(), level,
+        [](const Threshold& t, double value) { return t.level < value; });
+    for (; it != side.end() && it->level == level; ++it) {
+        if (it->alertId == alertId) {
+            side.erase(it);
+            return;
+        }
+    }
+}
+
+int PriceAlertEngine::add(int symbolId, double level, Direction direction, bool repeating, const QString& note) {
+    if (symbolId < 0 || level <= 0.0) return 0;
+
+    Alert alert;
+    alert.id = static_cast<int>(alerts.size()) + 1;
+    alert.symbolId = symbolId;
+    alert.level = level;
+    alert.direction = direction;
+    alert.repeating = repeating;
+    alert.note = note;
+    alerts.push_back(alert);
+
+    SymbolAlerts& s = symbolFor(symbolId);
+    if (direction != Direction::Below) insertSorted(s.rising, Threshold{ level, alert.id });
+    if (direction != Direction::Above) insertSorted(s.falling, Threshold{ level, alert.id });
+    ++activeCount;
+    return alert.id;
+}
+
+bool PriceAlertEngine::remove(int alertId) {
+    if (alertId <= 0 || static_cast<size_t>(alertId) > alerts.size()) return false;
+    Alert& alert = alerts[alertId - 1];
+    if (alert.id == 0) return false;
+
+    SymbolAlerts& s = symbolFor(alert.symbolId);
+    if (alert.direction != Direction::Below) eraseId(s.rising, alert.level, alertId);
+    if (alert.direction != Direction::Above) eraseId(s.falling, alert.level, alertId);
+    alert.id = 0;
+    --activeCount;
+    return true;
+}
+
+void PriceAlertEngine::clear() {
+    symbols.clear();
+    alerts.clear();
+    activeCount = 0;
+}
+
+void PriceAlertEngine::resetPrices() {
+    for (SymbolAlerts& s : symbols) {
+        s.lastPrice = 0.0;
+    }
+}
+
+const PriceAlertEngine::Alert* PriceAlertEngine::find(int alertId) const {
+    if (alertId <= 0 || static_cast<size_t>(alertId) > alerts.size()) return nullptr;
+    const Alert& alert = alerts[alertId - 1];
+    return alert.id == 0 ? nullptr : &alert;
+}
+
+std::vector<PriceAlertEngine::Alert> PriceAlertEngine::alertsFor(int symbolId) const {
+    std::vector<Alert> out;
+    for (const Alert& alert : alerts) {
+        if (alert.id != 0 && alert.symbolId == symbolId)
+            out.push_back(alert);
+    }
+    return out;
+}
+
+double PriceAlertEngine::lastPrice(int symbolId) const {
+    if (symbolId < 0 || static_cast<size_t>(symbolId) >= symbols.size()) return 0.0;
+    return symbols[symbolId].lastPrice;
+}
+
+void PriceAlertEngine::onTrade(int symbolId, double price, qint64 timestamp) {
+    if (symbolId < 0 || price <= 0.0) return;
+
+    SymbolAlerts& s = symbolFor(symbolId);
+    double previous = s.lastPrice;
+    s.lastPrice = price;
+    if (previous <= 0.0 || price == previous) return;
+
+    // Up-cross fires levels in (previous, price]; down-cross levels in [price, previous)
+    firedScratch.clear();
+    if (price > previous) {
+        auto first = std::upper_bound(s.rising.begin(), s.rising.end(), previous,
+            [](double value, const Threshold& t) { return value < t.level; });
+        auto last = std::upper_bound(first, s.rising.end(), price,
+            [](double value, const Threshold& t) { return value < t.level; });
+        firedScratch.assign(first, last);
+    }
+    else {
+        auto first = std::lower_bound(s.falling.begin(), s.falling.end(), price,
+            [](const Threshold& t, double value) { return t.level < value; });
+        auto last = std::lower_bound(first, s.falling.end(), previous,
+            [](const Threshold& t, double value) { return t.level < value; });
+        firedScratch.assign(first, last);
+    }
+
+    // Copied first: callbacks and one-shot removal may modify the arrays
+    for (const Threshold& threshold : firedScratch) {
+        const Alert* alert = find(threshold.alertId);
+        if (!alert) continue;
+
+        FiredAlert fired;
+        fired.alert = *alert;
+        fired.price = price;
+        fired.previousPrice = previous;
+        fired.timestamp = timestamp;
+
+        if (!alert->repeating)
+            remove(threshold.alertId);
+        if (onFired)
+            onFired(fired);
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <functional>
+#include <vector>
+#include "MarketTick.h"
+
+// Per-symbol price alerts kept in sorted threshold arrays.
+//
+// Levels that fire on an up-cross and on a down-cross live in separate
+// vectors sorted by price. A trade only looks at the slice between the
+// previous trade price and its own, found with two binary searches, so the
+// cost per trade is O(log n + fired) however many levels a symbol carries.
+class PriceAlertEngine {
+public:
+    enum class Direction {
+        Above,   // fires when the price rises to or through the level
+        Below,   // fires when the price falls to or through the level
+        Cross    // either way
+    };
+
+    struct Alert {
+        int id = 0;
+        int symbolId = -1;
+        double level = 0.0;
+        Direction direction = Direction::Cross;
+        bool repeating = false;   // stays armed after firing
+        QString note;
+    };
+
+    struct FiredAlert {
+        Alert alert;
+        double price = 0.0;           // trade that crossed the level
+        double previousPrice = 0.0;
+        qint64 timestamp = 0;
+    };
+
+    using FiredCallback = std::function<void(const FiredAlert& fired)>;
+
+private:
+    struct Threshold {
+        double level;
+        int alertId;
+    };
+
+    struct SymbolAlerts {
+        std::vector<Threshold> rising;    // sorted by level
+        std::vector<Threshold> falling;
+        double lastPrice = 0.0;
+    };
+
+    std::vector<SymbolAlerts> symbols;    // indexed by symbol id
+    std::vector<Alert> alerts;            // indexed by alert id - 1; id 0 = removed
+    std::vector<Threshold> firedScratch;
+    FiredCallback onFired;
+    int activeCount;
+
+    SymbolAlerts& symbolFor(int symbolId);
+    static void insertSorted(std::vector<Threshold>& side, const Threshold& threshold);
+    static void eraseId(std::vector<Threshold>& side, double level, int alertId);
+
+public:
+    PriceAlertEngine();
+
+    void setFiredCallback(FiredCallback callback) { onFired = std::move(callback); }
+
+    // Returns the new alert's id
+    int add(int symbolId, double level, Direction direction, bool repeating = false, const QString& note = QString());
+    bool remove(int alertId);
+    void clear();
+    // Forget the last trade prices (e.g. when the data source changes) so the
+    // next trade re-seeds instead of "crossing" from a stale price
+    void resetPrices();
+
+    int alertCount() const { return activeCount; }
+    const Alert* find(int alertId) const;
+    std::vector<Alert> alertsFor(int symbolId) const;
+
+    // Check the levels crossed since the symbol's previous trade
+    void onTrade(int symbolId, double price, qint64 timestamp);
+    void onTrade(int symbolId, const TickRecord& trade) { onTrade(symbolId, trade.price, trade.timestamp); }
+
+    double lastPrice(int symbolId) const;
+};
@@ -0,0 +1,112 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr double Pi = 3.14159265358979323846;
+}
+
+TDigest::TDigest(double compression)
+    : compression(std::max(compression, 10.0)),
+    bufferLimit(static_cast<size_t>(this->compression) * 5),
+    totalWeight(0.0),
+    minValue(std::numeric_limits<double>::max()),
+    maxValue(std::numeric_limits<double>::lowest()) {
+    buffer.reserve(bufferLimit);
+}
+
+void TDigest::clear() {
+    centroids.clear();
+    buffer.clear();
+    totalWeight = 0.0;
+    minValue = std::numeric_limits<double>::max();
+    maxValue = std::numeric_limits<double>::lowest();
+}
+
+void TDigest::add(double value, double weight) {
+    if (weight <= 0.0) return;
+
+    buffer.push_back(Centroid{ value, weight });
+    totalWeight += weight;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+
+    if (buffer.size() >= bufferLimit)
+        flush();
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.totalWeight <= 0.0) return;
+
+    for (const Centroid& c : other.centroids) buffer.push_back(c);
+    for (const Centroid& c : other.buffer) buffer.push_back(c);
+    totalWeight += other.totalWeight;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    flush();
+}
+
+void TDigest::flush() {
+    if (buffer.empty()) return;
+
+    scratch.clear();
+    scratch.reserve(centroids.size() + buffer.size());
+    scratch.insert(scratch.end(), centroids.begin(), centroids.end());
+    scratch.insert(scratch.end(), buffer.begin(), buffer.end());
+    buffer.clear();
+    std::sort(scratch.begin(), scratch.end(),
+        [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    centroids.clear();
+    Centroid current = scratch.front();
+    double weightBefore = 0.0;
+
+    for (size_t i = 1; i < scratch.size(); ++i) {
+        const Centroid& next = scratch[i];
+        double proposed = current.weight + next.weight;
+        double q = (weightBefore + proposed / 2.0) / totalWeight;
+        double limit = 2.0 * Pi * totalWeight * std::sqrt(q * (1.0 - q)) / compression;
+
+        if (proposed <= std::max(1.0, limit)) {
+            current.mean += (next.mean - current.mean) * next.weight / proposed;
+            current.weight = proposed;
+        }
+        else {
+            weightBefore += current.weight;
+            centroids.push_back(current);
+            current = next;
+        }
+    }
+    centroids.push_back(current);
+}
+
+double TDigest::quantile(double q) {
+    flush();
+    if (centroids.empty()) return 0.0;
+    if (q <= 0.0) return minValue;
+    if (q >= 1.0) return maxValue;
+    if (centroids.size() == 1) return centroids.front().mean;
+
+    // Interpolate between centroid centres; the ends run to the exact min/max
+    double target = q * totalWeight;
+    double cumulative = 0.0;
+    double previousCentre = 0.0;
+    double previousMean = minValue;
+
+    for (const Centroid& c : centroids) {
+        double centre = cumulative + c.weight / 2.0;
+        if (target < centre) {
+            double span = centre - previousCentre;
+            double t = span > 0.0 ? (target - previousCentre) / span : 0.0;
+            return previousMean + t * (c.mean - previousMean);
+        }
+        previousCentre = centre;
+        previousMean = c.mean;
+        cumulative += c.weight;
+    }
+
+    double span = totalWeight - previousCentre;
+    double t = span > 0.0 ? (target - previousCentre) / span : 1.0;
+    return previousMean + t * (maxValue - previousMean);
+}
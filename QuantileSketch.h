@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Merging t-digest (Dunning): approximate quantiles in bounded memory.
+//
+// Points collect in a small buffer that is folded into a sorted list of
+// centroids when full. A centroid near quantile q may hold at most about
+// 2*pi*n*sqrt(q*(1-q))/compression points (the arcsine scale function), so
+// the tails stay sharp, the middle is summarised coarsely and the digest
+// keeps about compression/2 centroids however many points it has seen. Two
+// digests merge by folding one's centroids into the other. Min and max are
+// tracked exactly.
+class TDigest {
+public:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+private:
+    double compression;
+    std::vector<Centroid> centroids;    // sorted by mean
+    std::vector<Centroid> buffer;       // unmerged points
+    std::vector<Centroid> scratch;
+    size_t bufferLimit;
+    double totalWeight;                 // merged + buffered
+    double minValue;
+    double maxValue;
+
+    void flush();
+
+public:
+    explicit TDigest(double compression = 200.0);
+
+    void add(double value, double weight = 1.0);
+    void merge(const TDigest& other);
+    void clear();
+
+    // Folds the buffer in; quantile() does this on demand
+    void compress() { flush(); }
+
+    double quantile(double q);
+    double count() const { return totalWeight; }
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    size_t centroidCount() const { return centroids.size(); }
+};
@@ -0,0 +1,102 @@
+#include "SessionStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+SymbolStatistics::SymbolStatistics()
+    : trades(0),
+    volume(0.0),
+    notional(0.0),
+    lastPrice(0.0),
+    firstTimestamp(0),
+    lastTimestamp(0),
+    returnCount(0),
+    returnMean(0.0),
+    returnM2(0.0) {
+}
+
+void SymbolStatistics::clear() {
+    *this = SymbolStatistics();
+}
+
+void SymbolStatistics::add(const TickRecord& trade) {
+    if (trade.price <= 0.0) return;
+
+    if (trades == 0) firstTimestamp = trade.timestamp;
+    lastTimestamp = trade.timestamp;
+    ++trades;
+    volume += trade.volume;
+    notional += trade.volume * trade.price;
+
+    if (lastPrice > 0.0) {
+        double r = std::log(trade.price / lastPrice);
+        ++returnCount;
+        double delta = r - returnMean;
+        returnMean += delta / returnCount;
+        returnM2 += delta * (r - returnMean);
+    }
+    lastPrice = trade.price;
+
+    prices.add(trade.price);
+    if (trade.volume > 0.0)
+        sizes.add(trade.volume);
+}
+
+void SymbolStatistics::merge(const SymbolStatistics& other) {
+    if (other.trades == 0) return;
+    if (trades == 0) {
+        *this = other;
+        return;
+    }
+
+    // Chan et al. parallel combination of the return moments
+    if (other.returnCount > 0) {
+        quint64 n = returnCount + other.returnCount;
+        double delta = other.returnMean - returnMean;
+        returnMean += delta * other.returnCount / n;
+        returnM2 += other.returnM2 + delta * delta * (static_cast<double>(returnCount) * other.returnCount / n);
+        returnCount = n;
+    }
+
+    trades += other.trades;
+    volume += other.volume;
+    notional += other.notional;
+    if (other.lastTimestamp >= lastTimestamp) {
+        lastTimestamp = other.lastTimestamp;
+        lastPrice = other.lastPrice;
+    }
+    firstTimestamp = std::min(firstTimestamp, other.firstTimestamp);
+
+    prices.merge(other.prices);
+    sizes.merge(other.sizes);
+}
+
+StatisticsSnapshot SymbolStatistics::snapshot() {
+    StatisticsSnapshot s;
+    s.trades = trades;
+    s.volume = volume;
+    s.notional = notional;
+    s.vwap = volume > 0.0 ? notional / volume : 0.0;
+    s.returnMean = returnMean;
+    s.returnStdev = returnCount > 1 ? std::sqrt(returnM2 / (returnCount - 1)) : 0.0;
+    s.firstTimestamp = firstTimestamp;
+    s.lastTimestamp = lastTimestamp;
+    if (trades == 0) return s;
+
+    s.low = prices.min();
+    s.high = prices.max();
+    for (size_t i = 0; i < s.priceQuantiles.size(); ++i) {
+        s.priceQuantiles[i] = prices.quantile(StatisticsSnapshot::PriceLevels[i]);
+    }
+    if (sizes.count() > 0.0) {
+        for (size_t i = 0; i < s.sizeQuantiles.size(); ++i) {
+            s.sizeQuantiles[i] = sizes.quantile(StatisticsSnapshot::SizeLevels[i]);
+        }
+    }
+    return s;
+}
+
+SymbolStatistics& StatisticsEngine::symbol(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= symbols.size())
+        symbols.resize(symbolId + 1);
+    return symbols[symbolId];
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QtGlobal>
+#include <array>
+#include <vector>
+#include "MarketTick.h"
+#include "QuantileSketch.h"
+
+// Point-in-time copy of one symbol's statistics, cheap to display or export
+struct StatisticsSnapshot {
+    static constexpr std::array<double, 5> PriceLevels = { 0.05, 0.25, 0.50, 0.75, 0.95 };
+    static constexpr std::array<double, 3> SizeLevels = { 0.50, 0.90, 0.99 };
+
+    quint64 trades = 0;
+    double volume = 0.0;
+    double notional = 0.0;
+    double vwap = 0.0;
+    double returnMean = 0.0;        // per-trade log return
+    double returnStdev = 0.0;
+    double low = 0.0;
+    double high = 0.0;
+    qint64 firstTimestamp = 0;
+    qint64 lastTimestamp = 0;
+    std::array<double, PriceLevels.size()> priceQuantiles{};
+    std::array<double, SizeLevels.size()> sizeQuantiles{};
+};
+
+// Running statistics for one symbol's trades in bounded memory: counts and
+// sums, Welford mean/variance of log returns, and t-digests for price and
+// trade size. Everything merges, so per-thread or per-day instances can be
+// combined without revisiting ticks.
+class SymbolStatistics {
+private:
+    quint64 trades;
+    double volume;
+    double notional;
+    double lastPrice;
+    qint64 firstTimestamp;
+    qint64 lastTimestamp;
+
+    // Welford over log returns
+    quint64 returnCount;
+    double returnMean;
+    double returnM2;
+
+    TDigest prices;
+    TDigest sizes;
+
+public:
+    SymbolStatistics();
+
+    void add(const TickRecord& trade);
+    void merge(const SymbolStatistics& other);
+    void clear();
+    // The next trade starts a new return chain, so no return spans a feed gap
+    void breakReturns() { lastPrice = 0.0; }
+
+    quint64 tradeCount() const { return trades; }
+    StatisticsSnapshot snapshot();
+};
+
+// Statistics for every symbol, indexed by TickStore symbol id
+class StatisticsEngine {
+private:
+    std::vector<SymbolStatistics> symbols;
+
+public:
+    SymbolStatistics& symbol(int symbolId);
+
+    void add(int symbolId, const TickRecord& trade) { symbol(symbolId).add(trade); }
+    StatisticsSnapshot snapshot(int symbolId) { return symbol(symbolId).snapshot(); }
+    void breakReturns() { for (SymbolStatistics& s : symbols) s.breakReturns(); }
+    void clear() { symbols.clear(); }
+};
@@ -0,0 +1,344 @@
+#include "StateSnapshot.h"
+#include "OrderBook.h"
+#include "TickStore.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+    const char SnapshotMagic[4] = { 'L', 'T', 'S', '1' };
+    constexpr quint32 SnapshotVersion = 1;
+    constexpr qint64 GrowthStep = 1 << 20;
+
+    struct Header {
+        char magic[4];
+        quint32 version;
+        quint64 generation;
+        qint64 savedAtMs;
+        quint64 payloadBytes;
+        qint64 barIntervalMs;
+        quint32 mode;
+        quint32 symbolCount;
+        quint32 watchedCount;
+        quint32 reserved[2];
+        quint32 crc;              // header up to here, then the payload
+    };
+    constexpr size_t HeaderSize = 64;
+    constexpr size_t CrcOffset = offsetof(Header, crc);
+    static_assert(sizeof(Header) == HeaderSize, "snapshot header must be packed");
+    static_assert(std::is_trivially_copyable_v<TickRecord> && sizeof(TickRecord) % 8 == 0,
+        "tick records are copied into the snapshot as raw 8-byte aligned arrays");
+    static_assert(std::is_trivially_copyable_v<Bar>, "open bars are copied into the snapshot as raw bytes");
+
+    constexpr size_t align8(size_t value) {
+        return (value + 7) & ~size_t(7);
+    }
+
+    size_t stringSize(const QByteArray& utf8) {
+        return 2 + static_cast<size_t>(utf8.size());
+    }
+
+    quint32 checksum(const Header& header, const uchar* payload) {
+        quint32 crc = OrderBook::crc32(reinterpret_cast<const char*>(&header), CrcOffset);
+        return OrderBook::crc32(reinterpret_cast<const char*>(payload), header.payloadBytes, crc);
+    }
+
+    class Writer {
+    private:
+        uchar* p;
+
+    public:
+        explicit Writer(uchar* p) : p(p) {}
+
+        template <typename T>
+        void put(const T& value) {
+            std::memcpy(p, &value, sizeof(T));
+            p += sizeof(T);
+        }
+
+        void putString(const QByteArray& utf8) {
+            put<quint16>(static_cast<quint16>(utf8.size()));
+            std::memcpy(p, utf8.constData(), utf8.size());
+            p += utf8.size();
+        }
+
+        void alignFrom(const uchar* base) {
+            size_t used = static_cast<size_t>(p - base);
+            std::memset(p, 0, align8(used) - used);
+            p += align8(used) - used;
+        }
+
+        uchar* position() const { return p; }
+        void skip(size_t bytes) { p += bytes; }
+    };
+
+    // Bounds-checked mirror of Writer; any overrun marks the snapshot as corrupt
+    class Reader {
+    private:
+        const uchar* base;
+        const uchar* p;
+        const uchar* end;
+        bool failed = false;
+
+    public:
+        Reader(const uchar* base, size_t size) : base(base), p(base), end(base + size) {}
+
+        bool ok() const { return !failed; }
+
+        bool take(void* out, size_t bytes) {
+            if (failed || static_cast<size_t>(end - p) < bytes) {
+                failed = true;
+                return false;
+            }
+            std::memcpy(out, p, bytes);
+            p += bytes;
+            return true;
+        }
+
+        QString takeString() {
+            quint16 length = 0;
+            if (!take(&length, sizeof(length)) || static_cast<size_t>(end - p) < length) {
+                failed = true;
+                return QString();
+            }
+            QString value = QString::fromUtf8(reinterpret_cast<const char*>(p), length);
+            p += length;
+            return value;
+        }
+
+        const uchar* skip(size_t bytes) {
+            if (failed || static_cast<size_t>(end - p) < bytes) {
+                failed = true;
+                return nullptr;
+            }
+            const uchar* at = p;
+            p += bytes;
+            return at;
+        }
+
+        void align() {
+            size_t used = static_cast<size_t>(p - base);
+            skip(align8(used) - used);
+        }
+    };
+}
+
+StateSnapshot::StateSnapshot(const QString& directory)
+    : directory(directory) {
+}
+
+StateSnapshot::~StateSnapshot() {
+    close();
+}
+
+QString StateSnapshot::defaultDirectory() {
+    QString configured = qEnvironmentVariable("LIGHTNINGTRADE_STATE");
+    if (!configured.isEmpty())
+        return configured;
+    return QDir(QCoreApplication::applicationDirPath()).filePath("state");
+}
+
+bool StateSnapshot::open(QString* error) {
+    close();
+
+    QDir dir(directory);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        if (error) *error = QString("State directory not available: %1").arg(directory);
+        return false;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        Slot& slot = files[i];
+        slot.file.setFileName(dir.filePath(QString("state-%1.ltss").arg(i)));
+        if (!slot.file.open(QIODevice::ReadWrite)) {
+            if (error) *error = QString("Cannot open %1: %2").arg(slot.file.fileName(), slot.file.errorString());
+            close();
+            return false;
+        }
+        slot.size = slot.file.size();
+        if (slot.size > 0)
+            slot.data = slot.file.map(0, slot.size);
+    }
+
+    // The newest intact file is the one the next save must not touch
+    for (int i = 0; i < 2; ++i) {
+        const Slot& slot = files[i];
+        if (!slot.data || !parse(slot.data, slot.size, nullptr))
+            continue;
+        Header header;
+        std::memcpy(&header, slot.data, HeaderSize);
+        if (newest < 0 || header.generation > generation) {
+            newest = i;
+            generation = header.generation;
+        }
+    }
+    return true;
+}
+
+void StateSnapshot::close() {
+    for (Slot& slot : files) {
+        unmapSlot(slot);
+        slot.file.close();
+        slot.size = 0;
+    }
+    newest = -1;
+    generation = 0;
+}
+
+void StateSnapshot::unmapSlot(Slot& slot) {
+    if (slot.data)
+        slot.file.unmap(slot.data);
+    slot.data = nullptr;
+}
+
+bool StateSnapshot::mapSlot(Slot& slot, qint64 minimumSize) {
+    if (slot.data && slot.size >= minimumSize)
+        return true;
+
+    // Grow in whole steps so a slowly growing state does not remap on every save
+    unmapSlot(slot);
+    if (slot.size < minimumSize) {
+        qint64 size = (minimumSize + minimumSize / 4 + GrowthStep - 1) / GrowthStep * GrowthStep;
+        if (!slot.file.resize(size)) {
+            qWarning() << "Cannot grow state snapshot" << slot.file.fileName() << slot.file.errorString();
+            return false;
+        }
+        slot.size = size;
+    }
+    slot.data = slot.file.map(0, slot.size);
+    return slot.data != nullptr;
+}
+
+bool StateSnapshot::save(const TickStore& store, const BarAggregator& bars, const QStringList& watched,
+    quint32 mode, qint64 nowMs) {
+    if (!isOpen())
+        return false;
+
+    // Size everything first so the file is grown (and remapped) at most once
+    std::vector<QByteArray> watchedNames;
+    watchedNames.reserve(watched.size());
+    size_t payload = 0;
+    for (const QString& symbol : watched) {
+        watchedNames.push_back(symbol.toUtf8());
+        payload += stringSize(watchedNames.back());
+    }
+    payload = align8(payload);
+
+    std::vector<int> saved;
+    std::vector<QByteArray> names;
+    for (int id = 0; id < store.symbolCount(); ++id) {
+        const TickBuffer& buffer = store.buffer(id);
+        if (buffer.empty() && !bars.openBar(id))
+            continue;
+        saved.push_back(id);
+        names.push_back(store.symbolName(id).toUtf8());
+        payload += align8(stringSize(names.back())) + 8 + align8(sizeof(Bar)) + buffer.size() * sizeof(TickRecord);
+    }
+
+    int target = newest < 0 ? 0 : 1 - newest;
+    Slot& slot = files[target];
+    if (!mapSlot(slot, static_cast<qint64>(HeaderSize + payload)))
+        return false;
+
+    uchar* const base = slot.data + HeaderSize;
+    Writer out(base);
+    for (const QByteArray& name : watchedNames) {
+        out.putString(name);
+    }
+    out.alignFrom(base);
+
+    for (size_t i = 0; i < saved.size(); ++i) {
+        const TickBuffer& buffer = store.buffer(saved[i]);
+        const Bar* bar = bars.openBar(saved[i]);
+        out.putString(names[i]);
+        out.alignFrom(base);
+        out.put<quint32>(static_cast<quint32>(buffer.size()));
+        out.put<quint32>(bar ? 1 : 0);
+        Bar openBar = bar ? *bar : Bar();
+        out.put(openBar);
+        out.alignFrom(base);
+        out.skip(buffer.copyTail(buffer.size(), reinterpret_cast<TickRecord*>(out.position())) * sizeof(TickRecord));
+    }
+
+    Header header{};
+    std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+    header.version = SnapshotVersion;
+    header.generation = generation + 1;
+    header.savedAtMs = nowMs;
+    header.payloadBytes = payload;
+    header.barIntervalMs = bars.interval();
+    header.mode = mode;
+    header.symbolCount = static_cast<quint32>(saved.size());
+    header.watchedCount = static_cast<quint32>(watchedNames.size());
+    header.crc = checksum(header, base);
+
+    // Commit: the header only lands after the whole payload
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(slot.data, &header, HeaderSize);
+
+    newest = target;
+    generation = header.generation;
+    lastBytes = static_cast<qint64>(HeaderSize + payload);
+    return true;
+}
+
+bool StateSnapshot::load(View& view) const {
+    if (newest < 0)
+        return false;
+    const Slot& slot = files[newest];
+    return parse(slot.data, slot.size, &view);
+}
+
+bool StateSnapshot::parse(const uchar* data, qint64 size, View* view) {
+    if (!data || size < static_cast<qint64>(HeaderSize))
+        return false;
+
+    Header header;
+    std::memcpy(&header, data, HeaderSize);
+    if (std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 || header.version != SnapshotVersion)
+        return false;
+    if (header.payloadBytes > static_cast<quint64>(size) - HeaderSize)
+        return false;
+    const uchar* payload = data + HeaderSize;
+    if (checksum(header, payload) != header.crc)
+        return false;
+    if (!view)
+        return true;
+
+    View result;
+    result.generation = header.generation;
+    result.savedAtMs = header.savedAtMs;
+    result.mode = header.mode;
+    result.barIntervalMs = header.barIntervalMs;
+    result.bytes = static_cast<qint64>(HeaderSize + header.payloadBytes);
+
+    Reader in(payload, header.payloadBytes);
+    for (quint32 i = 0; i < header.watchedCount && in.ok(); ++i) {
+        result.watched.append(in.takeString());
+    }
+    in.align();
+
+    result.symbols.reserve(header.symbolCount);
+    for (quint32 i = 0; i < header.symbolCount && in.ok(); ++i) {
+        SymbolState symbol;
+        symbol.symbol = in.takeString();
+        in.align();
+        quint32 count = 0, hasBar = 0;
+        in.take(&count, sizeof(count));
+        in.take(&hasBar, sizeof(hasBar));
+        in.take(&symbol.openBar, sizeof(Bar));
+        in.align();
+        symbol.hasOpenBar = hasBar != 0;
+        symbol.tickCount = count;
+        symbol.ticks = reinterpret_cast<const TickRecord*>(in.skip(count * sizeof(TickRecord)));
+        result.symbols.push_back(symbol);
+    }
+    if (!in.ok())
+        return false;
+
+    *view = std::move(result);
+    return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "BarAggregator.h"
+#include "MarketTick.h"
+
+class TickStore;
+
+// Periodic image of the live state - every symbol's tick buffer, the open
+// bars and the watch list - so a restarted instance comes back with full
+// charts instead of blank ones.
+//
+// Two memory-mapped files, "state-0.ltss" and "state-1.ltss", are written in
+// turn: the payload is copied straight from the tick buffers into the older
+// file's mapping and its 64-byte header (generation, sizes, CRC32 over header
+// and payload) goes in last. A crash mid-save leaves a header whose CRC no
+// longer matches, and load() falls back to the other file, so there is always
+// one intact snapshot. Writes reach the page cache, which survives a process
+// crash; Qt has no msync, so a power loss can cost the newest snapshot or two.
+//
+// load() does not copy: tick arrays are 8-byte aligned in the mapping and
+// handed out as pointers for the caller to append from.
+class StateSnapshot {
+public:
+    struct SymbolState {
+        QString symbol;
+        const TickRecord* ticks = nullptr;   // oldest first, inside the mapping
+        size_t tickCount = 0;
+        bool hasOpenBar = false;
+        Bar openBar;
+    };
+
+    struct View {
+        quint64 generation = 0;
+        qint64 savedAtMs = 0;
+        quint32 mode = 0;                    // caller-defined, e.g. the data source
+        qint64 barIntervalMs = 0;
+        QStringList watched;
+        std::vector<SymbolState> symbols;
+        qint64 bytes = 0;
+    };
+
+private:
+    struct Slot {
+        QFile file;
+        uchar* data = nullptr;
+        qint64 size = 0;
+    };
+
+    QString directory;
+    Slot files[2];
+    int newest = -1;          // slot holding the newest intact snapshot
+    quint64 generation = 0;
+    qint64 lastBytes = 0;
+
+    bool mapSlot(Slot& slot, qint64 minimumSize);
+    void unmapSlot(Slot& slot);
+    static bool parse(const uchar* data, qint64 size, View* view);
+
+public:
+    explicit StateSnapshot(const QString& directory = defaultDirectory());
+    ~StateSnapshot();
+
+    StateSnapshot(const StateSnapshot&) = delete;
+    StateSnapshot& operator=(const StateSnapshot&) = delete;
+
+    // "state" next to the executable, or $LIGHTNINGTRADE_STATE
+    static QString defaultDirectory();
+    QString path() const { return directory; }
+
+    // Creates the directory and maps both files
+    bool open(QString* error = nullptr);
+    void close();
+    bool isOpen() const { return files[0].file.isOpen(); }
+
+    // The newest intact snapshot. Its pointers stay valid until the next save() or close().
+    bool load(View& view) const;
+
+    // Writes the state into the older file; returns false (keeping the previous
+    // snapshot) if the file cannot be grown or mapped
+    bool save(const TickStore& store, const BarAggregator& bars, const QStringList& watched,
+        quint32 mode, qint64 nowMs);
+
+    quint64 lastGeneration() const { return generation; }
+    qint64 lastSaveBytes() const { return lastBytes; }
+};
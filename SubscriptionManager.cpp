@@ -0,0 +1,200 @@
+#include "SubscriptionManager.h"
+#include <QDebug>
+#include <QJsonArray>
+
+SubscriptionManager::SubscriptionManager(TickStore& store, SendFunction send, const SubscriptionFormat& format)
+    : tickStore(store),
+    send(std::move(send)),
+    format(format),
+    connected(false),
+    channels{ QJsonObject{{"name", "trade"}} },
+    unroutedFrames(0),
+    subscriptionErrors(0) {
+}
+
+void SubscriptionManager::setChannels(const QStringList& names) {
+    channels.clear();
+    for (const QString& name : names) {
+        channels.append(QJsonObject{ {"name", name} });
+    }
+}
+
+void SubscriptionManager::addChannel(const QJsonObject& subscription) {
+    if (!channels.contains(subscription))
+        channels.append(subscription);
+}
+
+SubscriptionManager::Channel SubscriptionManager::channelFromName(const QString& channelName) {
+    if (channelName == "trade") return Channel::Trade;
+    if (channelName.startsWith("book")) return Channel::Book;
+    if (channelName == "spread") return Channel::Spread;
+    if (channelName == "ticker") return Channel::Ticker;
+    return Channel::Unknown;
+}
+
+void SubscriptionManager::sendBatch(const QString& event, const QStringList& symbols) {
+    if (!connected || symbols.isEmpty() || !send)
+        return;
+
+    QJsonArray pairs;
+    for (const QString& symbol : symbols) {
+        pairs.append(format.toVenueSymbol(symbol));
+    }
+
+    // Kraken takes one channel per message, but any number of pairs
+    for (const QJsonObject& subscription : channels) {
+        sendBatch(event, pairs, subscription);
+    }
+}
+
+void SubscriptionManager::sendBatch(const QString& event, const QJsonArray& pairs, const QJsonObject& subscription) {
+    send(format.subscriptionRequest(event == "subscribe", pairs, subscription));
+}
+
+void SubscriptionManager::resync(const QString& symbol, const QString& channelName) {
+    if (!connected || !send || !watched.contains(symbol))
+        return;
+
+    QJsonArray pairs{ format.toVenueSymbol(symbol) };
+    for (const QJsonObject& subscription : channels) {
+        if (!channelName.startsWith(subscription.value("name").toString()))
+            continue;
+        sendBatch("unsubscribe", pairs, subscription);
+        sendBatch("subscribe", pairs, subscription);
+    }
+}
+
+void SubscriptionManager::watch(const QStringList& symbols) {
+    QStringList added;
+    for (const QString& symbol : symbols) {
+        QString normalized = KrakenMessageParser::normalizeSymbol(symbol);
+        if (normalized.isEmpty() || watched.contains(normalized) || added.contains(normalized))
+            continue;
+        added.append(normalized);
+    }
+    if (added.isEmpty()) return;
+
+    for (const QString& symbol : added) {
+        int symbolId = tickStore.symbolId(symbol);
+        pairSymbolIds.insert(format.toVenueSymbol(symbol), symbolId);
+    }
+    watched.append(added);
+    sendBatch("subscribe", added);
+}
+
+void SubscriptionManager::unwatch(const QStringList& symbols) {
+    QStringList removed;
+    for (const QString& symbol : symbols) {
+        QString normalized = KrakenMessageParser::normalizeSymbol(symbol);
+        if (watched.removeAll(normalized) > 0)
+            removed.append(normalized);
+    }
+    if (removed.isEmpty()) return;
+
+    sendBatch("unsubscribe", removed);
+
+    // Stop routing immediately; late frames for these pairs are dropped
+    for (const QString& symbol : removed) {
+        int symbolId = tickStore.findSymbol(symbol);
+        pairSymbolIds.remove(format.toVenueSymbol(symbol));
+        for (auto it = routes.begin(); it != routes.end();) {
+            if (it.value().symbolId == symbolId)
+                it = routes.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+void SubscriptionManager::setWatched(const QStringList& symbols) {
+    QStringList normalized;
+    for (const QString& symbol : symbols) {
+        normalized.append(KrakenMessageParser::normalizeSymbol(symbol));
+    }
+
+    QStringList removed;
+    for (const QString& symbol : watched) {
+        if (!normalized.contains(symbol))
+            removed.append(symbol);
+    }
+
+    unwatch(removed);
+    watch(normalized);
+}
+
+void SubscriptionManager::setConnected(bool isConnected) {
+    connected = isConnected;
+    // Channel IDs are per connection
+    routes.clear();
+    if (connected)
+        resubscribeAll();
+}
+
+void SubscriptionManager::resubscribeAll() {
+    routes.clear();
+    sendBatch("subscribe", watched);
+}
+
+void SubscriptionManager::handleEvent(const QJsonObject& event) {
+    SubscriptionStatus status;
+    if (!format.parseSubscriptionStatus || !format.parseSubscriptionStatus(event, status))
+        return;
+
+    // Venues without channel ids route by pair, so only errors matter there
+    if (status.kind == SubscriptionStatus::Kind::Subscribed && status.channelId >= 0) {
+        int symbolId = pairSymbolIds.value(status.pair, -1);
+        if (symbolId < 0) return; // subscribed to something we no longer watch
+
+        ChannelRoute route;
+        route.symbolId = symbolId;
+        route.channel = channelFromName(status.channelName);
+        routes.insert(status.channelId, route);
+    }
+    else if (status.kind == SubscriptionStatus::Kind::Unsubscribed && status.channelId >= 0) {
+        routes.remove(status.channelId);
+    }
+    else if (status.kind == SubscriptionStatus::Kind::Error) {
+        ++subscriptionErrors;
+        qWarning() << "Subscription error for" << status.pair << status.errorMessage;
+        if (errorConsumer)
+            errorConsumer(status);
+    }
+}
+
+int SubscriptionManager::route(int channelId, const QString& pair) const {
+    auto it = routes.constFind(channelId);
+    if (it != routes.constEnd())
+        return it.value().symbolId;
+    return pairSymbolIds.value(pair, -1);
+}
+
+void SubscriptionManager::setTradeConsumer(int symbolId, TradeConsumer consumer) {
+    if (symbolId < 0) return;
+    if (static_cast<size_t>(symbolId) >= tradeConsumers.size())
+        tradeConsumers.resize(symbolId + 1);
+    tradeConsumers[symbolId] = std::move(consumer);
+}
+
+bool SubscriptionManager::dispatch(const KrakenMessageParser::Message& message) {
+    int symbolId = route(message.channelId, message.pair);
+    if (symbolId < 0) {
+        ++unroutedFrames;
+        return false;
+    }
+
+    if (message.type == KrakenMessageParser::MessageType::Trade) {
+        if (static_cast<size_t>(symbolId) < tradeConsumers.size() && tradeConsumers[symbolId])
+            tradeConsumers[symbolId](symbolId, message.trades);
+        else if (defaultTradeConsumer)
+            defaultTradeConsumer(symbolId, message.trades);
+    }
+    else if (message.type == KrakenMessageParser::MessageType::Book) {
+        if (bookConsumer)
+            bookConsumer(symbolId, message.book);
+    }
+    else if (message.type == KrakenMessageParser::MessageType::Quote) {
+        if (quoteConsumer)
+            quoteConsumer(symbolId, message.quote);
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <vector>
+#include "ExchangeAdapter.h"
+#include "KrakenAdapters.h"
+#include "TickStore.h"
+
+// Tracks the set of watched pairs and subscribed channels, sends batched
+// subscribe/unsubscribe messages and routes data frames by Kraken channelID.
+// Pair names and message layout come from the venue's SubscriptionFormat
+// (Kraken v1 unless given).
+//
+// Symbols are addressed by their TickStore id. Once Kraken confirms a
+// subscription, routing a frame is a single integer hash lookup on its
+// channelID; the pair string is only consulted before confirmation arrives,
+// and always on venues without channel ids (Kraken v2).
+class SubscriptionManager {
+public:
+    enum class Channel {
+        Unknown,
+        Trade,
+        Book,
+        Spread,
+        Ticker
+    };
+
+    using SendFunction = std::function<void(const QString& message)>;
+    using TradeConsumer = std::function<void(int symbolId, const std::vector<TickRecord>& trades)>;
+    using BookConsumer = std::function<void(int symbolId, const BookUpdate& update)>;
+    using QuoteConsumer = std::function<void(int symbolId, const KrakenMessageParser::Quote& quote)>;
+    using ErrorConsumer = std::function<void(const SubscriptionStatus& status)>;
+
+    struct ChannelRoute {
+        int symbolId = -1;
+        Channel channel = Channel::Unknown;
+    };
+
+private:
+    TickStore& tickStore;
+    SendFunction send;
+    SubscriptionFormat format;
+    bool connected;
+
+    QStringList watched;                  // UI symbols, in watch order
+    QList<QJsonObject> channels;          // subscription objects, e.g. {"name":"trade"}
+    QHash<int, ChannelRoute> routes;      // Kraken channelID -> route
+    QHash<QString, int> pairSymbolIds;    // venue pair -> symbol id (fallback)
+
+    std::vector<TradeConsumer> tradeConsumers;   // indexed by symbol id
+    TradeConsumer defaultTradeConsumer;
+    BookConsumer bookConsumer;
+    QuoteConsumer quoteConsumer;
+    ErrorConsumer errorConsumer;
+
+    quint64 unroutedFrames;
+    quint64 subscriptionErrors;
+
+    void sendBatch(const QString& event, const QStringList& symbols);
+    void sendBatch(const QString& event, const QJsonArray& pairs, const QJsonObject& subscription);
+    static Channel channelFromName(const QString& channelName);
+
+public:
+    SubscriptionManager(TickStore& store, SendFunction send,
+        const SubscriptionFormat& format = SubscriptionFormat::of<KrakenV1>());
+
+    // Pair name on the venue, e.g. "XBT/USD" for "BTCUSD" on Kraken v1
+    QString venueSymbol(const QString& symbol) const { return format.toVenueSymbol(symbol); }
+
+    // Channels subscribed for every watched pair. Plain names ("trade") or
+    // full subscription objects ({"name":"book","depth":10}); the venue's
+    // format translates them.
+    void setChannels(const QStringList& names);
+    void addChannel(const QJsonObject& subscription);
+
+    // Unsubscribe and resubscribe one channel for one symbol, e.g. to
+    // resynchronise an order book after a checksum mismatch
+    void resync(const QString& symbol, const QString& channelName);
+
+    // Subscribe/unsubscribe every symbol not already in that state, in one
+    // message per channel. While disconnected only the watch set changes.
+    void watch(const QStringList& symbols);
+    void unwatch(const QStringList& symbols);
+    void setWatched(const QStringList& symbols);
+
+    bool isWatched(const QString& symbol) const { return watched.contains(symbol); }
+    const QStringList& watchedSymbols() const { return watched; }
+
+    // Connection state; on connect the whole watch set is resubscribed in one batch
+    void setConnected(bool isConnected);
+    void resubscribeAll();
+
+    // Feed event objects. Acknowledgements are read by the venue's format:
+    // confirmations maintain the channel map, rejections go to the error consumer.
+    void handleEvent(const QJsonObject& event);
+
+    // Symbol id for a data frame, or -1 if it is not routable
+    int route(int channelId, const QString& pair) const;
+
+    void setTradeConsumer(int symbolId, TradeConsumer consumer);
+    void setDefaultTradeConsumer(TradeConsumer consumer) { defaultTradeConsumer = std::move(consumer); }
+    void setBookConsumer(BookConsumer consumer) { bookConsumer = std::move(consumer); }
+    void setQuoteConsumer(QuoteConsumer consumer) { quoteConsumer = std::move(consumer); }
+    void setErrorConsumer(ErrorConsumer consumer) { errorConsumer = std::move(consumer); }
+
+    // Routes a parsed data frame to its symbol's consumer. Returns false if unroutable.
+    bool dispatch(const KrakenMessageParser::Message& message);
+
+    int confirmedChannels() const { return routes.size(); }
+    quint64 unroutedFrameCount() const { return unroutedFrames; }
+    quint64 subscriptionErrorCount() const { return subscriptionErrors; }
+};
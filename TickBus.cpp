@@ -0,0 +1,360 @@
+#include "TickBus.h"
+#include <QByteArray>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TickBus {
+    const char BusMagic[4] = { 'L', 'T', 'K', 'B' };
+    constexpr quint32 BusVersion = 1;
+
+    struct Header {
+        char magic[4];
+        quint32 version;
+        quint32 capacity;
+        quint32 slotSize;
+        quint32 symbolTableOffset;
+        quint32 ringOffset;
+        std::atomic<quint32> symbolCount;
+        std::atomic<quint32> publisherOpen;
+        char reserved[32];
+        alignas(64) std::atomic<quint64> writeCursor;   // own cache line: the only contended word
+    };
+    static_assert(sizeof(Header) == 128, "bus header is two cache lines");
+    static_assert(std::atomic<quint64>::is_always_lock_free && std::atomic<quint32>::is_always_lock_free,
+        "atomics in shared memory must be address-free");
+
+    constexpr size_t SymbolTableOffset = sizeof(Header);
+    constexpr size_t RingOffset = SymbolTableOffset + MaxSymbols * SymbolNameBytes;
+    static_assert(RingOffset % 64 == 0, "ring must be cache-line aligned");
+
+    size_t regionBytes(quint32 capacity) {
+        return RingOffset + static_cast<size_t>(capacity) * sizeof(Slot);
+    }
+
+    qint64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    Region::~Region() {
+        release();
+    }
+
+#ifdef _WIN32
+    bool Region::create(const QString& regionName, size_t size, QString* error) {
+        release();
+        std::wstring path = QString("Local\\%1").arg(regionName).toStdWString();
+        HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(static_cast<quint64>(size) >> 32), static_cast<DWORD>(size), path.c_str());
+        if (!mapping) {
+            if (error) *error = QString("CreateFileMapping failed (%1)").arg(GetLastError());
+            return false;
+        }
+        // An existing mapping (still held by a reader) keeps its original size
+        void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!view) {
+            if (error) *error = QString("MapViewOfFile failed (%1)").arg(GetLastError());
+            CloseHandle(mapping);
+            return false;
+        }
+        handle = mapping;
+        base = view;
+        bytes = size;
+        name = regionName;
+        owner = true;
+        return true;
+    }
+
+    bool Region::attach(const QString& regionName, QString* error) {
+        release();
+        std::wstring path = QString("Local\\%1").arg(regionName).toStdWString();
+        HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, path.c_str());
+        if (!mapping) {
+            if (error) *error = QString("No tick bus named %1").arg(regionName);
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info;
+        if (!view || !VirtualQuery(view, &info, sizeof(info))) {
+            if (error) *error = QString("MapViewOfFile failed (%1)").arg(GetLastError());
+            if (view) UnmapViewOfFile(view);
+            CloseHandle(mapping);
+            return false;
+        }
+        handle = mapping;
+        base = view;
+        bytes = info.RegionSize;
+        name = regionName;
+        owner = false;
+        return true;
+    }
+
+    void Region::release() {
+        if (base) UnmapViewOfFile(base);
+        if (handle) CloseHandle(static_cast<HANDLE>(handle));
+        base = nullptr;
+        handle = nullptr;
+        bytes = 0;
+    }
+#else
+    bool Region::create(const QString& regionName, size_t size, QString* error) {
+        release();
+        QByteArray path = "/" + regionName.toUtf8();
+        int fd = shm_open(path.constData(), O_RDWR | O_CREAT, 0644);
+        struct stat st;
+        if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size != 0 && static_cast<size_t>(st.st_size) != size) {
+            // Different capacity: readers still mapping the old region keep it, new ones get this one
+            ::close(fd);
+            shm_unlink(path.constData());
+            fd = shm_open(path.constData(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        }
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            if (error) *error = QString("Cannot create /dev/shm%1: %2").arg(QString::fromUtf8(path), QString::fromLocal8Bit(strerror(errno)));
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            if (error) *error = QString("mmap failed: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+            return false;
+        }
+        base = view;
+        bytes = size;
+        name = regionName;
+        owner = true;
+        return true;
+    }
+
+    bool Region::attach(const QString& regionName, QString* error) {
+        release();
+        QByteArray path = "/" + regionName.toUtf8();
+        int fd = shm_open(path.constData(), O_RDONLY, 0);
+        if (fd < 0) {
+            if (error) *error = QString("No tick bus at /dev/shm%1").arg(QString::fromUtf8(path));
+            return false;
+        }
+        struct stat st;
+        void* view = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            if (error) *error = QString("Cannot map /dev/shm%1").arg(QString::fromUtf8(path));
+            return false;
+        }
+        base = view;
+        bytes = static_cast<size_t>(st.st_size);
+        name = regionName;
+        owner = false;
+        return true;
+    }
+
+    void Region::release() {
+        if (base) munmap(base, bytes);
+        base = nullptr;
+        bytes = 0;
+    }
+#endif
+}
+
+using namespace TickBus;
+
+TickBusPublisher::~TickBusPublisher() {
+    close();
+}
+
+bool TickBusPublisher::open(const QString& name, quint32 capacity, QString* error) {
+    close();
+
+    quint32 rounded = 1;
+    while (rounded < std::max<quint32>(capacity, 2)) rounded <<= 1;
+    if (!region.create(name, regionBytes(rounded), error))
+        return false;
+
+    header = static_cast<Header*>(region.data());
+    ring = reinterpret_cast<Slot*>(static_cast<char*>(region.data()) + RingOffset);
+    mask = rounded - 1;
+    symbolIds.clear();
+
+    // Adopt a ring left by a previous publisher so attached readers keep their place
+    bool adopt = std::memcmp(header->magic, BusMagic, sizeof(BusMagic)) == 0 && header->version == BusVersion
+        && header->capacity == rounded && header->slotSize == sizeof(Slot);
+    if (adopt) {
+        next = header->writeCursor.load(std::memory_order_relaxed);
+        quint32 count = std::min(header->symbolCount.load(std::memory_order_relaxed), MaxSymbols);
+        const char* table = static_cast<const char*>(region.data()) + SymbolTableOffset;
+        for (quint32 id = 0; id < count; ++id) {
+            const char* entry = table + id * SymbolNameBytes;
+            symbolIds.insert(QString::fromUtf8(entry, static_cast<int>(strnlen(entry, SymbolNameBytes))), static_cast<quint16>(id));
+        }
+    }
+    else {
+        std::memset(region.data(), 0, region.size());
+        std::memcpy(header->magic, BusMagic, sizeof(BusMagic));
+        header->version = BusVersion;
+        header->capacity = rounded;
+        header->slotSize = sizeof(Slot);
+        header->symbolTableOffset = SymbolTableOffset;
+        header->ringOffset = RingOffset;
+        next = 0;
+    }
+    header->publisherOpen.store(1, std::memory_order_release);
+    return true;
+}
+
+void TickBusPublisher::close() {
+    if (!header) return;
+    header->publisherOpen.store(0, std::memory_order_release);
+    region.release();
+    header = nullptr;
+    ring = nullptr;
+}
+
+int TickBusPublisher::symbolId(const QString& symbol) {
+    auto it = symbolIds.constFind(symbol);
+    if (it != symbolIds.constEnd())
+        return it.value();
+    if (!header) return -1;
+
+    quint32 id = header->symbolCount.load(std::memory_order_relaxed);
+    if (id >= MaxSymbols)
+        return -1;
+
+    // Name first, then the count that makes it visible
+    char* entry = static_cast<char*>(region.data()) + SymbolTableOffset + id * SymbolNameBytes;
+    QByteArray utf8 = symbol.toUtf8().left(SymbolNameBytes - 1);
+    std::memset(entry, 0, SymbolNameBytes);
+    std::memcpy(entry, utf8.constData(), utf8.size());
+    header->symbolCount.store(id + 1, std::memory_order_release);
+    symbolIds.insert(symbol, static_cast<quint16>(id));
+    return static_cast<int>(id);
+}
+
+void TickBusPublisher::publish(const QString& symbol, const TickRecord& tick) {
+    publish(symbolId(symbol), tick);
+}
+
+void TickBusPublisher::publish(int symbolId, const TickRecord& tick) {
+    if (!header || symbolId < 0) return;
+
+    Slot& slot = ring[next & mask];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.publishNs = nowNs();
+    slot.timestamp = tick.timestamp;
+    slot.price = tick.price;
+    slot.volume = tick.volume;
+    slot.bid = tick.bid;
+    slot.ask = tick.ask;
+    slot.symbolId = static_cast<quint16>(symbolId);
+    slot.side = tick.side;
+    slot.sequence.store(next + 1, std::memory_order_release);
+
+    ++next;
+    header->writeCursor.store(next, std::memory_order_release);
+}
+
+bool TickBusReader::open(const QString& name, bool fromLatest, QString* error) {
+    close();
+    if (!region.attach(name, error))
+        return false;
+
+    const Header* mapped = static_cast<const Header*>(region.data());
+    bool valid = region.size() >= sizeof(Header)
+        && std::memcmp(mapped->magic, BusMagic, sizeof(BusMagic)) == 0 && mapped->version == BusVersion
+        && mapped->slotSize == sizeof(Slot) && mapped->capacity > 0
+        && region.size() >= regionBytes(mapped->capacity);
+    if (!valid) {
+        if (error) *error = QString("%1 is not a tick bus (or is still being created)").arg(name);
+        region.release();
+        return false;
+    }
+
+    header = mapped;
+    ring = reinterpret_cast<const Slot*>(static_cast<const char*>(region.data()) + RingOffset);
+    mask = header->capacity - 1;
+    quint64 cursor = header->writeCursor.load(std::memory_order_acquire);
+    next = fromLatest ? cursor : (cursor > header->capacity ? cursor - header->capacity : 0);
+    lostCount = 0;
+    return true;
+}
+
+void TickBusReader::close() {
+    region.release();
+    header = nullptr;
+    ring = nullptr;
+}
+
+bool TickBusReader::publisherClosed() const {
+    return header && header->publisherOpen.load(std::memory_order_acquire) == 0;
+}
+
+quint64 TickBusReader::backlog() const {
+    if (!header) return 0;
+    quint64 cursor = header->writeCursor.load(std::memory_order_acquire);
+    return cursor > next ? cursor - next : 0;
+}
+
+QString TickBusReader::symbolName(int symbolId) const {
+    if (!header || symbolId < 0 || static_cast<quint32>(symbolId) >= header->symbolCount.load(std::memory_order_acquire))
+        return QString();
+    const char* entry = static_cast<const char*>(region.data()) + SymbolTableOffset + symbolId * SymbolNameBytes;
+    return QString::fromUtf8(entry, static_cast<int>(strnlen(entry, SymbolNameBytes)));
+}
+
+size_t TickBusReader::poll(const TickCallback& callback, size_t maxTicks) {
+    if (!header) return 0;
+
+    const quint64 capacity = mask + 1;
+    quint64 cursor = header->writeCursor.load(std::memory_order_acquire);
+    if (cursor < next)
+        next = cursor;   // a fresh region replaced an adopted one
+    if (cursor - next > capacity) {
+        lostCount += cursor - next - capacity;
+        next = cursor - capacity;
+    }
+
+    size_t delivered = 0;
+    Tick tick;
+    while (next < cursor && delivered < maxTicks) {
+        const Slot& slot = ring[next & mask];
+        quint64 before = slot.sequence.load(std::memory_order_acquire);
+        tick.publishNs = slot.publishNs;
+        tick.record.timestamp = slot.timestamp;
+        tick.record.price = slot.price;
+        tick.record.volume = slot.volume;
+        tick.record.bid = slot.bid;
+        tick.record.ask = slot.ask;
+        tick.record.side = slot.side;
+        tick.symbolId = slot.symbolId;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        quint64 after = slot.sequence.load(std::memory_order_relaxed);
+
+        if (before != next + 1 || after != before) {
+            // Lapped mid-copy: jump past what the publisher is overwriting now
+            quint64 latest = header->writeCursor.load(std::memory_order_acquire);
+            quint64 resume = std::max(next + 1, latest > capacity ? latest - capacity + 1 : 0);
+            lostCount += resume - next;
+            next = resume;
+            cursor = std::max(cursor, latest);
+            continue;
+        }
+
+        ++next;
+        ++delivered;
+        callback(tick);
+    }
+    return delivered;
+}
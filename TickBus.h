@@ -0,0 +1,141 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <atomic>
+#include <functional>
+#include "MarketTick.h"
+
+// Shared-memory broadcast of parsed ticks to other processes on the same host.
+//
+// One publisher owns a named region ("/dev/shm/<name>" on POSIX, a "Local\"
+// file mapping on Windows): a header, a table of up to MaxSymbols names and a
+// power-of-two ring of 64-byte slots, one cache line per tick. Publishing is a
+// plain store into the next slot bracketed by its sequence number - no locks,
+// no syscalls, and readers never write to the region, so any number of them
+// can attach (read-only) without slowing the publisher down.
+//
+// Each slot works as a seqlock: the publisher zeroes the slot's sequence,
+// writes the tick, then stores sequence + 1 with release ordering and bumps the
+// header's write cursor. A reader that falls more than a ring behind is told
+// how many ticks it lost and skips to the oldest slot still intact; a slot that
+// changes while being copied counts as lost the same way. The region outlives
+// the publisher: a restarted one with the same capacity adopts the ring, its
+// cursor and the symbol table, so attached readers simply carry on.
+namespace TickBus {
+    constexpr quint32 MaxSymbols = 256;
+    constexpr int SymbolNameBytes = 32;
+
+    struct Slot {
+        std::atomic<quint64> sequence;   // 0 while being written, else tick index + 1
+        qint64 publishNs;                // steady clock at publish, for reader latency
+        qint64 timestamp;
+        double price;
+        double volume;
+        double bid;
+        double ask;
+        quint16 symbolId;
+        char side;
+        char reserved[5];
+    };
+    static_assert(sizeof(Slot) == 64, "one tick per cache line");
+
+    struct Header;
+
+    // Host-wide monotonic clock shared by publisher and readers
+    qint64 nowNs();
+
+    // Platform shared memory mapping; internal to the bus
+    class Region {
+    private:
+        void* base = nullptr;
+        size_t bytes = 0;
+        void* handle = nullptr;   // Windows mapping handle
+        QString name;
+        bool owner = false;
+
+    public:
+        Region() = default;
+        ~Region();
+
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+
+        bool create(const QString& name, size_t bytes, QString* error);
+        bool attach(const QString& name, QString* error);
+        void release();
+
+        void* data() const { return base; }
+        size_t size() const { return bytes; }
+    };
+}
+
+class TickBusPublisher {
+private:
+    TickBus::Region region;
+    TickBus::Header* header = nullptr;
+    TickBus::Slot* ring = nullptr;
+    quint64 mask = 0;
+    quint64 next = 0;
+    QHash<QString, quint16> symbolIds;
+
+public:
+    static constexpr const char* DefaultName = "lightningtrade-ticks";
+
+    TickBusPublisher() = default;
+    ~TickBusPublisher();
+
+    TickBusPublisher(const TickBusPublisher&) = delete;
+    TickBusPublisher& operator=(const TickBusPublisher&) = delete;
+
+    // Creates (or takes over) the region; 'capacity' is rounded up to a power of two
+    bool open(const QString& name = DefaultName, quint32 capacity = 1 << 16, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Bus id for a symbol, registering it on first use; -1 once the table is full
+    int symbolId(const QString& symbol);
+
+    void publish(int symbolId, const TickRecord& tick);
+    void publish(const QString& symbol, const TickRecord& tick);
+
+    quint64 published() const { return next; }
+};
+
+class TickBusReader {
+public:
+    struct Tick {
+        TickRecord record;
+        int symbolId;
+        qint64 publishNs;
+    };
+    using TickCallback = std::function<void(const Tick& tick)>;
+
+private:
+    TickBus::Region region;
+    const TickBus::Header* header = nullptr;
+    const TickBus::Slot* ring = nullptr;
+    quint64 mask = 0;
+    quint64 next = 0;
+    quint64 lostCount = 0;
+
+public:
+    TickBusReader() = default;
+
+    // Attaches read-only. 'fromLatest' skips what is already in the ring.
+    bool open(const QString& name = TickBusPublisher::DefaultName, bool fromLatest = true, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Delivers up to 'maxTicks' new ticks in order; returns how many. Never blocks.
+    size_t poll(const TickCallback& callback, size_t maxTicks = 4096);
+
+    // The publisher closed the region; reopen to follow a new one
+    bool publisherClosed() const;
+
+    QString symbolName(int symbolId) const;
+    quint64 lost() const { return lostCount; }
+    quint64 position() const { return next; }
+    // Ticks published but not yet read
+    quint64 backlog() const;
+};
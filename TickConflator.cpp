@@ -0,0 +1,158 @@
+#include "TickConflator.h"
+#include <algorithm>
+
+TickConflator::TickConflator(size_t capacityPerSymbol, BackpressurePolicy policy)
+    : capacity(std::max<size_t>(capacityPerSymbol, 1)),
+    policy(policy) {
+}
+
+TickConflator::Slot& TickConflator::slotFor(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= symbolSlots.size())
+        symbolSlots.resize(symbolId + 1);
+    Slot& slot = symbolSlots[symbolId];
+    if (slot.ring.empty())
+        slot.ring.resize(capacity);
+    return slot;
+}
+
+void TickConflator::setPolicy(BackpressurePolicy newPolicy) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        policy = newPolicy;
+    }
+    // Blocked producers re-check under the new policy
+    drained.notify_all();
+}
+
+BackpressurePolicy TickConflator::currentPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return policy;
+}
+
+void TickConflator::push(int symbolId, const TickRecord& trade) {
+    if (symbolId < 0) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (slotFor(symbolId).count == capacity && policy == BackpressurePolicy::Block) {
+        ++symbolSlots[symbolId].counters.blocked;
+        ++totals.blocked;
+        drained.wait(lock, [this, symbolId]() {
+            return symbolSlots[symbolId].count < capacity || policy != BackpressurePolicy::Block;
+        });
+    }
+
+    // Looked up after any wait; other symbols may have grown the slot vector meanwhile
+    Slot& slot = symbolSlots[symbolId];
+
+    ++slot.counters.pushed;
+    ++totals.pushed;
+
+    // Latest value and delta are exact regardless of what the queue keeps
+    slot.latest = trade;
+    slot.hasLatest = true;
+    TickDelta& delta = slot.delta;
+    if (delta.trades == 0) {
+        delta.high = trade.price;
+        delta.low = trade.price;
+        delta.firstTimestamp = trade.timestamp;
+    }
+    else {
+        delta.high = std::max(delta.high, trade.price);
+        delta.low = std::min(delta.low, trade.price);
+    }
+    ++delta.trades;
+    delta.volume += trade.volume;
+    delta.lastTimestamp = trade.timestamp;
+
+    if (slot.count < capacity) {
+        slot.ring[(slot.head + slot.count) % capacity] = trade;
+        ++slot.count;
+        return;
+    }
+
+    if (policy == BackpressurePolicy::DropOldest) {
+        slot.ring[slot.head] = trade;
+        slot.head = (slot.head + 1) % capacity;
+        ++slot.counters.dropped;
+        ++totals.dropped;
+    }
+    else {
+        // Conflate: the newest point takes the new price and time and absorbs the volume
+        TickRecord& newest = slot.ring[(slot.head + slot.count - 1) % capacity];
+        double volume = newest.volume + trade.volume;
+        newest = trade;
+        newest.volume = volume;
+        ++slot.counters.conflated;
+        ++totals.conflated;
+    }
+}
+
+bool TickConflator::drain(int symbolId, std::vector<TickRecord>& out, TickDelta& delta) {
+    out.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (symbolId < 0 || static_cast<size_t>(symbolId) >= symbolSlots.size())
+            return false;
+
+        Slot& slot = symbolSlots[symbolId];
+        if (slot.delta.trades == 0)
+            return false;
+
+        out.reserve(slot.count);
+        for (size_t i = 0; i < slot.count; ++i) {
+            out.push_back(slot.ring[(slot.head + i) % capacity]);
+        }
+        slot.head = 0;
+        slot.count = 0;
+        delta = slot.delta;
+        slot.delta = TickDelta();
+    }
+    drained.notify_all();
+    return true;
+}
+
+bool TickConflator::latest(int symbolId, TickRecord& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (symbolId < 0 || static_cast<size_t>(symbolId) >= symbolSlots.size() || !symbolSlots[symbolId].hasLatest)
+        return false;
+    out = symbolSlots[symbolId].latest;
+    return true;
+}
+
+void TickConflator::reset(int symbolId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (symbolId < 0 || static_cast<size_t>(symbolId) >= symbolSlots.size())
+            return;
+        Slot& slot = symbolSlots[symbolId];
+        slot.head = 0;
+        slot.count = 0;
+        slot.delta = TickDelta();
+    }
+    drained.notify_all();
+}
+
+void TickConflator::clear() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Slot& slot : symbolSlots) {
+            slot.head = 0;
+            slot.count = 0;
+            slot.hasLatest = false;
+            slot.delta = TickDelta();
+        }
+    }
+    drained.notify_all();
+}
+
+TickConflator::Counters TickConflator::counters(int symbolId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (symbolId < 0 || static_cast<size_t>(symbolId) >= symbolSlots.size())
+        return Counters();
+    return symbolSlots[symbolId].counters;
+}
+
+TickConflator::Counters TickConflator::totalCounters() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totals;
+}
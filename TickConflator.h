@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "MarketTick.h"
+
+// What push() does when a symbol's pending queue is full
+enum class BackpressurePolicy {
+    Block,        // wait until the consumer drains (producer must be on another thread)
+    DropOldest,   // discard the oldest pending trade
+    Conflate      // fold the new trade into the newest pending one
+};
+
+// Coalesced summary of everything pushed for a symbol since the last drain
+struct TickDelta {
+    quint64 trades = 0;
+    double volume = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    qint64 firstTimestamp = 0;
+    qint64 lastTimestamp = 0;
+};
+
+// Latest-value cache and bounded per-symbol queue between ingestion and the UI.
+//
+// Ingestion pushes every trade; the UI drains once per frame and gets the
+// pending trades (at most `capacity`), the coalesced delta and the latest
+// trade. The delta and the latest value are always exact; only the queue of
+// individual points is subject to the backpressure policy, so a slow frame
+// costs chart resolution instead of a growing backlog of stale updates.
+class TickConflator {
+public:
+    struct Counters {
+        quint64 pushed = 0;
+        quint64 dropped = 0;
+        quint64 conflated = 0;
+        quint64 blocked = 0;   // pushes that had to wait
+    };
+
+private:
+    struct Slot {
+        std::vector<TickRecord> ring;
+        size_t head = 0;
+        size_t count = 0;
+        TickRecord latest;
+        bool hasLatest = false;
+        TickDelta delta;
+        Counters counters;
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable drained;
+    std::vector<Slot> symbolSlots; // indexed by symbol id
+    size_t capacity;
+    BackpressurePolicy policy;
+    Counters totals;
+
+    Slot& slotFor(int symbolId);
+
+public:
+    explicit TickConflator(size_t capacityPerSymbol = 256,
+        BackpressurePolicy policy = BackpressurePolicy::Conflate);
+
+    void setPolicy(BackpressurePolicy newPolicy);
+    BackpressurePolicy currentPolicy() const;
+
+    void push(int symbolId, const TickRecord& trade);
+
+    // Moves the pending trades (oldest first) into `out` and the delta into
+    // `delta`, then resets both. Returns false if nothing arrived since the last drain.
+    bool drain(int symbolId, std::vector<TickRecord>& out, TickDelta& delta);
+
+    // Most recent trade, whatever the policy dropped; false if none yet
+    bool latest(int symbolId, TickRecord& out) const;
+
+    // Drops pending state for one symbol (e.g. when the UI switches to it)
+    void reset(int symbolId);
+    void clear();
+
+    Counters counters(int symbolId) const;
+    Counters totalCounters() const;
+};
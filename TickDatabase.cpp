@@ -0,0 +1,662 @@
+#include "TickDatabase.h"
+#include "OrderBook.h"
+#include "WorkStealingPool.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+namespace {
+    const char FileMagic[4] = { 'L', 'T', 'D', '1' };
+    constexpr quint32 BlockMagic = 0x3142544C;   // "LTB1"
+    constexpr int BlockHeaderSize = 32;
+
+    struct BlockHeader {
+        quint32 magic;
+        quint32 count;
+        qint64 minTimestamp;
+        qint64 maxTimestamp;
+        quint32 payloadBytes;
+        quint32 crc;
+    };
+    static_assert(sizeof(BlockHeader) == BlockHeaderSize, "block header must be packed");
+
+    // MSB-first bit packing; n <= 64
+    class BitWriter {
+    private:
+        QByteArray& out;
+        quint64 acc = 0;
+        int bits = 0;
+
+    public:
+        explicit BitWriter(QByteArray& out) : out(out) {}
+
+        void write(quint64 value, int n) {
+            if (n > 32) {
+                write(value >> 32, n - 32);
+                value &= 0xffffffffull;
+                n = 32;
+            }
+            acc = (acc << n) | (value & ((1ull << n) - 1));
+            bits += n;
+            while (bits >= 8) {
+                bits -= 8;
+                out.append(static_cast<char>(acc >> bits));
+            }
+        }
+
+        void finish() {
+            if (bits > 0)
+                out.append(static_cast<char>(acc << (8 - bits)));
+            bits = 0;
+        }
+    };
+
+    // Refills up to 7 bytes at a time; zero padding past the end flags an overrun once consumed
+    class BitReader {
+    private:
+        const uchar* p;
+        const uchar* end;
+        quint64 acc = 0;
+        int bits = 0;
+        int padding = 0;
+        bool overrun = false;
+
+        void refill() {
+            while (bits <= 56) {
+                if (p < end) {
+                    acc = (acc << 8) | *p++;
+                }
+                else {
+                    acc <<= 8;
+                    padding += 8;
+                }
+                bits += 8;
+            }
+        }
+
+    public:
+        BitReader(const uchar* data, size_t bytes) : p(data), end(data + bytes) {}
+
+        quint64 read(int n) {
+            if (n > 32) {
+                quint64 high = read(n - 32);
+                return (high << 32) | read(32);
+            }
+            if (bits < n)
+                refill();
+            bits -= n;
+            if (bits < padding)
+                overrun = true;
+            return (acc >> bits) & ((1ull << n) - 1);
+        }
+
+        void fail() { overrun = true; }
+        bool failed() const { return overrun; }
+    };
+
+    // Gorilla XOR compression of one double column
+    struct XorState {
+        quint64 previous = 0;
+        int leading = -1;
+        int trailing = 0;
+    };
+
+    void writeDouble(BitWriter& writer, XorState& state, double value) {
+        quint64 bits = std::bit_cast<quint64>(value);
+        quint64 x = bits ^ state.previous;
+        state.previous = bits;
+        if (x == 0) {
+            writer.write(0, 1);
+            return;
+        }
+
+        int leading = std::min(std::countl_zero(x), 31);
+        int trailing = std::countr_zero(x);
+        if (state.leading >= 0 && leading >= state.leading && trailing >= state.trailing) {
+            // Fits the previous meaningful-bit window
+            writer.write(0b10, 2);
+            writer.write(x >> state.trailing, 64 - state.leading - state.trailing);
+        }
+        else {
+            int length = 64 - leading - trailing;
+            writer.write(0b11, 2);
+            writer.write(static_cast<quint64>(leading), 5);
+            writer.write(static_cast<quint64>(length - 1), 6);
+            writer.write(x >> trailing, length);
+            state.leading = leading;
+            state.trailing = trailing;
+        }
+    }
+
+    double readDouble(BitReader& reader, XorState& state) {
+        if (reader.read(1) != 0) {
+            quint64 x;
+            if (reader.read(1) == 0) {
+                if (state.leading < 0) {
+                    reader.fail();
+                    return 0.0;
+                }
+                x = reader.read(64 - state.leading - state.trailing) << state.trailing;
+            }
+            else {
+                int leading = static_cast<int>(reader.read(5));
+                int length = static_cast<int>(reader.read(6)) + 1;
+                if (leading + length > 64) {
+                    reader.fail();
+                    return 0.0;
+                }
+                int trailing = 64 - leading - length;
+                x = reader.read(length) << trailing;
+                state.leading = leading;
+                state.trailing = trailing;
+            }
+            state.previous ^= x;
+        }
+        return std::bit_cast<double>(state.previous);
+    }
+
+    // Delta-of-delta buckets: 0 | 10+7 | 110+9 | 1110+12 | 1111+64 bits
+    void writeTimestampDelta(BitWriter& writer, qint64 dod) {
+        if (dod == 0) {
+            writer.write(0, 1);
+        }
+        else if (dod >= -63 && dod <= 64) {
+            writer.write(0b10, 2);
+            writer.write(static_cast<quint64>(dod + 63), 7);
+        }
+        else if (dod >= -255 && dod <= 256) {
+            writer.write(0b110, 3);
+            writer.write(static_cast<quint64>(dod + 255), 9);
+        }
+        else if (dod >= -2047 && dod <= 2048) {
+            writer.write(0b1110, 4);
+            writer.write(static_cast<quint64>(dod + 2047), 12);
+        }
+        else {
+            writer.write(0b1111, 4);
+            writer.write(static_cast<quint64>(dod), 64);
+        }
+    }
+
+    qint64 readTimestampDelta(BitReader& reader) {
+        if (reader.read(1) == 0) return 0;
+        if (reader.read(1) == 0) return static_cast<qint64>(reader.read(7)) - 63;
+        if (reader.read(1) == 0) return static_cast<qint64>(reader.read(9)) - 255;
+        if (reader.read(1) == 0) return static_cast<qint64>(reader.read(12)) - 2047;
+        return static_cast<qint64>(reader.read(64));
+    }
+
+    quint64 sideCode(char side) {
+        return side == 'b' ? 1 : (side == 's' ? 2 : 0);
+    }
+
+    char sideFromCode(quint64 code) {
+        return code == 1 ? 'b' : (code == 2 ? 's' : 0);
+    }
+
+    bool readHeader(const uchar* data, qint64 available, BlockHeader& header) {
+        if (available < BlockHeaderSize) return false;
+        std::memcpy(&header, data, BlockHeaderSize);
+        return header.magic == BlockMagic
+            && header.count > 0 && header.count <= static_cast<quint32>(TickDatabase::BlockTicks)
+            && header.payloadBytes <= available - BlockHeaderSize;
+    }
+
+    bool decodeStored(const uchar* base, const TickDatabase::BlockInfo& block, TickRecord* out) {
+        const uchar* payload = base + block.offset + BlockHeaderSize;
+        BlockHeader header;
+        std::memcpy(&header, base + block.offset, BlockHeaderSize);
+        if (OrderBook::crc32(reinterpret_cast<const char*>(payload), block.payloadBytes) != header.crc)
+            return false;
+        return TickDatabase::decodeBlock(payload, block.payloadBytes, block.count, out);
+    }
+
+    bool inRange(qint64 timestamp, qint64 fromMs, qint64 toMs) {
+        return timestamp >= fromMs && (toMs <= 0 || timestamp < toMs);
+    }
+}
+
+void TickDatabase::encodeBlock(const TickRecord* ticks, size_t count, QByteArray& out) {
+    out.clear();
+    if (count == 0) return;
+    out.reserve(static_cast<qsizetype>(count) * 16);
+
+    BitWriter writer(out);
+    XorState price, volume, bid, ask;
+    qint64 previousTimestamp = ticks[0].timestamp;
+    qint64 previousDelta = 0;
+    writer.write(static_cast<quint64>(previousTimestamp), 64);
+
+    for (size_t i = 0; i < count; ++i) {
+        const TickRecord& tick = ticks[i];
+        if (i > 0) {
+            qint64 delta = tick.timestamp - previousTimestamp;
+            writeTimestampDelta(writer, delta - previousDelta);
+            previousTimestamp = tick.timestamp;
+            previousDelta = delta;
+        }
+        writeDouble(writer, price, tick.price);
+        writeDouble(writer, volume, tick.volume);
+        writeDouble(writer, bid, tick.bid);
+        writeDouble(writer, ask, tick.ask);
+        writer.write(sideCode(tick.side), 2);
+    }
+    writer.finish();
+}
+
+bool TickDatabase::decodeBlock(const uchar* data, size_t bytes, size_t count, TickRecord* out) {
+    if (count == 0) return true;
+
+    BitReader reader(data, bytes);
+    XorState price, volume, bid, ask;
+    qint64 timestamp = static_cast<qint64>(reader.read(64));
+    qint64 delta = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            delta += readTimestampDelta(reader);
+            timestamp += delta;
+        }
+        TickRecord& tick = out[i];
+        tick.timestamp = timestamp;
+        tick.price = readDouble(reader, price);
+        tick.volume = readDouble(reader, volume);
+        tick.bid = readDouble(reader, bid);
+        tick.ask = readDouble(reader, ask);
+        tick.side = sideFromCode(reader.read(2));
+    }
+    return !reader.failed();
+}
+
+TickDatabase::TickDatabase(const QString& directory, bool readOnly)
+    : directory(directory),
+    readOnly(readOnly) {
+}
+
+TickDatabase::~TickDatabase() {
+    close();
+}
+
+QString TickDatabase::pathFor(const QString& symbol) const {
+    // The symbol itself lives in the file header; the name only has to be unique and safe
+    QString name;
+    for (QChar c : symbol) {
+        name.append(c.isLetterOrNumber() || c == '-' || c == '.' ? c : QChar('_'));
+    }
+    return QDir(directory).filePath(name + ".ltdb");
+}
+
+bool TickDatabase::open(QString* error) {
+    close();
+
+    QDir dir(directory);
+    if (!dir.exists() && (readOnly || !dir.mkpath("."))) {
+        if (error) *error = QString("Tick database directory not available: %1").arg(directory);
+        return false;
+    }
+
+    for (const QString& name : dir.entryList({ "*.ltdb" }, QDir::Files, QDir::Name)) {
+        auto symbolFile = std::make_unique<SymbolFile>();
+        symbolFile->file.setFileName(dir.filePath(name));
+        symbolFile->writable = !readOnly;
+        if (!loadIndex(*symbolFile)) {
+            qWarning() << "Skipping unreadable tick database file" << symbolFile->file.fileName();
+            continue;
+        }
+        fileIds.insert(symbolFile->symbol, static_cast<int>(files.size()));
+        files.push_back(std::move(symbolFile));
+    }
+    return true;
+}
+
+void TickDatabase::close() {
+    flush();
+    files.clear();
+    fileIds.clear();
+}
+
+bool TickDatabase::loadIndex(SymbolFile& symbolFile) {
+    QFile& file = symbolFile.file;
+    if (!file.open(symbolFile.writable ? QIODevice::ReadWrite : QIODevice::ReadOnly))
+        return false;
+
+    qint64 size = file.size();
+    if (size < static_cast<qint64>(sizeof(FileMagic)) + 2)
+        return false;
+    const uchar* data = file.map(0, size);
+    if (!data || std::memcmp(data, FileMagic, sizeof(FileMagic)) != 0)
+        return false;
+
+    quint16 nameLength;
+    std::memcpy(&nameLength, data + sizeof(FileMagic), sizeof(nameLength));
+    qint64 offset = sizeof(FileMagic) + sizeof(nameLength) + nameLength;
+    if (offset > size)
+        return false;
+    symbolFile.symbol = QString::fromUtf8(reinterpret_cast<const char*>(data) + sizeof(FileMagic) + sizeof(nameLength), nameLength);
+
+    // Walk the block headers only; payloads stay on disk
+    BlockHeader header;
+    while (readHeader(data + offset, size - offset, header)) {
+        BlockInfo block{ header.minTimestamp, header.maxTimestamp, offset, header.count, header.payloadBytes };
+        addIndexEntry(symbolFile, block);
+        offset += BlockHeaderSize + header.payloadBytes;
+    }
+
+    // A crash can only tear the last block: verify it, and cut whatever follows the last good one
+    if (!symbolFile.index.empty()) {
+        const BlockInfo& last = symbolFile.index.back();
+        const uchar* payload = data + last.offset + BlockHeaderSize;
+        std::memcpy(&header, data + last.offset, BlockHeaderSize);
+        if (OrderBook::crc32(reinterpret_cast<const char*>(payload), last.payloadBytes) != header.crc) {
+            offset = last.offset;
+            symbolFile.index.pop_back();
+            symbolFile.runningMax.pop_back();
+            symbolFile.runningMin.pop_back();
+            // Suffix minima of the remaining blocks may have included the dropped one
+            for (size_t i = symbolFile.index.size(); i-- > 0;) {
+                qint64 next = i + 1 < symbolFile.runningMin.size() ? symbolFile.runningMin[i + 1] : symbolFile.index[i].minTimestamp;
+                symbolFile.runningMin[i] = std::min(symbolFile.index[i].minTimestamp, next);
+            }
+        }
+    }
+    file.unmap(const_cast<uchar*>(data));
+
+    if (offset < size) {
+        qWarning() << "Tick database" << file.fileName() << "has" << (size - offset) << "trailing bytes after the last valid block";
+        if (symbolFile.writable && !file.resize(offset))
+            return false;
+    }
+    if (symbolFile.writable)
+        file.seek(file.size());
+    return true;
+}
+
+void TickDatabase::addIndexEntry(SymbolFile& symbolFile, const BlockInfo& block) {
+    symbolFile.index.push_back(block);
+    qint64 previousMax = symbolFile.runningMax.empty() ? block.maxTimestamp : symbolFile.runningMax.back();
+    symbolFile.runningMax.push_back(std::max(previousMax, block.maxTimestamp));
+
+    // In-order data stops after one comparison
+    symbolFile.runningMin.push_back(block.minTimestamp);
+    for (size_t i = symbolFile.runningMin.size() - 1; i-- > 0;) {
+        if (symbolFile.runningMin[i] <= block.minTimestamp) break;
+        symbolFile.runningMin[i] = block.minTimestamp;
+    }
+}
+
+TickDatabase::SymbolFile* TickDatabase::symbolFile(const QString& symbol, bool create) {
+    auto it = fileIds.constFind(symbol);
+    if (it != fileIds.constEnd())
+        return files[it.value()].get();
+    if (!create || readOnly)
+        return nullptr;
+
+    auto symbolFile = std::make_unique<SymbolFile>();
+    symbolFile->symbol = symbol;
+    symbolFile->writable = true;
+    symbolFile->file.setFileName(pathFor(symbol));
+    if (!symbolFile->file.open(QIODevice::ReadWrite | QIODevice::NewOnly)) {
+        qWarning() << "Cannot create tick database file:" << symbolFile->file.fileName() << symbolFile->file.errorString();
+        return nullptr;
+    }
+
+    QByteArray name = symbol.toUtf8();
+    quint16 nameLength = static_cast<quint16>(name.size());
+    symbolFile->file.write(FileMagic, sizeof(FileMagic));
+    symbolFile->file.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    symbolFile->file.write(name);
+    symbolFile->pending.reserve(BlockTicks);
+
+    fileIds.insert(symbol, static_cast<int>(files.size()));
+    files.push_back(std::move(symbolFile));
+    return files.back().get();
+}
+
+void TickDatabase::append(const QString& symbol, const TickRecord& tick) {
+    SymbolFile* file = symbolFile(symbol, true);
+    if (!file) return;
+
+    if (file->pending.empty())
+        file->pendingSinceMs = QDateTime::currentMSecsSinceEpoch();
+    file->pending.push_back(tick);
+    if (file->pending.size() >= static_cast<size_t>(BlockTicks))
+        sealBlock(*file);
+}
+
+void TickDatabase::sealBlock(SymbolFile& symbolFile) {
+    if (symbolFile.pending.empty() || !symbolFile.writable) return;
+
+    const std::vector<TickRecord>& ticks = symbolFile.pending;
+    encodeBlock(ticks.data(), ticks.size(), encodeScratch);
+
+    BlockHeader header;
+    header.magic = BlockMagic;
+    header.count = static_cast<quint32>(ticks.size());
+    header.minTimestamp = ticks.front().timestamp;
+    header.maxTimestamp = ticks.front().timestamp;
+    for (const TickRecord& tick : ticks) {
+        header.minTimestamp = std::min(header.minTimestamp, tick.timestamp);
+        header.maxTimestamp = std::max(header.maxTimestamp, tick.timestamp);
+    }
+    header.payloadBytes = static_cast<quint32>(encodeScratch.size());
+    header.crc = OrderBook::crc32(encodeScratch.constData(), encodeScratch.size());
+
+    // Header and payload in one write so a torn block is detected as a unit
+    qint64 offset = symbolFile.file.size();
+    encodeScratch.prepend(reinterpret_cast<const char*>(&header), BlockHeaderSize);
+    if (symbolFile.file.write(encodeScratch) != encodeScratch.size()) {
+        qWarning() << "Tick database write failed:" << symbolFile.file.fileName() << symbolFile.file.errorString();
+        return;
+    }
+
+    addIndexEntry(symbolFile, BlockInfo{ header.minTimestamp, header.maxTimestamp, offset, header.count, header.payloadBytes });
+    symbolFile.pending.clear();
+}
+
+void TickDatabase::flush() {
+    for (auto& symbolFile : files) {
+        sealBlock(*symbolFile);
+        if (symbolFile->writable)
+            symbolFile->file.flush();
+    }
+}
+
+void TickDatabase::flushOlderThan(qint64 maxAgeMs) {
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    for (auto& symbolFile : files) {
+        if (!symbolFile->writable || symbolFile->pending.empty() || nowMs - symbolFile->pendingSinceMs < maxAgeMs)
+            continue;
+        sealBlock(*symbolFile);
+        symbolFile->file.flush();
+    }
+}
+
+QStringList TickDatabase::symbols() const {
+    QStringList list;
+    for (const auto& symbolFile : files) {
+        list.append(symbolFile->symbol);
+    }
+    return list;
+}
+
+TickDatabase::SymbolInfo TickDatabase::info(const QString& symbol) const {
+    SymbolInfo info;
+    auto it = fileIds.constFind(symbol);
+    if (it == fileIds.constEnd()) return info;
+
+    const SymbolFile& symbolFile = *files[it.value()];
+    info.blocks = symbolFile.index.size();
+    for (const BlockInfo& block : symbolFile.index) {
+        info.ticks += block.count;
+        info.bytes += BlockHeaderSize + block.payloadBytes;
+    }
+    if (!symbolFile.index.empty()) {
+        info.firstTimestamp = symbolFile.runningMin.front();
+        info.lastTimestamp = symbolFile.runningMax.back();
+    }
+    return info;
+}
+
+void TickDatabase::blockRange(const SymbolFile& symbolFile, qint64 fromMs, qint64 toMs, size_t& first, size_t& last) {
+    // Both running arrays are sorted, whatever order the ticks arrived in
+    first = std::lower_bound(symbolFile.runningMax.begin(), symbolFile.runningMax.end(), fromMs) - symbolFile.runningMax.begin();
+    last = toMs <= 0
+        ? symbolFile.index.size()
+        : std::lower_bound(symbolFile.runningMin.begin(), symbolFile.runningMin.end(), toMs) - symbolFile.runningMin.begin();
+    last = std::max(first, last);
+}
+
+bool TickDatabase::query(const QString& symbol, qint64 fromMs, qint64 toMs, std::vector<TickRecord>& out,
+    WorkStealingPool* pool) const {
+    auto it = fileIds.constFind(symbol);
+    if (it == fileIds.constEnd()) return false;
+    const SymbolFile& symbolFile = *files[it.value()];
+
+    size_t first, last;
+    blockRange(symbolFile, fromMs, toMs, first, last);
+
+    if (first < last) {
+        QFile in(symbolFile.file.fileName());
+        if (!in.open(QIODevice::ReadOnly)) return false;
+        const BlockInfo& end = symbolFile.index[last - 1];
+        const uchar* base = in.map(0, end.offset + BlockHeaderSize + end.payloadBytes);
+        if (!base) return false;
+
+        // Decode every block into its final slot, then compact the out-of-range ticks away
+        size_t start = out.size();
+        std::vector<size_t> offsets(last - first + 1, start);
+        for (size_t b = first; b < last; ++b) {
+            offsets[b - first + 1] = offsets[b - first] + symbolFile.index[b].count;
+        }
+        out.resize(offsets.back());
+
+        std::atomic<bool> ok{ true };
+        auto decode = [&](size_t b) {
+            if (!decodeStored(base, symbolFile.index[b], out.data() + offsets[b - first]))
+                ok.store(false, std::memory_order_relaxed);
+        };
+        if (pool && last - first > 1) {
+            for (size_t b = first; b < last; ++b) {
+                pool->submit([&decode, b]() { decode(b); });
+            }
+            pool->wait();
+        }
+        else {
+            for (size_t b = first; b < last; ++b) {
+                decode(b);
+            }
+        }
+        in.unmap(const_cast<uchar*>(base));
+
+        if (!ok.load()) {
+            qWarning() << "Tick database" << symbolFile.file.fileName() << "has a corrupt block in the queried range";
+            out.resize(start);
+            return false;
+        }
+
+        auto kept = std::remove_if(out.begin() + start, out.end(),
+            [fromMs, toMs](const TickRecord& tick) { return !inRange(tick.timestamp, fromMs, toMs); });
+        out.erase(kept, out.end());
+    }
+
+    for (const TickRecord& tick : symbolFile.pending) {
+        if (inRange(tick.timestamp, fromMs, toMs))
+            out.push_back(tick);
+    }
+    return true;
+}
+
+bool TickDatabase::tail(const QString& symbol, size_t count, std::vector<TickRecord>& out) const {
+    auto it = fileIds.constFind(symbol);
+    if (it == fileIds.constEnd()) return false;
+    const SymbolFile& symbolFile = *files[it.value()];
+
+    // Walk back over whole blocks until they cover 'count' with the open block
+    size_t pending = std::min(count, symbolFile.pending.size());
+    size_t first = symbolFile.index.size();
+    size_t stored = 0;
+    while (first > 0 && stored + pending < count) {
+        --first;
+        stored += symbolFile.index[first].count;
+    }
+
+    size_t start = out.size();
+    if (first < symbolFile.index.size()) {
+        QFile in(symbolFile.file.fileName());
+        if (!in.open(QIODevice::ReadOnly)) return false;
+        const BlockInfo& end = symbolFile.index.back();
+        const uchar* base = in.map(0, end.offset + BlockHeaderSize + end.payloadBytes);
+        if (!base) return false;
+
+        out.resize(start + stored);
+        TickRecord* slot = out.data() + start;
+        bool ok = true;
+        for (size_t b = first; b < symbolFile.index.size() && ok; ++b) {
+            ok = decodeStored(base, symbolFile.index[b], slot);
+            slot += symbolFile.index[b].count;
+        }
+        in.unmap(const_cast<uchar*>(base));
+
+        if (!ok) {
+            qWarning() << "Tick database" << symbolFile.file.fileName() << "has a corrupt block in its tail";
+            out.resize(start);
+            return false;
+        }
+
+        // The first block usually overshoots
+        size_t wanted = count - pending;
+        if (stored > wanted)
+            out.erase(out.begin() + start, out.begin() + start + (stored - wanted));
+    }
+
+    out.insert(out.end(), symbolFile.pending.end() - pending, symbolFile.pending.end());
+    return true;
+}
+
+bool TickDatabase::scan(const QString& symbol, qint64 fromMs, qint64 toMs, const ChunkCallback& chunk) const {
+    auto it = fileIds.constFind(symbol);
+    if (it == fileIds.constEnd()) return false;
+    const SymbolFile& symbolFile = *files[it.value()];
+
+    size_t first, last;
+    blockRange(symbolFile, fromMs, toMs, first, last);
+
+    std::vector<TickRecord> decoded(BlockTicks);
+    std::vector<TickRecord> filtered;
+    filtered.reserve(BlockTicks);
+
+    auto deliver = [&](const TickRecord* ticks, size_t count) {
+        filtered.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (inRange(ticks[i].timestamp, fromMs, toMs))
+                filtered.push_back(ticks[i]);
+        }
+        return filtered.empty() || chunk(filtered.data(), filtered.size());
+    };
+
+    if (first < last) {
+        QFile in(symbolFile.file.fileName());
+        if (!in.open(QIODevice::ReadOnly)) return false;
+        const BlockInfo& end = symbolFile.index[last - 1];
+        const uchar* base = in.map(0, end.offset + BlockHeaderSize + end.payloadBytes);
+        if (!base) return false;
+
+        for (size_t b = first; b < last; ++b) {
+            const BlockInfo& block = symbolFile.index[b];
+            if (!decodeStored(base, block, decoded.data())) {
+                qWarning() << "Tick database" << symbolFile.file.fileName() << "has a corrupt block at offset" << block.offset;
+                return false;
+            }
+            if (!deliver(decoded.data(), block.count))
+                return true;
+        }
+    }
+
+    if (!symbolFile.pending.empty())
+        deliver(symbolFile.pending.data(), symbolFile.pending.size());
+    return true;
+}
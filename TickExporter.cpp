@@ -0,0 +1,268 @@
+#include "TickExporter.h"
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <cstring>
+
+namespace {
+    const char ColumnarMagic[4] = { 'L', 'T', 'C', '1' };
+    constexpr size_t WriteBufferSize = 1 << 20;
+    constexpr size_t MaxCsvRow = 6 * 32;   // six fields, each well under 32 characters
+
+    enum ColumnType : quint32 { ColumnI64 = 1, ColumnF64 = 2, ColumnU8 = 3 };
+
+    struct ColumnEntry {
+        char name[16];
+        quint32 type;
+        quint32 reserved;
+        quint64 offset;
+    };
+    static_assert(sizeof(ColumnEntry) == 32, "column entry must be packed");
+
+    struct Column {
+        const char* name;
+        ColumnType type;
+        size_t width;
+    };
+
+    const Column Columns[] = {
+        { "timestamp", ColumnI64, 8 },
+        { "price", ColumnF64, 8 },
+        { "volume", ColumnF64, 8 },
+        { "bid", ColumnF64, 8 },
+        { "ask", ColumnF64, 8 },
+        { "side", ColumnU8, 1 },
+    };
+    constexpr size_t ColumnCount = sizeof(Columns) / sizeof(Columns[0]);
+
+    qint64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    size_t align8(size_t value) {
+        return (value + 7) & ~size_t(7);
+    }
+
+    bool cancelled(const std::atomic<bool>* cancel) {
+        return cancel && cancel->load(std::memory_order_relaxed);
+    }
+
+    void advance(std::atomic<quint64>* written, size_t rows) {
+        if (written) written->fetch_add(rows, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    char* format(char* p, char* end, T value) {
+        return std::to_chars(p, end, value).ptr;
+    }
+
+    template <typename T>
+    void gather(const TickRecord* first, const TickRecord* last, T TickRecord::* field, char* out) {
+        for (const TickRecord* tick = first; tick != last; ++tick, out += sizeof(T)) {
+            std::memcpy(out, &(tick->*field), sizeof(T));
+        }
+    }
+
+    // Copies one field of every tick in [first, last) into 'out' as a packed array
+    void gatherColumn(size_t column, const TickRecord* first, const TickRecord* last, char* out) {
+        switch (column) {
+        case 0: gather(first, last, &TickRecord::timestamp, out); break;
+        case 1: gather(first, last, &TickRecord::price, out); break;
+        case 2: gather(first, last, &TickRecord::volume, out); break;
+        case 3: gather(first, last, &TickRecord::bid, out); break;
+        case 4: gather(first, last, &TickRecord::ask, out); break;
+        default: gather(first, last, &TickRecord::side, out); break;
+        }
+    }
+}
+
+TickExporter::~TickExporter() {
+    cancel();
+    wait();
+}
+
+TickExporter::Format TickExporter::formatFor(const QString& path) {
+    return QFileInfo(path).suffix().compare("ltc", Qt::CaseInsensitive) == 0 ? Format::Columnar : Format::Csv;
+}
+
+bool TickExporter::start(const QString& path, const QString& symbol, std::vector<TickRecord> ticks, Format format) {
+    if (isRunning())
+        return false;
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(detailsMutex);
+        target = path;
+        error.clear();
+    }
+    rowsWritten.store(0, std::memory_order_relaxed);
+    rowsTotal.store(format == Format::Columnar ? ticks.size() * ColumnCount : ticks.size(), std::memory_order_relaxed);
+    cancelRequested.store(false, std::memory_order_relaxed);
+    startedNs.store(nowNs(), std::memory_order_relaxed);
+    finishedNs.store(0, std::memory_order_relaxed);
+    state.store(State::Running, std::memory_order_release);
+
+    worker = std::thread(&TickExporter::run, this, path, symbol, std::move(ticks), format);
+    return true;
+}
+
+void TickExporter::wait() {
+    if (worker.joinable())
+        worker.join();
+}
+
+TickExporter::Progress TickExporter::progress() const {
+    Progress current;
+    current.state = state.load(std::memory_order_acquire);
+    current.rowsWritten = rowsWritten.load(std::memory_order_relaxed);
+    current.rowsTotal = rowsTotal.load(std::memory_order_relaxed);
+    qint64 started = startedNs.load(std::memory_order_relaxed);
+    qint64 finished = finishedNs.load(std::memory_order_relaxed);
+    if (started)
+        current.elapsedMs = ((finished ? finished : nowNs()) - started) / 1e6;
+    return current;
+}
+
+QString TickExporter::fileName() const {
+    std::lock_guard<std::mutex> lock(detailsMutex);
+    return target;
+}
+
+QString TickExporter::errorString() const {
+    std::lock_guard<std::mutex> lock(detailsMutex);
+    return error;
+}
+
+void TickExporter::run(QString path, QString symbol, std::vector<TickRecord> ticks, Format format) {
+    const QString partPath = path + ".part";
+    QFile out(partPath);
+    QString failure;
+    bool ok = out.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!ok) {
+        failure = out.errorString();
+    }
+    else {
+        ok = format == Format::Columnar
+            ? writeColumnar(out, symbol, ticks.data(), ticks.size(), &rowsWritten, &cancelRequested)
+            : writeCsv(out, ticks.data(), ticks.size(), &rowsWritten, &cancelRequested);
+        if (!ok && !cancelled(&cancelRequested))
+            failure = out.errorString();
+        out.close();
+    }
+
+    // Replace the target only with a complete file
+    if (ok) {
+        QFile::remove(path);
+        if (!QFile::rename(partPath, path)) {
+            ok = false;
+            failure = QString("cannot rename %1 to %2").arg(partPath, path);
+        }
+    }
+    if (!ok)
+        QFile::remove(partPath);
+
+    {
+        std::lock_guard<std::mutex> lock(detailsMutex);
+        error = failure;
+    }
+    finishedNs.store(nowNs(), std::memory_order_relaxed);
+    state.store(ok ? State::Finished : (cancelled(&cancelRequested) ? State::Cancelled : State::Failed),
+        std::memory_order_release);
+}
+
+bool TickExporter::writeCsv(QIODevice& out, const TickRecord* ticks, size_t count,
+    std::atomic<quint64>* written, const std::atomic<bool>* cancel) {
+    std::vector<char> buffer(WriteBufferSize);
+    char* const begin = buffer.data();
+    char* const end = begin + buffer.size();
+
+    static const char Header[] = "timestamp,price,volume,bid,ask,side\n";
+    std::memcpy(begin, Header, sizeof(Header) - 1);
+    char* p = begin + sizeof(Header) - 1;
+    size_t pendingRows = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const TickRecord& tick = ticks[i];
+        p = format(p, end, tick.timestamp);
+        *p++ = ',';
+        p = format(p, end, tick.price);
+        *p++ = ',';
+        p = format(p, end, tick.volume);
+        *p++ = ',';
+        p = format(p, end, tick.bid);
+        *p++ = ',';
+        p = format(p, end, tick.ask);
+        *p++ = ',';
+        if (tick.side) *p++ = tick.side;
+        *p++ = '\n';
+        ++pendingRows;
+
+        if (end - p < static_cast<qint64>(MaxCsvRow)) {
+            if (out.write(begin, p - begin) != p - begin)
+                return false;
+            p = begin;
+            advance(written, pendingRows);
+            pendingRows = 0;
+            if (cancelled(cancel))
+                return false;
+        }
+    }
+
+    if (p > begin && out.write(begin, p - begin) != p - begin)
+        return false;
+    advance(written, pendingRows);
+    return true;
+}
+
+bool TickExporter::writeColumnar(QIODevice& out, const QString& symbol, const TickRecord* ticks, size_t count,
+    std::atomic<quint64>* written, const std::atomic<bool>* cancel) {
+    QByteArray name = symbol.toUtf8();
+    const quint32 columnCount = ColumnCount;
+    const quint64 rowCount = count;
+    const quint16 nameLength = static_cast<quint16>(std::min<qsizetype>(name.size(), 0xffff));
+
+    QByteArray header;
+    header.append(ColumnarMagic, sizeof(ColumnarMagic));
+    header.append(reinterpret_cast<const char*>(&columnCount), sizeof(columnCount));
+    header.append(reinterpret_cast<const char*>(&rowCount), sizeof(rowCount));
+    header.append(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    header.append(name.constData(), nameLength);
+    header.append(static_cast<qsizetype>(align8(header.size()) - header.size()), '\0');
+
+    size_t offset = header.size() + ColumnCount * sizeof(ColumnEntry);
+    for (const Column& column : Columns) {
+        ColumnEntry entry{};
+        std::strncpy(entry.name, column.name, sizeof(entry.name));
+        entry.type = column.type;
+        entry.offset = offset;
+        header.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        offset = align8(offset + column.width * count);
+    }
+    if (out.write(header) != header.size())
+        return false;
+
+    // One sequential pass per column through a bounded gather buffer
+    std::vector<char> buffer(WriteBufferSize);
+    const size_t rowsPerChunk = WriteBufferSize / 8;
+    static const char Padding[8] = {};
+    for (size_t c = 0; c < ColumnCount; ++c) {
+        for (size_t first = 0; first < count; first += rowsPerChunk) {
+            size_t rows = std::min(rowsPerChunk, count - first);
+            gatherColumn(c, ticks + first, ticks + first + rows, buffer.data());
+            qint64 bytes = static_cast<qint64>(rows * Columns[c].width);
+            if (out.write(buffer.data(), bytes) != bytes)
+                return false;
+            advance(written, rows);
+            if (cancelled(cancel))
+                return false;
+        }
+        qint64 padding = static_cast<qint64>(align8(Columns[c].width * count) - Columns[c].width * count);
+        if (padding && out.write(Padding, padding) != padding)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MarketTick.h"
+
+class QIODevice;
+
+// Writes a tick snapshot to disk on its own thread so an export never stalls
+// the GUI; the window polls progress() from its frame timer.
+//
+// CSV rows are formatted with std::to_chars (shortest round-trip doubles, no
+// locale, no QString) into a 1 MiB buffer. The columnar format is for tools
+// that mmap it: one array per field, each 8-byte aligned, so a reader can
+// view the prices as a plain double[] without parsing:
+//
+//   "LTC1", u32 column count, u64 row count, u16 symbol length, UTF-8 symbol,
+//   zero padding to 8 bytes, then per column a 32-byte entry: char name[16]
+//   (NUL padded), u32 type (1 = i64, 2 = f64, 3 = u8), u32 reserved, u64 file
+//   offset. Columns follow in order: timestamp (ms), price, volume, bid, ask,
+//   side ('b', 's' or 0). Little-endian.
+//
+// Output goes to "<file>.part" and is renamed into place once complete, so a
+// cancelled or failed export never leaves a truncated file behind.
+class TickExporter {
+public:
+    enum class Format {
+        Csv,
+        Columnar
+    };
+
+    enum class State {
+        Idle,
+        Running,
+        Finished,
+        Failed,
+        Cancelled
+    };
+
+    struct Progress {
+        State state = State::Idle;
+        quint64 rowsWritten = 0;   // columnar counts each column pass separately
+        quint64 rowsTotal = 0;
+        double elapsedMs = 0.0;
+
+        double fraction() const { return rowsTotal ? double(rowsWritten) / double(rowsTotal) : 1.0; }
+    };
+
+private:
+    std::thread worker;
+    std::atomic<State> state{ State::Idle };
+    std::atomic<quint64> rowsWritten{ 0 };
+    std::atomic<quint64> rowsTotal{ 0 };
+    std::atomic<bool> cancelRequested{ false };
+    std::atomic<qint64> startedNs{ 0 };
+    std::atomic<qint64> finishedNs{ 0 };
+
+    mutable std::mutex detailsMutex;
+    QString target;
+    QString error;
+
+    void run(QString path, QString symbol, std::vector<TickRecord> ticks, Format format);
+
+public:
+    TickExporter() = default;
+    ~TickExporter();
+
+    TickExporter(const TickExporter&) = delete;
+    TickExporter& operator=(const TickExporter&) = delete;
+
+    // ".ltc" is columnar, anything else CSV
+    static Format formatFor(const QString& path);
+
+    // Takes the snapshot by value and returns at once; false while an export is running
+    bool start(const QString& path, const QString& symbol, std::vector<TickRecord> ticks, Format format);
+    bool start(const QString& path, const QString& symbol, std::vector<TickRecord> ticks) {
+        return start(path, symbol, std::move(ticks), formatFor(path));
+    }
+
+    void cancel() { cancelRequested.store(true, std::memory_order_relaxed); }
+    // Blocks until the current export (if any) has finished
+    void wait();
+
+    bool isRunning() const { return state.load(std::memory_order_acquire) == State::Running; }
+    Progress progress() const;
+    QString fileName() const;
+    QString errorString() const;
+
+    // The writers themselves, usable synchronously. 'written' is advanced as rows
+    // are emitted and 'cancel' is checked between buffers; both may be null.
+    static bool writeCsv(QIODevice& out, const TickRecord* ticks, size_t count,
+        std::atomic<quint64>* written = nullptr, const std::atomic<bool>* cancel = nullptr);
+    static bool writeColumnar(QIODevice& out, const QString& symbol, const TickRecord* ticks, size_t count,
+        std::atomic<quint64>* written = nullptr, const std::atomic<bool>* cancel = nullptr);
+};
@@ -0,0 +1,362 @@
+#include "TickJournal.h"
+#include "WorkStealingPool.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char JournalMagic[4] = { 'L', 'T', 'J', '1' };
+    constexpr int TickPayloadSize = 2 + 8 + 8 * 4 + 1;
+
+    template <typename T>
+    void put(QByteArray& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T get(const uchar*& p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    // Offset just past the last complete record, stopping at the first torn
+    // or unrecognised one. 'data' starts with the magic.
+    qint64 completeLength(const uchar* data, qint64 size) {
+        const uchar* p = data + sizeof(JournalMagic);
+        const uchar* end = data + size;
+        const uchar* complete = p;
+        while (p < end) {
+            char type = static_cast<char>(*p++);
+            if (type == 'S') {
+                if (end - p < 4) break;
+                p += 2;
+                quint16 length = get<quint16>(p);
+                if (end - p < length) break;
+                p += length;
+            }
+            else if (type == 'T') {
+                if (end - p < TickPayloadSize) break;
+                p += TickPayloadSize;
+            }
+            else {
+                break;
+            }
+            complete = p;
+        }
+        return complete - data;
+    }
+
+    // Ids currently declared as one of the wanted symbols; a later run appending
+    // to the file may declare an id again for another symbol
+    struct WantedIds {
+        const std::vector<QByteArray>* names;
+        std::vector<quint16> ids;
+
+        bool contains(quint16 id) const { return std::find(ids.begin(), ids.end(), id) != ids.end(); }
+
+        void declare(quint16 id, const uchar* name, quint16 length) {
+            bool wanted = std::any_of(names->begin(), names->end(), [&](const QByteArray& candidate) {
+                return candidate.size() == length && std::memcmp(candidate.constData(), name, length) == 0;
+            });
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (wanted && it == ids.end())
+                ids.push_back(id);
+            else if (!wanted && it != ids.end())
+                ids.erase(it);
+        }
+    };
+
+    struct Chunk {
+        const uchar* begin;
+        const uchar* end;
+        WantedIds wanted;      // as of 'begin'
+        size_t matches = 0;    // wanted ticks in the chunk
+        size_t skip = 0;       // of those, older than the requested tail
+        TickRecord* out = nullptr;
+    };
+
+    // Decodes the chunk's wanted ticks after the first 'skip' into 'out'.
+    // The records were validated by the scan that cut the chunk.
+    void decodeChunk(Chunk chunk) {
+        const uchar* p = chunk.begin;
+        size_t skip = chunk.skip;
+        TickRecord* out = chunk.out;
+        while (p < chunk.end) {
+            char type = static_cast<char>(*p++);
+            quint16 id = get<quint16>(p);
+            if (type == 'S') {
+                quint16 length = get<quint16>(p);
+                chunk.wanted.declare(id, p, length);
+                p += length;
+                continue;
+            }
+            if (!chunk.wanted.contains(id)) {
+                p += TickPayloadSize - 2;
+                continue;
+            }
+            if (skip > 0) {
+                --skip;
+                p += TickPayloadSize - 2;
+                continue;
+            }
+            out->timestamp = get<qint64>(p);
+            out->price = get<double>(p);
+            out->volume = get<double>(p);
+            out->bid = get<double>(p);
+            out->ask = get<double>(p);
+            out->side = static_cast<char>(get<quint8>(p));
+            ++out;
+        }
+    }
+}
+
+TickJournal::TickJournal()
+    : written(0) {
+}
+
+TickJournal::~TickJournal() {
+    close();
+}
+
+bool TickJournal::open(const QString& path) {
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open tick journal:" << path << file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        file.write(JournalMagic, sizeof(JournalMagic));
+    }
+    else {
+        // Never append to something that is not a journal
+        const uchar* data = size >= static_cast<qint64>(sizeof(JournalMagic)) ? file.map(0, size) : nullptr;
+        if (!data || std::memcmp(data, JournalMagic, sizeof(JournalMagic)) != 0) {
+            qWarning() << "Not a tick journal, refusing to append:" << path;
+            if (data) file.unmap(const_cast<uchar*>(data));
+            file.close();
+            return false;
+        }
+
+        // A crash can leave a torn record at the end; cut it off so the records
+        // appended now are not swallowed by it on replay
+        const qint64 complete = completeLength(data, size);
+        file.unmap(const_cast<uchar*>(data));
+        if (complete < size) {
+            qWarning() << "Tick journal" << path << "ends in" << size - complete << "bytes of a torn record, truncating";
+            if (!file.resize(complete)) {
+                qWarning() << "Cannot truncate tick journal:" << path << file.errorString();
+                file.close();
+                return false;
+            }
+        }
+    }
+    file.seek(file.size());
+
+    symbolIds.clear();
+    pending.reserve(FlushThreshold * 2);
+    written = 0;
+    return true;
+}
+
+void TickJournal::close() {
+    if (!file.isOpen()) return;
+    flush();
+    file.close();
+}
+
+void TickJournal::append(const QString& symbol, const TickRecord& tick) {
+    if (!file.isOpen()) return;
+
+    auto it = symbolIds.constFind(symbol);
+    quint16 id;
+    if (it == symbolIds.constEnd()) {
+        id = static_cast<quint16>(symbolIds.size());
+        symbolIds.insert(symbol, id);
+
+        QByteArray name = symbol.toUtf8();
+        pending.append('S');
+        put<quint16>(pending, id);
+        put<quint16>(pending, static_cast<quint16>(name.size()));
+        pending.append(name);
+        written += 5 + name.size();
+    }
+    else {
+        id = it.value();
+    }
+
+    pending.append('T');
+    put<quint16>(pending, id);
+    put<qint64>(pending, tick.timestamp);
+    put<double>(pending, tick.price);
+    put<double>(pending, tick.volume);
+    put<double>(pending, tick.bid);
+    put<double>(pending, tick.ask);
+    put<quint8>(pending, static_cast<quint8>(tick.side));
+    written += 1 + TickPayloadSize;
+
+    if (pending.size() >= FlushThreshold)
+        flush();
+}
+
+void TickJournal::flush() {
+    if (!file.isOpen() || pending.isEmpty()) return;
+    file.write(pending);
+    file.flush();
+    pending.clear();
+}
+
+bool TickJournal::replay(const QString& path, const TickCallback& callback, qint64 fromMs) {
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+    if (in.size() < static_cast<qint64>(sizeof(JournalMagic)))
+        return false;
+
+    const uchar* data = in.map(0, in.size());
+    if (!data)
+        return false;
+
+    const uchar* p = data;
+    const uchar* end = data + in.size();
+    if (std::memcmp(p, JournalMagic, sizeof(JournalMagic)) != 0)
+        return false;
+    p += sizeof(JournalMagic);
+
+    QHash<quint16, QString> names;
+
+    while (p < end) {
+        char type = static_cast<char>(*p++);
+        if (type == 'S') {
+            if (end - p < 4) break;
+            quint16 id = get<quint16>(p);
+            quint16 length = get<quint16>(p);
+            if (end - p < length) break;
+            names.insert(id, QString::fromUtf8(reinterpret_cast<const char*>(p), length));
+            p += length;
+        }
+        else if (type == 'T') {
+            if (end - p < TickPayloadSize) break;
+            quint16 id = get<quint16>(p);
+            TickRecord tick;
+            tick.timestamp = get<qint64>(p);
+            tick.price = get<double>(p);
+            tick.volume = get<double>(p);
+            tick.bid = get<double>(p);
+            tick.ask = get<double>(p);
+            tick.side = static_cast<char>(get<quint8>(p));
+
+            if (tick.timestamp >= fromMs)
+                callback(names.value(id), tick);
+        }
+        else {
+            qWarning() << "Tick journal" << path << "has an unknown record type, stopping replay";
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool TickJournal::read(const QString& path, const QStringList& symbols, size_t maxTicks,
+    std::vector<TickRecord>& out, WorkStealingPool* pool) {
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+    if (in.size() < static_cast<qint64>(sizeof(JournalMagic)))
+        return false;
+
+    const uchar* data = in.map(0, in.size());
+    if (!data)
+        return false;
+    if (std::memcmp(data, JournalMagic, sizeof(JournalMagic)) != 0) {
+        in.unmap(const_cast<uchar*>(data));
+        return false;
+    }
+
+    std::vector<QByteArray> names;
+    for (const QString& symbol : symbols) {
+        names.push_back(symbol.toUtf8());
+    }
+
+    // Cut chunks on record boundaries, carrying the declared ids across, and
+    // count each chunk's wanted ticks so only the tail is decoded
+    std::vector<Chunk> chunks;
+    WantedIds wanted{ &names, {} };
+    const uchar* p = data + sizeof(JournalMagic);
+    const uchar* end = data + in.size();
+    Chunk chunk{ p, p, wanted };
+    while (p < end) {
+        if (p - chunk.begin >= ChunkBytes) {
+            chunk.end = p;
+            chunks.push_back(chunk);
+            chunk = Chunk{ p, p, wanted };
+        }
+
+        const uchar* record = p;
+        char type = static_cast<char>(*p++);
+        if (type == 'S') {
+            if (end - p < 4) { p = record; break; }
+            quint16 id = get<quint16>(p);
+            quint16 length = get<quint16>(p);
+            if (end - p < length) { p = record; break; }
+            wanted.declare(id, p, length);
+            p += length;
+        }
+        else if (type == 'T') {
+            if (end - p < TickPayloadSize) { p = record; break; }
+            quint16 id;
+            std::memcpy(&id, p, sizeof(id));
+            if (wanted.contains(id))
+                ++chunk.matches;
+            p += TickPayloadSize;
+        }
+        else {
+            qWarning() << "Tick journal" << path << "has an unknown record type, stopping read";
+            p = record;
+            break;
+        }
+    }
+    chunk.end = p;
+    chunks.push_back(chunk);
+
+    size_t total = 0;
+    for (const Chunk& c : chunks) total += c.matches;
+    size_t skip = maxTicks > 0 && total > maxTicks ? total - maxTicks : 0;
+
+    // Each kept chunk decodes into its own slice of 'out', so nothing is joined afterwards
+    const size_t base = out.size();
+    out.resize(base + total - skip);
+    TickRecord* next = out.data() + base;
+    std::vector<Chunk> kept;
+    for (Chunk& c : chunks) {
+        if (c.matches <= skip) {
+            skip -= c.matches;
+            continue;
+        }
+        c.skip = skip;
+        c.out = next;
+        next += c.matches - skip;
+        skip = 0;
+        kept.push_back(std::move(c));
+    }
+
+    if (!pool || pool->threadCount() < 2 || kept.size() < 2) {
+        for (const Chunk& c : kept) {
+            decodeChunk(c);
+        }
+    }
+    else {
+        for (const Chunk& c : kept) {
+            pool->submit([&c]() { decodeChunk(c); });
+        }
+        pool->wait();
+    }
+    in.unmap(const_cast<uchar*>(data));
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <vector>
+#include "MarketTick.h"
+
+class WorkStealingPool;
+
+// Append-only binary journal of parsed ticks.
+//
+// Layout: "LTJ1" header followed by records, each starting with a type byte:
+//   'S' u16 id, u16 length, UTF-8 symbol    - declares a symbol id
+//   'T' u16 id, i64 ts, f64 price, f64 volume, f64 bid, f64 ask, u8 side
+// Symbol ids are only valid from their declaration onward, so a file can be
+// appended to by several runs. A truncated trailing record is ignored on replay
+// and cut off by open() before anything is appended after it.
+class TickJournal {
+public:
+    using TickCallback = std::function<void(const QString& symbol, const TickRecord& tick)>;
+
+private:
+    QFile file;
+    QByteArray pending;
+    QHash<QString, quint16> symbolIds;
+    qint64 written;
+
+    static constexpr int FlushThreshold = 64 * 1024;
+
+public:
+    TickJournal();
+    ~TickJournal();
+
+    // Appends to 'path', creating it if needed. Fails on a file that is not a journal.
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    QString fileName() const { return file.fileName(); }
+
+    void append(const QString& symbol, const TickRecord& tick);
+    void flush();
+
+    // Bytes handed to the journal since open(), including unflushed data
+    qint64 bytesWritten() const { return written; }
+
+    // Replays every tick with timestamp >= fromMs. Returns false if the file
+    // cannot be read or is not a journal.
+    static bool replay(const QString& path, const TickCallback& callback, qint64 fromMs = 0);
+
+    // Appends the newest 'maxTicks' (0 = all) ticks of any of 'symbols' to 'out'
+    // in file order. The mapped file is cut into ChunkBytes chunks on record
+    // boundaries by one pass that only reads ids; the chunks holding the wanted
+    // ticks are then decoded straight into 'out' - on 'pool' when given - and
+    // no QString is built per record. Returns false like replay().
+    static bool read(const QString& path, const QStringList& symbols, size_t maxTicks,
+        std::vector<TickRecord>& out, WorkStealingPool* pool = nullptr);
+
+    static constexpr qint64 ChunkBytes = 1024 * 1024;
+};
@@ -0,0 +1,560 @@
+#include "TickMulticast.h"
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char PacketMagic[4] = { 'L', 'T', 'M', '1' };
+    constexpr quint8 PacketVersion = 1;
+    constexpr char TicksPacket = 'T';
+    constexpr char SymbolsPacket = 'S';
+    constexpr char HeartbeatPacket = 'H';
+
+    constexpr int HeaderSize = 20;
+    constexpr int TickSize = 44;
+    constexpr int GapRequestSize = 12;
+    constexpr int HeartbeatMs = 250;
+    constexpr int SymbolTableEvery = 4;     // heartbeats
+    constexpr int GapCheckMs = 50;
+    constexpr quint32 MaxFrameBytes = 1 << 20;
+
+    struct PacketHeader {
+        char type;
+        quint16 count;
+        quint64 sequence;
+        quint32 session;
+    };
+
+    template <typename T>
+    void put(char*& p, T value) {
+        std::memcpy(p, &value, sizeof(T));
+        p += sizeof(T);
+    }
+
+    template <typename T>
+    T get(const char*& p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    void writeHeader(char* p, char type, quint16 count, quint64 sequence, quint32 session) {
+        std::memcpy(p, PacketMagic, sizeof(PacketMagic));
+        p += sizeof(PacketMagic);
+        put<char>(p, type);
+        put<quint8>(p, PacketVersion);
+        put<quint16>(p, count);
+        put<quint64>(p, sequence);
+        put<quint32>(p, session);
+    }
+
+    bool readHeader(const char* p, qint64 size, PacketHeader& header) {
+        if (size < HeaderSize || std::memcmp(p, PacketMagic, sizeof(PacketMagic)) != 0)
+            return false;
+        p += sizeof(PacketMagic);
+        header.type = get<char>(p);
+        if (get<quint8>(p) != PacketVersion)
+            return false;
+        header.count = get<quint16>(p);
+        header.sequence = get<quint64>(p);
+        header.session = get<quint32>(p);
+        return true;
+    }
+
+    void writeTick(char* p, quint16 symbolId, const TickRecord& tick) {
+        put<quint16>(p, symbolId);
+        put<char>(p, tick.side);
+        put<quint8>(p, 0);
+        put<qint64>(p, tick.timestamp);
+        put<double>(p, tick.price);
+        put<double>(p, tick.volume);
+        put<double>(p, tick.bid);
+        put<double>(p, tick.ask);
+    }
+
+    TickRecord readTick(const char* p, quint16& symbolId) {
+        TickRecord tick;
+        symbolId = get<quint16>(p);
+        tick.side = get<char>(p);
+        get<quint8>(p);
+        tick.timestamp = get<qint64>(p);
+        tick.price = get<double>(p);
+        tick.volume = get<double>(p);
+        tick.bid = get<double>(p);
+        tick.ask = get<double>(p);
+        return tick;
+    }
+
+    void appendFrame(QByteArray& out, const QByteArray& packet) {
+        quint32 length = static_cast<quint32>(packet.size());
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.append(packet);
+    }
+}
+
+bool TickMulticast::parseEndpoint(const QString& value, QHostAddress& group, quint16& port) {
+    QString host = value.trimmed();
+    port = DefaultPort;
+    int colon = host.lastIndexOf(':');
+    if (colon >= 0) {
+        bool ok = false;
+        port = host.mid(colon + 1).toUShort(&ok);
+        if (!ok || port == 0)
+            return false;
+        host = host.left(colon);
+    }
+    if (host.isEmpty())
+        host = DefaultGroup;
+    group = QHostAddress(host);
+    return group.protocol() == QAbstractSocket::IPv4Protocol && group.isMulticast();
+}
+
+TickMulticastPublisher::TickMulticastPublisher() {
+    heartbeatTimer.setInterval(HeartbeatMs);
+    QObject::connect(&heartbeatTimer, &QTimer::timeout, &heartbeatTimer, [this]() {
+        flush();
+        sendHeartbeat();
+        if (++heartbeats % SymbolTableEvery == 0)
+            sendSymbolTable();
+    });
+}
+
+TickMulticastPublisher::~TickMulticastPublisher() {
+    close();
+}
+
+bool TickMulticastPublisher::open(const QHostAddress& multicastGroup, quint16 multicastPort, QString* error) {
+    close();
+
+    auto socket = std::make_unique<QUdpSocket>();
+    if (!socket->bind(QHostAddress::AnyIPv4, 0)) {
+        if (error) *error = QString("Cannot open multicast socket: %1").arg(socket->errorString());
+        return false;
+    }
+    socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+    socket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 1);
+
+    auto server = std::make_unique<QTcpServer>();
+    if (!server->listen(QHostAddress::AnyIPv4, multicastPort) && !server->listen(QHostAddress::AnyIPv4, 0)) {
+        if (error) *error = QString("Cannot open gap-fill server: %1").arg(server->errorString());
+        return false;
+    }
+    QObject::connect(server.get(), &QTcpServer::newConnection, server.get(), [this]() { onGapConnection(); });
+
+    udp = std::move(socket);
+    gapServer = std::move(server);
+    group = multicastGroup;
+    port = multicastPort;
+    tcpPort = gapServer->serverPort();
+    session = QRandomGenerator::global()->generate() | 1;   // never 0, which receivers use for "none yet"
+
+    history.assign(TickMulticast::HistoryTicks, StoredTick());
+    nextSequence = 1;
+    batchFirst = 1;
+    batch.resize(HeaderSize + TickMulticast::TicksPerPacket * TickSize);
+    batchCount = 0;
+
+    sendSymbolTable();
+    heartbeatTimer.start();
+    return true;
+}
+
+void TickMulticastPublisher::close() {
+    if (!udp)
+        return;
+    flush();
+    heartbeatTimer.stop();
+    gapServer.reset();
+    udp.reset();
+    history.clear();
+    history.shrink_to_fit();
+}
+
+int TickMulticastPublisher::symbolId(const QString& symbol) {
+    auto it = symbolIds.constFind(symbol);
+    if (it != symbolIds.constEnd())
+        return it.value();
+
+    quint16 id = static_cast<quint16>(symbols.size());
+    symbolIds.insert(symbol, id);
+    symbols.append(symbol);
+    // Announce at once: ticks for the new id may be on the wire before the next periodic table
+    if (udp)
+        sendSymbolTable();
+    return id;
+}
+
+void TickMulticastPublisher::publish(int symbolId, const TickRecord& tick) {
+    if (!udp || symbolId < 0)
+        return;
+
+    StoredTick& stored = history[nextSequence % TickMulticast::HistoryTicks];
+    stored.sequence = nextSequence;
+    stored.symbolId = static_cast<quint16>(symbolId);
+    stored.tick = tick;
+
+    if (batchCount == 0)
+        batchFirst = nextSequence;
+    writeTick(batch.data() + HeaderSize + batchCount * TickSize, stored.symbolId, tick);
+    ++nextSequence;
+    if (++batchCount == TickMulticast::TicksPerPacket)
+        flush();
+}
+
+void TickMulticastPublisher::flush() {
+    if (!udp || batchCount == 0)
+        return;
+
+    writeHeader(batch.data(), TicksPacket, static_cast<quint16>(batchCount), batchFirst, session);
+    const int bytes = HeaderSize + batchCount * TickSize;
+    batchCount = 0;
+
+    if (testDropRate > 0.0) {
+        // xorshift: cheap and repeatable, so a loopback test drops the same packets every run
+        dropState ^= dropState << 13;
+        dropState ^= dropState >> 7;
+        dropState ^= dropState << 17;
+        if ((dropState >> 11) * (1.0 / 9007199254740992.0) < testDropRate) {
+            ++datagramsDropped;
+            return;
+        }
+    }
+    sendDatagram(QByteArray::fromRawData(batch.constData(), bytes));
+}
+
+void TickMulticastPublisher::sendDatagram(const QByteArray& packet) {
+    if (udp->writeDatagram(packet, group, port) == packet.size())
+        ++datagramsSent;
+}
+
+QByteArray TickMulticastPublisher::symbolTablePacket() const {
+    qsizetype size = HeaderSize + 4;
+    std::vector<QByteArray> names;
+    names.reserve(symbols.size());
+    for (const QString& symbol : symbols) {
+        names.push_back(symbol.toUtf8().left(255));
+        size += 3 + names.back().size();
+    }
+
+    QByteArray packet(size, Qt::Uninitialized);
+    char* p = packet.data();
+    writeHeader(p, SymbolsPacket, 0, nextSequence, session);
+    p += HeaderSize;
+    put<quint16>(p, tcpPort);
+    put<quint16>(p, static_cast<quint16>(names.size()));
+    for (size_t id = 0; id < names.size(); ++id) {
+        put<quint16>(p, static_cast<quint16>(id));
+        put<quint8>(p, static_cast<quint8>(names[id].size()));
+        std::memcpy(p, names[id].constData(), names[id].size());
+        p += names[id].size();
+    }
+    return packet;
+}
+
+void TickMulticastPublisher::sendSymbolTable() {
+    // Symbol lists are small; one datagram carries the whole table
+    sendDatagram(symbolTablePacket());
+}
+
+void TickMulticastPublisher::sendHeartbeat() {
+    char packet[HeaderSize + 2];
+    writeHeader(packet, HeartbeatPacket, 0, nextSequence, session);
+    char* p = packet + HeaderSize;
+    put<quint16>(p, tcpPort);
+    sendDatagram(QByteArray::fromRawData(packet, sizeof(packet)));
+}
+
+void TickMulticastPublisher::onGapConnection() {
+    while (QTcpSocket* client = gapServer->nextPendingConnection()) {
+        client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        QObject::connect(client, &QTcpSocket::disconnected, client, &QObject::deleteLater);
+        QObject::connect(client, &QTcpSocket::readyRead, client, [this, client]() {
+            while (client->bytesAvailable() >= GapRequestSize) {
+                char request[GapRequestSize];
+                client->read(request, GapRequestSize);
+                const char* p = request;
+                quint64 first = get<quint64>(p);
+                quint32 count = get<quint32>(p);
+                serveGap(client, first, count);
+            }
+        });
+
+        QByteArray frame;
+        appendFrame(frame, symbolTablePacket());
+        client->write(frame);
+    }
+}
+
+void TickMulticastPublisher::serveGap(QTcpSocket* client, quint64 first, quint32 count) {
+    ++gapRequests;
+
+    // Only what is still in the history ring; the receiver times out on the rest
+    const quint64 oldest = nextSequence > TickMulticast::HistoryTicks ? nextSequence - TickMulticast::HistoryTicks : 1;
+    quint64 from = std::max(first, oldest);
+    const quint64 end = std::min(first + count, nextSequence);
+
+    QByteArray reply;
+    QByteArray packet(HeaderSize + TickMulticast::TicksPerPacket * TickSize, Qt::Uninitialized);
+    while (from < end) {
+        const int n = static_cast<int>(std::min<quint64>(end - from, TickMulticast::TicksPerPacket));
+        for (int i = 0; i < n; ++i) {
+            const StoredTick& stored = history[(from + i) % TickMulticast::HistoryTicks];
+            writeTick(packet.data() + HeaderSize + i * TickSize, stored.symbolId, stored.tick);
+        }
+        writeHeader(packet.data(), TicksPacket, static_cast<quint16>(n), from, session);
+        appendFrame(reply, QByteArray::fromRawData(packet.constData(), HeaderSize + n * TickSize));
+        from += n;
+    }
+    if (!reply.isEmpty())
+        client->write(reply);
+}
+
+TickMulticastReceiver::TickMulticastReceiver() {
+    gapTimer.setInterval(GapCheckMs);
+    QObject::connect(&gapTimer, &QTimer::timeout, &gapTimer, [this]() { checkGapTimeout(); });
+}
+
+TickMulticastReceiver::~TickMulticastReceiver() {
+    close();
+}
+
+bool TickMulticastReceiver::open(const QHostAddress& group, quint16 port, const TickCallback& callback, QString* error) {
+    close();
+
+    // Shared so several consumers on one host can join the same group
+    auto socket = std::make_unique<QUdpSocket>();
+    if (!socket->bind(QHostAddress::AnyIPv4, port, QAbstractSocket::ShareAddress | QAbstractSocket::ReuseAddressHint)) {
+        if (error) *error = QString("Cannot bind multicast port %1: %2").arg(port).arg(socket->errorString());
+        return false;
+    }
+    if (!socket->joinMulticastGroup(group)) {
+        if (error) *error = QString("Cannot join %1: %2").arg(group.toString(), socket->errorString());
+        return false;
+    }
+    socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 << 20);
+    QObject::connect(socket.get(), &QUdpSocket::readyRead, socket.get(), [this]() { readDatagrams(); });
+
+    udp = std::move(socket);
+    onTick = callback;
+    resetSession(0);
+    gapTimer.start();
+    return true;
+}
+
+void TickMulticastReceiver::close() {
+    gapTimer.stop();
+    if (gapSocket) {
+        gapSocket->abort();
+        gapSocket.release()->deleteLater();
+    }
+    udp.reset();
+}
+
+void TickMulticastReceiver::resetSession(quint32 newSession) {
+    // A new publisher numbers from 1 again: whatever was parked belongs to the old one
+    const bool firstSession = session == 0;
+    session = newSession;
+    expected = firstSession ? startSequence : 0;
+    knownEnd = 0;
+    parked.clear();
+    requestedUpTo = 0;
+    gapSinceMs = 0;
+    publisherTcpPort = 0;
+    symbols.clear();
+    tcpBuffer.clear();
+    if (gapSocket) {
+        gapSocket->abort();
+        gapSocket.release()->deleteLater();
+    }
+}
+
+void TickMulticastReceiver::readDatagrams() {
+    QHostAddress sender;
+    while (udp->hasPendingDatagrams()) {
+        const qint64 size = udp->pendingDatagramSize();
+        if (size < 0)
+            break;
+        datagram.resize(size);
+        const qint64 read = udp->readDatagram(datagram.data(), size, &sender);
+        if (read > 0)
+            handlePacket(datagram.constData(), read, &sender);
+    }
+}
+
+void TickMulticastReceiver::readGapFill() {
+    QTcpSocket* socket = gapSocket.get();
+    tcpBuffer.append(socket->readAll());
+    qsizetype offset = 0;
+    while (tcpBuffer.size() - offset >= 4) {
+        quint32 length;
+        std::memcpy(&length, tcpBuffer.constData() + offset, sizeof(length));
+        if (length > MaxFrameBytes) {
+            socket->abort();
+            tcpBuffer.clear();
+            return;
+        }
+        if (tcpBuffer.size() - offset - 4 < static_cast<qsizetype>(length))
+            break;
+        handlePacket(tcpBuffer.constData() + offset + 4, length, nullptr);
+        offset += 4 + length;
+        if (gapSocket.get() != socket)
+            return;   // a new request replaced the channel (and its buffer)
+    }
+    tcpBuffer.remove(0, offset);
+}
+
+void TickMulticastReceiver::handlePacket(const char* data, qint64 size, const QHostAddress* sender) {
+    PacketHeader header;
+    if (!readHeader(data, size, header))
+        return;
+    if (header.session != session) {
+        if (!sender)
+            return;   // late gap fill from a previous publisher
+        resetSession(header.session);
+    }
+
+    const char* p = data + HeaderSize;
+    const qint64 body = size - HeaderSize;
+    switch (header.type) {
+    case TicksPacket: {
+        if (body != static_cast<qint64>(header.count) * TickSize)
+            return;
+        knownEnd = std::max(knownEnd, header.sequence + header.count);
+        for (quint16 i = 0; i < header.count; ++i) {
+            Tick tick;
+            quint16 symbolId;
+            tick.record = readTick(p + i * TickSize, symbolId);
+            tick.symbolId = symbolId;
+            tick.sequence = header.sequence + i;
+            acceptTick(tick, sender == nullptr);
+        }
+        break;
+    }
+    case SymbolsPacket: {
+        if (body < 4)
+            return;
+        quint16 tcp = get<quint16>(p);
+        quint16 count = get<quint16>(p);
+        const char* end = data + size;
+        for (quint16 i = 0; i < count && end - p >= 3; ++i) {
+            quint16 id = get<quint16>(p);
+            quint8 length = get<quint8>(p);
+            if (end - p < length)
+                break;
+            symbols.insert(id, QString::fromUtf8(p, length));
+            p += length;
+        }
+        if (sender) {
+            publisher = *sender;
+            publisherTcpPort = tcp;
+        }
+        break;
+    }
+    case HeartbeatPacket: {
+        if (body < 2 || !sender)
+            return;
+        publisher = *sender;
+        publisherTcpPort = get<quint16>(p);
+        if (expected == 0)
+            expected = header.sequence;   // joined on a quiet stream: start with the next tick
+        knownEnd = std::max(knownEnd, header.sequence);
+        // Ticks announced but never seen: the tail of the stream was lost
+        if (expected < knownEnd)
+            requestGap(expected, knownEnd);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void TickMulticastReceiver::acceptTick(const Tick& tick, bool fromGapFill) {
+    if (expected == 0)
+        expected = tick.sequence;
+
+    if (tick.sequence < expected) {
+        ++duplicateCount;
+        return;
+    }
+    if (tick.sequence > expected) {
+        if (!parked.emplace(tick.sequence, tick).second) {
+            ++duplicateCount;
+            return;
+        }
+        requestGap(expected, tick.sequence);
+        requestedUpTo = std::max(requestedUpTo, tick.sequence + 1);   // have it; only holes get asked for
+        if (gapSinceMs == 0)
+            gapSinceMs = QDateTime::currentMSecsSinceEpoch();
+        return;
+    }
+
+    ++deliveredCount;
+    if (fromGapFill) ++filledCount;
+    ++expected;
+    if (onTick) onTick(tick);
+    deliverParked();
+    // Progress restarts the clock; the gap only times out if nothing fills it
+    gapSinceMs = expected < knownEnd ? QDateTime::currentMSecsSinceEpoch() : 0;
+}
+
+void TickMulticastReceiver::deliverParked() {
+    while (!parked.empty() && parked.begin()->first <= expected) {
+        auto it = parked.begin();
+        if (it->first == expected) {
+            ++deliveredCount;
+            ++expected;
+            if (onTick) onTick(it->second);
+        }
+        parked.erase(it);
+    }
+}
+
+void TickMulticastReceiver::requestGap(quint64 first, quint64 end) {
+    first = std::max(first, requestedUpTo);
+    if (first >= end || publisherTcpPort == 0 || publisher.isNull())
+        return;   // asked already, or no heartbeat yet to say where to ask
+
+    if (gapSocket && gapSocket->state() == QAbstractSocket::UnconnectedState)
+        gapSocket.release()->deleteLater();
+    if (!gapSocket) {
+        gapSocket = std::make_unique<QTcpSocket>();
+        tcpBuffer.clear();
+        QObject::connect(gapSocket.get(), &QTcpSocket::readyRead, gapSocket.get(), [this]() { readGapFill(); });
+        gapSocket->connectToHost(publisher, publisherTcpPort);
+        gapSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    }
+
+    // Written while still connecting is fine: the socket sends it once connected
+    char request[GapRequestSize];
+    char* p = request;
+    put<quint64>(p, first);
+    put<quint32>(p, static_cast<quint32>(std::min<quint64>(end - first, TickMulticast::HistoryTicks)));
+    gapSocket->write(request, GapRequestSize);
+    requestedUpTo = end;
+    ++gapRequestCount;
+}
+
+void TickMulticastReceiver::checkGapTimeout() {
+    if (expected == 0 || expected >= knownEnd)
+        return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (gapSinceMs == 0) {
+        gapSinceMs = now;
+        return;
+    }
+    if (now - gapSinceMs < gapTimeoutMs)
+        return;
+
+    // Not filled in time (beyond the publisher's history, or the channel is down): skip it
+    const quint64 resume = parked.empty() ? knownEnd : parked.begin()->first;
+    lostCount += resume - expected;
+    expected = resume;
+    deliverParked();
+    gapSinceMs = expected < knownEnd ? now : 0;
+}
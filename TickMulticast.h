@@ -0,0 +1,176 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "MarketTick.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QUdpSocket;
+
+// Compact binary re-distribution of normalized ticks over UDP multicast, so
+// downstream consumers on the host or LAN share one exchange connection.
+//
+// Every datagram is a 20-byte header - magic "LTM1", type, version, count,
+// u64 sequence, u32 session - and a body:
+//   'T' up to TicksPerPacket ticks with consecutive sequence numbers from the
+//       header's, 44 bytes each: u16 symbol id, side, flags, i64 timestamp,
+//       f64 price, volume, bid, ask
+//   'S' symbol table: u16 TCP port, u16 count, then (u16 id, u8 length, UTF-8)
+//   'H' heartbeat: u16 TCP port; the header sequence is the next one to be sent
+// Little-endian, as everything else the app writes.
+//
+// UDP may drop or reorder. The publisher keeps the last HistoryTicks ticks and
+// serves gap-fill over TCP on the advertised port: a request is (u64 first
+// sequence, u32 count) and the reply is the matching 'T' packets, each framed
+// by a u32 length (a symbol table frame comes first on every connection). The
+// receiver delivers strictly in sequence order: it parks ticks that arrive
+// past a gap, asks for the gap once, and only skips it - counting the ticks as
+// lost - if the fill has not arrived within the gap timeout. The heartbeat
+// exposes gaps at the tail when the stream goes quiet.
+namespace TickMulticast {
+    constexpr int TicksPerPacket = 30;       // 20 + 30 * 44 = 1340 bytes, under a 1400 byte MTU
+    constexpr quint32 HistoryTicks = 1 << 16;
+    const char* const DefaultGroup = "239.255.42.99";
+    constexpr quint16 DefaultPort = 30001;
+
+    // "group:port" or "group" (default port)
+    bool parseEndpoint(const QString& value, QHostAddress& group, quint16& port);
+}
+
+class TickMulticastPublisher {
+private:
+    struct StoredTick {
+        quint64 sequence = 0;
+        quint16 symbolId = 0;
+        TickRecord tick;
+    };
+
+    std::unique_ptr<QUdpSocket> udp;
+    std::unique_ptr<QTcpServer> gapServer;
+    QTimer heartbeatTimer;
+    QHostAddress group;
+    quint16 port = 0;
+    quint16 tcpPort = 0;
+    quint32 session = 0;
+
+    QHash<QString, quint16> symbolIds;
+    QStringList symbols;
+    std::vector<StoredTick> history;     // ring indexed by sequence % HistoryTicks
+    quint64 nextSequence = 1;
+    quint64 batchFirst = 1;
+    QByteArray batch;                    // 'T' packet being filled
+    int batchCount = 0;
+    int heartbeats = 0;
+
+    double testDropRate = 0.0;
+    quint64 dropState = 0x9E3779B97F4A7C15ull;
+    quint64 datagramsSent = 0;
+    quint64 datagramsDropped = 0;
+    quint64 gapRequests = 0;
+
+    void sendDatagram(const QByteArray& packet);
+    void sendSymbolTable();
+    void sendHeartbeat();
+    QByteArray symbolTablePacket() const;
+    void onGapConnection();
+    void serveGap(QTcpSocket* client, quint64 first, quint32 count);
+
+public:
+    TickMulticastPublisher();
+    ~TickMulticastPublisher();
+
+    // Multicast TTL 1 (this subnet) with loopback on, so consumers on this host
+    // receive too. The gap-fill server listens on TCP 'port', or on any free
+    // port if that one is taken; receivers learn it from the heartbeat.
+    bool open(const QHostAddress& group, quint16 port, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return udp != nullptr; }
+
+    int symbolId(const QString& symbol);
+
+    // Queued into the current packet; sent when it is full or on flush()
+    void publish(int symbolId, const TickRecord& tick);
+    void flush();
+
+    // Drop this fraction of outgoing tick datagrams (loopback testing of gap-fill)
+    void setTestDropRate(double rate) { testDropRate = rate; }
+
+    quint64 published() const { return nextSequence - 1; }
+    quint64 sent() const { return datagramsSent; }
+    quint64 dropped() const { return datagramsDropped; }
+    quint64 gapRequestsServed() const { return gapRequests; }
+};
+
+class TickMulticastReceiver {
+public:
+    struct Tick {
+        quint64 sequence;
+        int symbolId;
+        TickRecord record;
+    };
+    using TickCallback = std::function<void(const Tick& tick)>;
+
+private:
+    std::unique_ptr<QUdpSocket> udp;
+    std::unique_ptr<QTcpSocket> gapSocket;
+    QTimer gapTimer;
+    QHostAddress publisher;
+    quint16 publisherTcpPort = 0;
+    quint32 session = 0;
+    TickCallback onTick;
+
+    QHash<int, QString> symbols;
+    quint64 startSequence = 0;
+    quint64 expected = 0;                 // 0 = not synchronised yet
+    quint64 knownEnd = 0;                 // one past the newest sequence seen or announced
+    std::map<quint64, Tick> parked;       // arrived past a gap
+    quint64 requestedUpTo = 0;            // gap fill asked for sequences below this
+    qint64 gapSinceMs = 0;
+    int gapTimeoutMs = 500;
+
+    QByteArray datagram;
+    QByteArray tcpBuffer;
+    quint64 deliveredCount = 0;
+    quint64 lostCount = 0;
+    quint64 filledCount = 0;
+    quint64 duplicateCount = 0;
+    quint64 gapRequestCount = 0;
+
+    void readDatagrams();
+    void readGapFill();
+    void handlePacket(const char* data, qint64 size, const QHostAddress* sender);   // no sender = gap fill
+    void acceptTick(const Tick& tick, bool fromGapFill);
+    void deliverParked();
+    void requestGap(quint64 first, quint64 end);
+    void checkGapTimeout();
+    void resetSession(quint32 newSession);
+
+public:
+    TickMulticastReceiver();
+    ~TickMulticastReceiver();
+
+    bool open(const QHostAddress& group, quint16 port, const TickCallback& callback, QString* error = nullptr);
+    void close();
+
+    void setGapTimeout(int ms) { gapTimeoutMs = ms; }
+    // First sequence wanted from the first session joined (gap-filled if still
+    // in the publisher's history); 0 starts at whatever arrives first
+    void setStartSequence(quint64 sequence) { startSequence = sequence; }
+
+    QString symbolName(int symbolId) const { return symbols.value(symbolId); }
+    quint64 nextSequence() const { return expected; }
+    quint64 delivered() const { return deliveredCount; }
+    quint64 lost() const { return lostCount; }
+    quint64 filled() const { return filledCount; }           // delivered via TCP gap-fill
+    quint64 duplicates() const { return duplicateCount; }
+    quint64 gapRequests() const { return gapRequestCount; }
+};
@@ -0,0 +1,117 @@
+#include "TickStore.h"
+#include <algorithm>
+
+TickBuffer::TickBuffer(size_t capacity)
+    : records(std::max<size_t>(capacity, 1)), head(0), count(0), sequence(0), clears(0) {
+}
+
+void TickBuffer::append(const TickRecord& record) {
+    if (count < records.size()) {
+        records[(head + count) % records.size()] = record;
+        ++count;
+    }
+    else {
+        records[head] = record;
+        head = (head + 1) % records.size();
+    }
+    ++sequence;
+}
+
+void TickBuffer::clear() {
+    head = 0;
+    count = 0;
+    ++clears;
+}
+
+void TickBuffer::copyTail(size_t n, std::vector<TickRecord>& out) const {
+    n = std::min(n, count);
+    out.clear();
+    out.reserve(n);
+    for (size_t i = count - n; i < count; ++i) {
+        out.push_back(at(i));
+    }
+}
+
+size_t TickBuffer::copyTail(size_t n, TickRecord* out) const {
+    n = std::min(n, count);
+    size_t first = (head + count - n) % records.size();
+    size_t leading = std::min(n, records.size() - first);
+    std::copy_n(records.begin() + first, leading, out);
+    std::copy_n(records.begin(), n - leading, out + leading);
+    return n;
+}
+
+bool TickBuffer::copySince(quint64 fromSequence, std::vector<TickRecord>& out) const {
+    quint64 missing = sequence > fromSequence ? sequence - fromSequence : 0;
+    bool complete = missing <= count;
+    copyTail(static_cast<size_t>(std::min<quint64>(missing, count)), out);
+    return complete;
+}
+
+TickStore::TickStore(size_t capacityPerSymbol)
+    : bufferCapacity(capacityPerSymbol) {
+}
+
+int TickStore::symbolId(const QString& symbol) {
+    auto it = symbolIds.constFind(symbol);
+    if (it != symbolIds.constEnd())
+        return it.value();
+
+    int id = static_cast<int>(buffers.size());
+    buffers.emplace_back(bufferCapacity);
+    symbols.append(symbol);
+    symbolIds.insert(symbol, id);
+    return id;
+}
+
+void TickStore::clear() {
+    for (auto& buffer : buffers) {
+        buffer.clear();
+    }
+    feedGaps.clear();
+}
+
+void TickStore::beginGap(qint64 fromTimestamp) {
+    if (inGap())
+        return;
+    if (feedGaps.size() == MaxFeedGaps)
+        feedGaps.pop_front();
+    FeedGap gap;
+    gap.fromTimestamp = fromTimestamp;
+    feedGaps.push_back(gap);
+}
+
+void TickStore::endGap(qint64 toTimestamp) {
+    if (!inGap())
+        return;
+    feedGaps.back().toTimestamp = std::max(toTimestamp, feedGaps.back().fromTimestamp + 1);
+}
+
+void TickStore::addGap(qint64 fromTimestamp, qint64 toTimestamp) {
+    FeedGap gap;
+    gap.fromTimestamp = fromTimestamp;
+    gap.toTimestamp = std::max(toTimestamp, fromTimestamp + 1);
+
+    // Keep the list ordered and disjoint, which hasGap() relies on; an open gap stays last
+    auto it = feedGaps.begin();
+    while (it != feedGaps.end() && !it->isOpen() && it->toTimestamp < gap.fromTimestamp) ++it;
+    while (it != feedGaps.end() && !it->isOpen() && it->fromTimestamp <= gap.toTimestamp) {
+        gap.fromTimestamp = std::min(gap.fromTimestamp, it->fromTimestamp);
+        gap.toTimestamp = std::max(gap.toTimestamp, it->toTimestamp);
+        it = feedGaps.erase(it);
+    }
+    feedGaps.insert(it, gap);
+    if (feedGaps.size() > MaxFeedGaps)
+        feedGaps.pop_front();
+}
+
+bool TickStore::hasGap(qint64 fromTimestamp, qint64 toTimestamp) const {
+    // Newest first: callers mostly ask about recent data
+    for (auto it = feedGaps.rbegin(); it != feedGaps.rend(); ++it) {
+        if (!it->isOpen() && it->toTimestamp < fromTimestamp)
+            return false;
+        if (it->fromTimestamp <= toTimestamp)
+            return true;
+    }
+    return false;
+}
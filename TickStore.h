@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <deque>
+#include <vector>
+#include "MarketTick.h"
+
+// Fixed-capacity ring of tick records for a single symbol.
+// Once full, the oldest record is overwritten; nothing is reallocated.
+class TickBuffer {
+private:
+    std::vector<TickRecord> records;
+    size_t head;        // index of the oldest record
+    size_t count;
+    quint64 sequence;   // total records ever appended
+    quint64 clears;     // clear() calls; readers holding a sequence check this too
+
+public:
+    explicit TickBuffer(size_t capacity = 4096);
+
+    void append(const TickRecord& record);
+    void clear();
+
+    size_t size() const { return count; }
+    size_t capacity() const { return records.size(); }
+    bool empty() const { return count == 0; }
+    quint64 totalAppended() const { return sequence; }
+    // Changes on every clear(), so a reader can tell its copy is stale even
+    // when nothing (or exactly as much) has been appended since
+    quint64 epoch() const { return clears; }
+
+    // i = 0 is the oldest retained record
+    const TickRecord& at(size_t i) const { return records[(head + i) % records.size()]; }
+    const TickRecord& back() const { return at(count - 1); }
+
+    // Copy the newest 'n' records (oldest first) into 'out'
+    void copyTail(size_t n, std::vector<TickRecord>& out) const;
+    // Same into raw storage with room for min(n, size()) records, as at most two
+    // block copies; returns the number copied
+    size_t copyTail(size_t n, TickRecord* out) const;
+
+    // Copy records appended after 'fromSequence' (a previous totalAppended()).
+    // Returns false if some of them were already overwritten.
+    bool copySince(quint64 fromSequence, std::vector<TickRecord>& out) const;
+};
+
+// Per-symbol tick buffers addressed by a dense integer symbol id, plus the
+// feed outages that apply to all of them.
+class TickStore {
+public:
+    static constexpr size_t MaxFeedGaps = 1024;
+
+private:
+    std::vector<TickBuffer> buffers;
+    QStringList symbols;
+    QHash<QString, int> symbolIds;
+    size_t bufferCapacity;
+    std::deque<FeedGap> feedGaps;   // oldest first, the newest MaxFeedGaps
+
+public:
+    explicit TickStore(size_t capacityPerSymbol = 4096);
+
+    // Returns the id for 'symbol', registering it if needed
+    int symbolId(const QString& symbol);
+    int findSymbol(const QString& symbol) const { return symbolIds.value(symbol, -1); }
+    const QString& symbolName(int id) const { return symbols.at(id); }
+    const QStringList& symbolList() const { return symbols; }
+    int symbolCount() const { return static_cast<int>(buffers.size()); }
+
+    void append(int id, const TickRecord& record) { buffers[id].append(record); }
+    TickBuffer& buffer(int id) { return buffers[id]; }
+    const TickBuffer& buffer(int id) const { return buffers[id]; }
+
+    // Feed outages. beginGap() is ignored while a gap is open, endGap() unless one is.
+    void beginGap(qint64 fromTimestamp);
+    void endGap(qint64 toTimestamp);
+    // A closed outage found after the fact, merged into the time-ordered list
+    void addGap(qint64 fromTimestamp, qint64 toTimestamp);
+    bool inGap() const { return !feedGaps.empty() && feedGaps.back().isOpen(); }
+    const std::deque<FeedGap>& gaps() const { return feedGaps; }
+    // True if data between the two times may be missing
+    bool hasGap(qint64 fromTimestamp, qint64 toTimestamp) const;
+
+    void clear();
+};
@@ -0,0 +1,37 @@
+#include "TopOfBookCache.h"
+
+TopOfBook& TopOfBookCache::entry(int symbolId) {
+    if (static_cast<size_t>(symbolId) >= entries.size())
+        entries.resize(symbolId + 1);
+    return entries[symbolId];
+}
+
+const TopOfBook* TopOfBookCache::find(int symbolId) const {
+    if (symbolId < 0 || static_cast<size_t>(symbolId) >= entries.size())
+        return nullptr;
+    return &entries[symbolId];
+}
+
+void TopOfBookCache::updateQuote(int symbolId, double bid, double ask, double bidSize, double askSize, qint64 timestamp) {
+    if (symbolId < 0 || bid <= 0.0 || ask <= 0.0) return;
+
+    TopOfBook& top = entry(symbolId);
+    if (top.bid == bid && top.ask == ask && top.bidSize == bidSize && top.askSize == askSize)
+        return;
+
+    top.bid = bid;
+    top.ask = ask;
+    top.bidSize = bidSize;
+    top.askSize = askSize;
+    top.quoteTime = timestamp;
+    ++top.quoteVersion;
+}
+
+void TopOfBookCache::updateTrade(int symbolId, const TickRecord& trade) {
+    if (symbolId < 0) return;
+
+    TopOfBook& top = entry(symbolId);
+    top.lastPrice = trade.price;
+    top.lastVolume = trade.volume;
+    top.tradeTime = trade.timestamp;
+}
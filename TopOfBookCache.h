@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+#include "MarketTick.h"
+
+// Latest best bid/ask and last trade for one symbol
+struct TopOfBook {
+    double bid = 0.0;
+    double ask = 0.0;
+    double bidSize = 0.0;
+    double askSize = 0.0;
+    qint64 quoteTime = 0;      // ms since epoch when the last quote was received
+    double lastPrice = 0.0;
+    double lastVolume = 0.0;
+    qint64 tradeTime = 0;
+    quint64 quoteVersion = 0;  // bumped on every quote change
+
+    bool hasQuote() const { return bid > 0.0 && ask > 0.0; }
+};
+
+// Per-symbol top-of-book merged from the spread, ticker and book channels
+// plus trades. Writers overwrite in place; readers (e.g. a render timer)
+// compare quoteVersion to pick up only symbols that changed, which conflates
+// any number of quote updates down to one read per frame.
+class TopOfBookCache {
+private:
+    std::vector<TopOfBook> entries;   // indexed by symbol id
+
+public:
+    TopOfBook& entry(int symbolId);
+    const TopOfBook* find(int symbolId) const;
+
+    void updateQuote(int symbolId, double bid, double ask, double bidSize, double askSize, qint64 timestamp);
+    void updateTrade(int symbolId, const TickRecord& trade);
+
+    void clear() { entries.clear(); }
+};
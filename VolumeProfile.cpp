@@ -0,0 +1,135 @@
+#include "VolumeProfile.h"
+#include <algorithm>
+#include <cmath>
+
+VolumeProfile::VolumeProfile(double tickSize, qint64 sessionLengthMs, double valueAreaShare)
+    : tickSize(tickSize),
+    valueAreaShare(std::clamp(valueAreaShare, 0.0, 1.0)),
+    sessionLengthMs(std::max<qint64>(sessionLengthMs, 1)),
+    sessionStart(-1),
+    baseIndex(0),
+    totalVolume(0.0),
+    pocBucket(0),
+    valueLow(0),
+    valueHigh(0),
+    valueAreaVolume(0.0),
+    version(0) {
+}
+
+void VolumeProfile::reset() {
+    buckets.clear();
+    baseIndex = 0;
+    totalVolume = 0.0;
+    pocBucket = valueLow = valueHigh = 0;
+    valueAreaVolume = 0.0;
+    sessionStart = -1;
+    ++version;
+}
+
+int64_t VolumeProfile::priceIndex(double price) const {
+    return static_cast<int64_t>(std::floor(price / tickSize + 1e-9));
+}
+
+size_t VolumeProfile::bucketAt(double price) const {
+    if (buckets.empty()) return 0;
+    int64_t i = priceIndex(price) - baseIndex;
+    return static_cast<size_t>(std::clamp<int64_t>(i, 0, static_cast<int64_t>(buckets.size()) - 1));
+}
+
+size_t VolumeProfile::bucketFor(int64_t index) {
+    if (buckets.empty()) {
+        // Start with room on both sides of the first price
+        buckets.assign(256, 0.0);
+        baseIndex = index - 128;
+    }
+
+    int64_t offset = index - baseIndex;
+    if (offset < 0) {
+        // Grow downwards by at least doubling; shift every stored index
+        size_t grow = std::max<size_t>(static_cast<size_t>(-offset), buckets.size());
+        buckets.insert(buckets.begin(), grow, 0.0);
+        baseIndex -= static_cast<int64_t>(grow);
+        pocBucket += grow;
+        valueLow += grow;
+        valueHigh += grow;
+        offset += static_cast<int64_t>(grow);
+    }
+    else if (offset >= static_cast<int64_t>(buckets.size())) {
+        size_t needed = static_cast<size_t>(offset) + 1;
+        buckets.resize(std::max(needed, buckets.size() * 2), 0.0);
+    }
+    return static_cast<size_t>(offset);
+}
+
+void VolumeProfile::addTrade(const TickRecord& trade) {
+    addTrade(trade.price, trade.volume, trade.timestamp);
+}
+
+void VolumeProfile::addTrade(double price, double volume, qint64 timestamp) {
+    if (price <= 0.0 || volume <= 0.0) return;
+
+    qint64 session = timestamp - timestamp % sessionLengthMs;
+    if (sessionStart >= 0 && session > sessionStart)
+        reset();
+    if (sessionStart < 0)
+        sessionStart = session;
+
+    if (tickSize <= 0.0)
+        tickSize = std::pow(10.0, std::floor(std::log10(price * 1e-4)));
+
+    size_t bucket = bucketFor(priceIndex(price));
+    bool first = totalVolume <= 0.0;
+    buckets[bucket] += volume;
+    totalVolume += volume;
+    ++version;
+
+    if (first) {
+        pocBucket = valueLow = valueHigh = bucket;
+        valueAreaVolume = volume;
+        return;
+    }
+
+    if (buckets[bucket] > buckets[pocBucket])
+        pocBucket = bucket;
+
+    updateValueArea(bucket, volume);
+}
+
+void VolumeProfile::updateValueArea(size_t touched, double volume) {
+    if (touched >= valueLow && touched <= valueHigh)
+        valueAreaVolume += volume;
+
+    // The range must contain the point of control
+    while (pocBucket < valueLow) valueAreaVolume += buckets[--valueLow];
+    while (pocBucket > valueHigh) valueAreaVolume += buckets[++valueHigh];
+
+    const double target = totalVolume * valueAreaShare;
+
+    // Widen towards the heavier neighbour until the share is covered
+    while (valueAreaVolume < target) {
+        bool canLow = valueLow > 0;
+        bool canHigh = valueHigh + 1 < buckets.size();
+        if (!canLow && !canHigh) break;
+        double below = canLow ? buckets[valueLow - 1] : -1.0;
+        double above = canHigh ? buckets[valueHigh + 1] : -1.0;
+        if (above >= below)
+            valueAreaVolume += buckets[++valueHigh];
+        else
+            valueAreaVolume += buckets[--valueLow];
+    }
+
+    // Narrow from the lighter edge while the share is still covered
+    while (valueLow < valueHigh) {
+        bool lowIsPoc = valueLow == pocBucket;
+        bool highIsPoc = valueHigh == pocBucket;
+        size_t edge;
+        if (lowIsPoc) edge = valueHigh;
+        else if (highIsPoc) edge = valueLow;
+        else edge = buckets[valueLow] <= buckets[valueHigh] ? valueLow : valueHigh;
+
+        if (valueAreaVolume - buckets[edge] < target) break;
+        valueAreaVolume -= buckets[edge];
+        if (edge == valueLow) ++valueLow;
+        else --valueHigh;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cstdint>
+#include <vector>
+#include "MarketTick.h"
+
+// Volume-at-price for one symbol and one session.
+//
+// Buckets are a flat array indexed by (price / tickSize) - baseIndex, grown by
+// doubling on whichever side a trade falls outside, so adding a trade is an
+// index computation and one add. The point of control only moves when the
+// touched bucket overtakes it, and the value area is kept as a contiguous
+// bucket range around it that is widened or narrowed a step at a time as
+// volume arrives, instead of being re-derived from the whole profile.
+class VolumeProfile {
+private:
+    double tickSize;
+    double valueAreaShare;
+    qint64 sessionLengthMs;
+    qint64 sessionStart;        // -1 before the first trade
+
+    std::vector<double> buckets;
+    int64_t baseIndex;          // price index of buckets[0]
+    double totalVolume;
+
+    size_t pocBucket;
+    size_t valueLow;            // inclusive bucket range
+    size_t valueHigh;
+    double valueAreaVolume;
+    quint64 version;
+
+    int64_t priceIndex(double price) const;
+    size_t bucketFor(int64_t index);
+    void updateValueArea(size_t touched, double volume);
+
+public:
+    // tickSize <= 0 picks one from the first trade (about 1/10000 of its price)
+    explicit VolumeProfile(double tickSize = 0.0, qint64 sessionLengthMs = 24LL * 60 * 60 * 1000,
+        double valueAreaShare = 0.70);
+
+    // Starts a new session first if the trade falls past the current one
+    void addTrade(const TickRecord& trade);
+    void addTrade(double price, double volume, qint64 timestamp);
+    void reset();
+
+    bool empty() const { return totalVolume <= 0.0; }
+    double bucketSize() const { return tickSize; }
+    double total() const { return totalVolume; }
+    qint64 sessionStartTime() const { return sessionStart; }
+    quint64 changeCount() const { return version; }   // bumped on every trade
+
+    // Bucket access for rendering; prices are the bucket's lower edge
+    size_t bucketCount() const { return buckets.size(); }
+    double bucketPrice(size_t i) const { return (baseIndex + static_cast<int64_t>(i)) * tickSize; }
+    double bucketVolume(size_t i) const { return buckets[i]; }
+    size_t bucketAt(double price) const;   // clamped to the profile
+
+    double pointOfControl() const { return empty() ? 0.0 : bucketPrice(pocBucket); }
+    double pointOfControlVolume() const { return empty() ? 0.0 : buckets[pocBucket]; }
+    double valueAreaLow() const { return empty() ? 0.0 : bucketPrice(valueLow); }
+    double valueAreaHigh() const { return empty() ? 0.0 : bucketPrice(valueHigh) + tickSize; }
+    bool inValueArea(size_t bucket) const { return !empty() && bucket >= valueLow && bucket <= valueHigh; }
+};
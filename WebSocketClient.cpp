@@ -24,6 +24,10 @@ void WebSocketClient::disconnectFromServer() {
     m_webSocket.close();
 }
 
+void WebSocketClient::abort() {
+    m_webSocket.abort();
+}
+
 void WebSocketClient::sendMessage(const QString& message){
     m_webSocket.sendTextMessage(message);
 }
@@ -43,7 +47,8 @@ void WebSocketClient::onDisconnected() {
 }
 
 void WebSocketClient::onTextMessageReceived(const QString& message) {
-	qDebug() << "WebSocket message received:" << message;
+    if (m_logMessages)
+        qDebug() << "WebSocket message received:" << message;
     emit messageReceived(message);
 }
 
@@ -12,9 +12,12 @@ public:
 
     void connectToServer(const QUrl& url);
     void disconnectFromServer();
+    // Drops the connection without a close handshake (dead or stalled peer)
+    void abort();
 	QString errorString() const { return m_webSocket.errorString(); }
     void sendMessage(const QString& message);
     bool isConnected() const;
+    void setMessageLogging(bool enable) { m_logMessages = enable; }
 
 signals:
     void messageReceived(const QString& message);
@@ -30,4 +33,5 @@ private slots:
 
 private:
     QWebSocket m_webSocket;
+    bool m_logMessages = true;
 };
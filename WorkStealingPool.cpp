@@ -0,0 +1,113 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+    // Lets submit() called from inside a task find its own worker's deque
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local size_t currentIndex = 0;
+}
+
+WorkStealingPool::WorkStealingPool(size_t threadCount)
+    : queued(0),
+    unfinished(0),
+    nextWorker(0),
+    stolen(0),
+    stopping(false) {
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    size_t index = currentPool == this
+        ? currentIndex
+        : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+    // Counted before the task is visible so a fast pop never sees queued == 0
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        ++queued;
+        ++unfinished;
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [this]() { return unfinished == 0; });
+}
+
+bool WorkStealingPool::popLocal(size_t index, Task& task) {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, Task& task) {
+    // Start at the neighbour so thieves spread over different victims
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker& victim = *workers[(thief + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty())
+            continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    for (;;) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                --queued;
+            }
+            task();
+            task = nullptr;
+
+            std::lock_guard<std::mutex> lock(idleMutex);
+            if (--unfinished == 0)
+                allDone.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        workAvailable.wait(lock, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+            return;
+    }
+}
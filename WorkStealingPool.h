@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque.
+//
+// A worker pops its own newest task (LIFO keeps its caches warm) and, when
+// empty, steals the oldest task from another worker (FIFO takes the biggest
+// remaining chunk). Submissions from outside the pool are spread round-robin.
+// Tasks of very different cost — short and long replay windows, cheap and
+// expensive parameter sets — balance without a central queue every worker
+// contends on.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex idleMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t queued;                   // submitted, not yet taken (guarded by idleMutex)
+    size_t unfinished;               // submitted, not yet finished (guarded by idleMutex)
+    std::atomic<size_t> nextWorker;
+    std::atomic<quint64> stolen;
+    bool stopping;
+
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    void workerLoop(size_t index);
+
+public:
+    // 0 threads = std::thread::hardware_concurrency()
+    explicit WorkStealingPool(size_t threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Tasks submitted from a worker go to that worker's own deque
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+    size_t threadCount() const { return threads.size(); }
+    quint64 stolenCount() const { return stolen.load(std::memory_order_relaxed); }
+};
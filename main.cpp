@@ -1,11 +1,216 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstring>
+#include <iostream>
 #include "LightningTradeMainWindow.h"
+#include "HeadlessBacktest.h"
+#include "HeadlessBenchmark.h"
+#include "HeadlessBusReader.h"
+#include "HeadlessCollector.h"
+#include "HeadlessFixtureCheck.h"
+#include "HeadlessMulticastReader.h"
+#include "HeadlessWsBenchmark.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <QSocketNotifier>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Mode flags are checked before any application object exists, because the
+// mode decides which application class (and platform plugin) is created.
+static bool hasFlag(int argc, char* argv[], const char* flag) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Ctrl+C and SIGTERM end the event loop rather than the process, so the
+// collector's destructor still seals tick database blocks, flushes the journal
+// and marks the tick bus closed. A second signal kills the process as usual.
+#ifdef _WIN32
+static BOOL WINAPI consoleQuitHandler(DWORD type) {
+    if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT)
+        return FALSE;
+    // Runs on a thread of its own: only post to the application
+    QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+    SetConsoleCtrlHandler(consoleQuitHandler, FALSE);
+    return TRUE;
+}
+
+static void quitOnSignals() {
+    SetConsoleCtrlHandler(consoleQuitHandler, TRUE);
+}
+#else
+static int signalSockets[2] = { -1, -1 };
+
+static void signalQuitHandler(int) {
+    // Async-signal-safe: only wake the event loop
+    char byte = 1;
+    [[maybe_unused]] ssize_t written = ::write(signalSockets[1], &byte, 1);
+}
+
+static void quitOnSignals() {
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalSockets) != 0)
+        return;
+    auto* notifier = new QSocketNotifier(signalSockets[0], QSocketNotifier::Read, QCoreApplication::instance());
+    QObject::connect(notifier, &QSocketNotifier::activated, notifier, [notifier]() {
+        notifier->setEnabled(false);
+        char byte;
+        [[maybe_unused]] ssize_t read = ::read(signalSockets[0], &byte, 1);
+        QCoreApplication::quit();
+    });
+
+    struct sigaction action = {};
+    action.sa_handler = signalQuitHandler;
+    sigemptyset(&action.sa_mask);
+    // One-shot, so a second signal while shutting down takes the default action
+    action.sa_flags = SA_RESTART | SA_RESETHAND;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+#endif
+
+static int runBenchmark(int argc, char* argv[]) {
+    // Render on the offscreen platform unless the caller picked one
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
 
-int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
 
+    BenchmarkOptions options;
+    QString error;
+    if (!BenchmarkOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessBenchmark benchmark(options);
+    return benchmark.run();
+}
+
+static int runCollector(int argc, char* argv[]) {
+    // No widgets, charts or platform plugin: capture and statistics only
+    QCoreApplication app(argc, argv);
+
+    CollectorOptions options;
+    QString error;
+    if (!CollectorOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessCollector collector(options);
+    if (!collector.start())
+        return 1;
+
+    quitOnSignals();
+    return app.exec();
+}
+
+static int runBacktest(int argc, char* argv[]) {
+    // Replay and sweep only: no widgets or platform plugin
+    QCoreApplication app(argc, argv);
+
+    BacktestOptions options;
+    QString error;
+    if (!BacktestOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessBacktest backtest(options);
+    return backtest.run();
+}
+
+static int runBusReader(int argc, char* argv[]) {
+    // Sample shared memory consumer: no exchange connection of its own
+    QCoreApplication app(argc, argv);
+
+    BusReaderOptions options;
+    QString error;
+    if (!BusReaderOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessBusReader reader(options);
+    return reader.run();
+}
+
+static int runMulticastReader(int argc, char* argv[]) {
+    // Sample multicast consumer: no exchange connection of its own
+    QCoreApplication app(argc, argv);
+
+    MulticastReaderOptions options;
+    QString error;
+    if (!MulticastReaderOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessMulticastReader reader(options);
+    return reader.run();
+}
+
+static int runWsBenchmark(int argc, char* argv[]) {
+    // Transport only: QWebSocket needs an event loop, not a GUI
+    QCoreApplication app(argc, argv);
+
+    WsBenchmarkOptions options;
+    QString error;
+    if (!WsBenchmarkOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessWsBenchmark benchmark(options);
+    return benchmark.run();
+}
+
+static int runFixtureCheck(int argc, char* argv[]) {
+    // Parsers, routing and books only: no widgets or network
+    QCoreApplication app(argc, argv);
+
+    FixtureCheckOptions options;
+    QString error;
+    if (!FixtureCheckOptions::parse(app.arguments(), options, &error)) {
+        std::cerr << error.toStdString() << std::endl;
+        return 2;
+    }
+
+    HeadlessFixtureCheck check(options);
+    return check.run();
+}
+
+int main(int argc, char* argv[]) {
     qRegisterMetaType<MarketTick>("MarketTick");
 
+    if (hasFlag(argc, argv, "--benchmark"))
+        return runBenchmark(argc, argv);
+    if (hasFlag(argc, argv, "--collect"))
+        return runCollector(argc, argv);
+    if (hasFlag(argc, argv, "--backtest"))
+        return runBacktest(argc, argv);
+    if (hasFlag(argc, argv, "--bus-read"))
+        return runBusReader(argc, argv);
+    if (hasFlag(argc, argv, "--mcast-read"))
+        return runMulticastReader(argc, argv);
+    if (hasFlag(argc, argv, "--ws-bench"))
+        return runWsBenchmark(argc, argv);
+    if (hasFlag(argc, argv, "--check-fixtures"))
+        return runFixtureCheck(argc, argv);
+
+    QApplication app(argc, argv);
+
     LightningTradeMainWindow window;
     window.show();
 